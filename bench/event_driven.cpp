@@ -0,0 +1,63 @@
+// Throughput of the event driven engine against the fixed step, across EIRs.
+// The event driven engine should win by a wide margin at low transmission,
+// where almost nobody has anything happen on a given day.
+//
+// Usage: event_driven [N] [days]
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+#include "PlasX/Falciparum/Griffin/event_driven.hpp"
+#include "PlasX/Falciparum/Griffin/population.hpp"
+#include "PlasX/Falciparum/griffin.hpp"
+#include "PlasX/random.hpp"
+#include "PlasX/simulation.hpp"
+#include "PlasX/thread_pool.hpp"
+#include "PlasX/udl.hpp"
+
+using namespace plasx;
+namespace pfg = falciparum::griffin;
+
+static pfg::Population make_population(const long N) {
+  pfg::Population population;
+  population.reserve(N);
+  for (auto i = 0; i < N; ++i) {
+    population.emplace_back(10.0_yrs, pfg::Status::S, 0.0, 0.0, 0.0);
+  }
+  return population;
+}
+
+int main(int argc, char** argv) {
+  const long N = argc > 1 ? std::atol(argv[1]) : 1000000;
+  const double days = argc > 2 ? std::atof(argv[2]) : 365.0;
+  pfg::Parameters params;
+  params.mu_d = 1.0 / 60.0_yrs;
+
+  std::cout << "eir,engine,agent_days_per_second\n";
+  for (const auto eir : {1e-5, 1e-4, 1e-3, 1e-2}) {
+    {
+      auto population = make_population(N);
+      ThreadPool pool(1);
+      RandomStreams streams(1);
+      auto start = std::chrono::steady_clock::now();
+      plasx::simulation(0.0_days, days, 1.0_days, pfg::one_step, population,
+                        params, eir, pool, streams);
+      std::chrono::duration<double> elapsed =
+          std::chrono::steady_clock::now() - start;
+      std::cout << eir << ",fixed_step," << N * days / elapsed.count()
+                << "\n";
+    }
+    {
+      auto population = make_population(N);
+      pfg::EventDriven engine(1);
+      auto start = std::chrono::steady_clock::now();
+      plasx::simulation(0.0_days, days, 30.0_days, engine, population, params,
+                        eir);
+      std::chrono::duration<double> elapsed =
+          std::chrono::steady_clock::now() - start;
+      std::cout << eir << ",event_driven," << N * days / elapsed.count()
+                << "\n";
+    }
+  }
+  return EXIT_SUCCESS;
+}
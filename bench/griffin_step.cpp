@@ -0,0 +1,407 @@
+// Benchmark suite for the Griffin step functions. Prints one CSV row per
+// measurement to stdout:
+//
+//   benchmark,n,threads,value,unit
+//
+// Units ending in "_per_second" are better when higher, every other unit is
+// better when lower. Given a previous output with --baseline, every row that
+// is worse than the baseline by more than the tolerance (default 0.1, i.e.
+// 10%) is reported on stderr and the exit status is 1.
+//
+// Usage: griffin_step [--baseline file] [--tolerance x] [--steps s] [N...]
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <new>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include "PlasX/Falciparum/Griffin/biting.hpp"
+#include "PlasX/Falciparum/Griffin/cohorts.hpp"
+#include "PlasX/Falciparum/Griffin/equilibrium.hpp"
+#include "PlasX/Falciparum/Griffin/event_log.hpp"
+#include "PlasX/Falciparum/Griffin/interventions.hpp"
+#include "PlasX/Falciparum/Griffin/metapopulation.hpp"
+#include "PlasX/Falciparum/Griffin/population.hpp"
+#include "PlasX/Falciparum/Griffin/update.hpp"
+#include "PlasX/Falciparum/griffin.hpp"
+#include "PlasX/random.hpp"
+#include "PlasX/simulation.hpp"
+#include "PlasX/thread_pool.hpp"
+#include "PlasX/udl.hpp"
+
+using namespace plasx;
+namespace pfg = falciparum::griffin;
+
+// Every allocation made by the program is counted.
+static std::atomic<std::size_t> allocations{0};
+
+void* operator new(std::size_t size) {
+  ++allocations;
+  if (auto* p = std::malloc(size ? size : 1)) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+struct Row {
+  std::string benchmark;
+  long n;
+  std::size_t threads;
+  double value;
+  std::string unit;
+};
+
+using Key = std::tuple<std::string, long, std::size_t, std::string>;
+
+static std::vector<Row> rows;
+
+static void report(const std::string& benchmark, long n, std::size_t threads,
+                   double value, const std::string& unit) {
+  rows.push_back({benchmark, n, threads, value, unit});
+  std::cout << benchmark << "," << n << "," << threads << "," << value << ","
+            << unit << std::endl;
+}
+
+static double seconds_since(std::chrono::steady_clock::time_point start) {
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  return elapsed.count();
+}
+
+// Throughput of one_step, and the allocations it makes per step once warm.
+template <class PopulationType, class... Args>
+static void step_throughput(const std::string& name,
+                            PopulationType& population, const long steps,
+                            const std::size_t threads, Args&&... args) {
+  pfg::Parameters params;
+  const long n = population.size();
+  // One step to warm up the caches and buffers.
+  auto t = pfg::one_step(0.0, 1.0_days, population, params, 1.0, args...);
+  const auto allocated = allocations.load();
+  const auto start = std::chrono::steady_clock::now();
+  plasx::simulation(t, t + steps * 1.0_days, 1.0_days, pfg::one_step,
+                    population, params, 1.0, args...);
+  const auto elapsed = seconds_since(start);
+  report(name, n, threads, n * steps / elapsed, "agent_steps_per_second");
+  report(name, n, threads,
+         static_cast<double>(allocations - allocated) / steps,
+         "allocations_per_step");
+}
+
+// Bytes held in the columns of population per individual, not counting the
+// pool of pending infections. The state columns halve with make FLOAT=1.
+static double bytes_per_agent(const pfg::Population& population) {
+  const auto& p = population;
+  return sizeof(p.age_[0]) + sizeof(p.current_[0]) + sizeof(p.I_CA_[0]) +
+         sizeof(p.I_CM_[0]) + sizeof(p.I_A_[0]) + sizeof(p.I_B_[0]) +
+         sizeof(p.zeta_[0]) + sizeof(p.next_infection_[0]) +
+         sizeof(p.updated_[0]) + sizeof(p.overflow_[0]);
+}
+
+static pfg::Population make_population(const long n) {
+  pfg::Population population;
+  population.reserve(n);
+  for (auto i = 0; i < n; ++i) {
+    population.emplace_back(10.0, pfg::Status::S, 0.0, 0.0, 0.0);
+  }
+  return population;
+}
+
+// Throughput of the blocked step with only the Enabled features compiled in,
+// with the default parameters (no mortality, no delay).
+template <class Enabled>
+static void features_throughput(const std::string& name, const long n,
+                                const long steps) {
+  pfg::Parameters params;
+  auto population = make_population(n);
+  RandomStreams streams(1);
+  const pfg::FeatureStep<Enabled> step;
+  auto t = step(0.0, 1.0_days, population, params, 1.0, streams);
+  const auto start = std::chrono::steady_clock::now();
+  plasx::simulation(t, t + steps * 1.0_days, 1.0_days, step, population,
+                    params, 1.0, streams);
+  report(name, n, 1, n * steps / seconds_since(start),
+         "agent_steps_per_second");
+}
+
+// Throughput of the blocked step at an EIR of 0.01, where few are bitten.
+// args is either nothing, so that bites are drawn for every individual, or a
+// BitingTable that allocates them.
+template <class... Args>
+static void low_eir_throughput(const std::string& name, const long n,
+                               const long steps, Args&... args) {
+  pfg::Parameters params;
+  const auto eir = 0.01;
+  auto population = make_population(n);
+  RandomStreams streams(1);
+  auto t = pfg::one_step(0.0, 1.0_days, population, params, eir, streams,
+                         args...);
+  const auto start = std::chrono::steady_clock::now();
+  plasx::simulation(t, t + steps * 1.0_days, 1.0_days, pfg::one_step,
+                    population, params, eir, streams, args...);
+  report(name, n, 1, n * steps / seconds_since(start),
+         "agent_steps_per_second");
+}
+
+// Throughput of filling a population from the equilibrium at an EIR of 1,
+// including solving for it, with threads threads.
+static void equilibrium_throughput(const long n, const std::size_t threads) {
+  pfg::Parameters params;
+  params.mu_d = 1.0 / 20.0_yrs;
+  pfg::Population population;
+  ThreadPool pool(threads);
+  RandomStreams streams(1);
+  const auto start = std::chrono::steady_clock::now();
+  pfg::Equilibrium(params, 1.0).fill(population, n, pool, streams);
+  report("equilibrium_fill", n, threads, n / seconds_since(start),
+         "agents_per_second");
+}
+
+// Throughput of a campaign day, mass drug administration and bednets handed
+// out to half the population, on its own.
+static void campaign_throughput(const long n) {
+  auto population = make_population(n);
+  pfg::Schedule schedule;
+  schedule.add(0.0, pfg::MassDrugAdministration{0.5});
+  schedule.add(0.0, pfg::BednetCampaign{0.5, 0.5, 1.0_yrs});
+  const auto start = std::chrono::steady_clock::now();
+  schedule.apply(0.0, 1.0_days, population);
+  report("campaign_day", n, 1, n / seconds_since(start), "agents_per_second");
+}
+
+// Throughput of a metapopulation of n people spread over 16 districts in a
+// ring, each exchanging migrants with its neighbours.
+static void metapopulation_throughput(const long n, const long steps,
+                                      const std::size_t threads) {
+  constexpr std::size_t districts = 16;
+  std::vector<pfg::Patch> patches(districts);
+  std::vector<double> migration(districts * districts, 0.0);
+  for (std::size_t p = 0; p < districts; ++p) {
+    patches[p].population = make_population(n / districts);
+    patches[p].eir = 1.0;
+    migration[p * districts + (p + 1) % districts] = 0.001;
+    migration[p * districts + (p + districts - 1) % districts] = 0.001;
+  }
+  pfg::Metapopulation metapopulation(std::move(patches), std::move(migration),
+                                     1);
+  pfg::Parameters params;
+  ThreadPool pool(threads);
+  auto t = pfg::one_step(0.0, 1.0_days, metapopulation, params, pool);
+  const auto start = std::chrono::steady_clock::now();
+  plasx::simulation(t, t + steps * 1.0_days, 1.0_days, pfg::one_step,
+                    metapopulation, params, pool);
+  const auto elapsed = seconds_since(start);
+  report("metapopulation", metapopulation.size(), threads,
+         metapopulation.size() * steps / elapsed, "agent_steps_per_second");
+}
+
+// Keeps the results of the kernel loops alive.
+static volatile std::size_t sink;
+
+// Time per call of the update rules on their own.
+static void kernels() {
+  constexpr long calls = 10000000;
+  pfg::Parameters params;
+  const pfg::ImmunityFunctions functions(params);
+  Xoshiro256 rng(1);
+  auto uniform = [&rng] { return rng.uniform(); };
+
+  {
+    std::size_t events = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (long i = 0; i < calls; ++i) {
+      events += pfg::determine_event(0.5, uniform);
+    }
+    report("determine_event", calls, 1, seconds_since(start) * 1e9 / calls,
+           "ns_per_call");
+    sink = events;
+  }
+  {
+    // Half of the calls activate an infection, a quarter of which has another
+    // one pending behind it.
+    pfg::PFalc person(pfg::Status::S, 0.0, 0.0, 0.0);
+    std::size_t active = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (long i = 0; i < calls; ++i) {
+      if (i % 2 == 0) {
+        person.scheduleInfection(i);
+        if (i % 8 == 0) {
+          person.scheduleInfection(i + 1.5);
+        }
+      }
+      active += person.updateInfection(i);
+    }
+    report("updateInfection", calls, 1, seconds_since(start) * 1e9 / calls,
+           "ns_per_call");
+    sink = active;
+  }
+  {
+    pfg::PFalc person(pfg::Status::S, 1.0, 1.0, 1.0);
+    pfg::NoEvents events;
+    const pfg::StepConstants constants(params, 1.0);
+    const auto start = std::chrono::steady_clock::now();
+    for (long i = 0; i < calls; ++i) {
+      person.current_ = pfg::Status::S;
+      pfg::SAU_infection(person, constants, functions, 0.0, uniform, events);
+    }
+    report("SAU_infection", calls, 1, seconds_since(start) * 1e9 / calls,
+           "ns_per_call");
+  }
+}
+
+static bool lower_is_better(const std::string& unit) {
+  const std::string rate = "_per_second";
+  return unit.size() < rate.size() ||
+         unit.compare(unit.size() - rate.size(), rate.size(), rate) != 0;
+}
+
+// Compare rows against an earlier run. Returns the number of regressions.
+static int compare(const std::string& path, const double tolerance) {
+  std::ifstream file(path);
+  if (!file) {
+    std::cerr << "Could not open baseline " << path << "\n";
+    return 1;
+  }
+  std::map<Key, double> baseline;
+  std::string line;
+  while (std::getline(file, line)) {
+    std::istringstream fields(line);
+    std::string benchmark, n, threads, value, unit;
+    std::getline(fields, benchmark, ',');
+    std::getline(fields, n, ',');
+    std::getline(fields, threads, ',');
+    std::getline(fields, value, ',');
+    std::getline(fields, unit, ',');
+    if (unit.empty() || benchmark == "benchmark") {
+      continue;
+    }
+    baseline[{benchmark, std::stol(n), std::stoul(threads), unit}] =
+        std::stod(value);
+  }
+
+  int regressions = 0;
+  for (const auto& row : rows) {
+    const auto it =
+        baseline.find({row.benchmark, row.n, row.threads, row.unit});
+    if (it == baseline.end()) {
+      continue;
+    }
+    const auto before = it->second;
+    const auto worse = lower_is_better(row.unit)
+                           ? row.value > before * (1.0 + tolerance)
+                           : row.value < before * (1.0 - tolerance);
+    if (worse) {
+      ++regressions;
+      std::cerr << "Regression: " << row.benchmark << " n=" << row.n
+                << " threads=" << row.threads << " " << row.unit << " "
+                << before << " -> " << row.value << "\n";
+    }
+  }
+  return regressions;
+}
+
+int main(int argc, char** argv) {
+  std::string baseline;
+  double tolerance = 0.1;
+  long steps = 10;
+  std::vector<long> sizes;
+  for (auto i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg == "--baseline" && i + 1 < argc) {
+      baseline = argv[++i];
+    } else if (arg == "--tolerance" && i + 1 < argc) {
+      tolerance = std::atof(argv[++i]);
+    } else if (arg == "--steps" && i + 1 < argc) {
+      steps = std::atol(argv[++i]);
+    } else {
+      sizes.push_back(std::atol(argv[i]));
+    }
+  }
+  if (sizes.empty()) {
+    sizes = {10000, 100000, 1000000};
+  }
+
+  std::cout << "benchmark,n,threads,value,unit" << std::endl;
+  generator.seed(1);
+  for (const auto n : sizes) {
+    {
+      std::vector<Individual<pfg::PFalc>> population;
+      population.reserve(n);
+      for (auto i = 0; i < n; ++i) {
+        population.emplace_back(10.0, pfg::Status::S, 0.0, 0.0, 0.0);
+      }
+      step_throughput("one_step_aos", population, steps, 1);
+    }
+    {
+      auto population = make_population(n);
+      step_throughput("one_step_soa", population, steps, 1);
+    }
+    {
+      auto population = make_population(n);
+      RandomStreams streams(1);
+      step_throughput("one_step_blocked", population, steps, 1, streams);
+      report("one_step_blocked", n, 1, bytes_per_agent(population),
+             "bytes_per_agent");
+    }
+    features_throughput<pfg::AllFeatures>("features_all", n, steps);
+    features_throughput<pfg::Features<false, false, true>>(
+        "features_no_mortality_no_delay", n, steps);
+    features_throughput<pfg::Features<false, false, false>>(
+        "features_none", n, steps);
+    campaign_throughput(n);
+    low_eir_throughput("low_eir_blocked", n, steps);
+    {
+      pfg::BitingTable table;
+      low_eir_throughput("low_eir_table", n, steps, table);
+    }
+    {
+      const auto path = "griffin_step_events.plasx";
+      auto population = make_population(n);
+      RandomStreams streams(1);
+      pfg::EventLog log(path);
+      step_throughput("one_step_logged", population, steps, 1, streams, log);
+      log.close();
+      std::remove(path);
+    }
+    {
+      pfg::HybridPopulation population;
+      population.agents = make_population(n);
+      population.cohorts.absorb(population.agents);
+      RandomStreams streams(1);
+      step_throughput("one_step_hybrid", population, steps, 1, streams);
+    }
+  }
+
+  // Thread scaling on the largest population.
+  const auto hardware = std::max(1u, std::thread::hardware_concurrency());
+  for (std::size_t threads = 1; threads <= hardware; threads *= 2) {
+    auto population = make_population(sizes.back());
+    ThreadPool pool(threads);
+    RandomStreams streams(1);
+    step_throughput("one_step_threaded", population, steps, threads, pool,
+                    streams);
+  }
+  for (std::size_t threads = 1; threads <= hardware; threads *= 2) {
+    metapopulation_throughput(sizes.back(), steps, threads);
+  }
+  for (std::size_t threads = 1; threads <= hardware; threads *= 2) {
+    equilibrium_throughput(sizes.back(), threads);
+  }
+
+  kernels();
+
+  if (!baseline.empty()) {
+    return compare(baseline, tolerance) == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
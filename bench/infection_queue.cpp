@@ -0,0 +1,100 @@
+// Compares the original per-individual std::priority_queue of infection times
+// with the cached next infection plus shared InfectionPool now used by PFalc.
+//
+// Usage: infection_queue [N] [steps] [delay]
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <queue>
+#include <vector>
+
+#include "PlasX/Falciparum/griffin.hpp"
+#include "PlasX/random.hpp"
+
+using namespace plasx;
+namespace pfg = falciparum::griffin;
+
+// Individual state as PFalc stored it before the pool was introduced.
+class LegacyPFalc {
+ public:
+  LegacyPFalc(const pfg::Status& status, double ICA, double ICM, double IA)
+      : current_(status), I_CA_(ICA), I_CM_(ICM), I_A_(IA), zeta_(1.0),
+        I_B_(0.0) {
+    infection_queue_.push(std::numeric_limits<double>::infinity());
+  };
+  void scheduleInfection(const double t) { infection_queue_.push(t); };
+  bool updateInfection(const double t) {
+    if (t < infection_queue_.top()) {
+      return false;
+    }
+    while (t >= infection_queue_.top()) {
+      infection_queue_.pop();
+    }
+    return true;
+  };
+
+  pfg::Status current_;
+
+ private:
+  double I_CA_;
+  double I_CM_;
+  double I_A_;
+  double zeta_;
+  double I_B_;
+  std::priority_queue<double, std::vector<double>, std::greater<double>>
+      infection_queue_;
+};
+
+template <class Agent>
+static void run(const char* name, const long N, const int steps,
+                const double delay) {
+  auto start = std::chrono::steady_clock::now();
+  std::vector<Agent> agents;
+  agents.reserve(N);
+  for (auto i = 0; i < N; ++i) {
+    agents.emplace_back(pfg::Status::S, 0.0, 0.0, 0.0);
+  }
+  auto built = std::chrono::steady_clock::now();
+
+  // Every individual is bitten with probability 0.05 per day.
+  Xoshiro256 rng(1);
+  long activated = 0;
+  for (auto step = 0; step < steps; ++step) {
+    const double t = step;
+    for (auto& agent : agents) {
+      if (rng.uniform() < 0.05) {
+        agent.scheduleInfection(t + delay);
+      }
+      activated += agent.updateInfection(t);
+    }
+  }
+  auto end = std::chrono::steady_clock::now();
+
+  std::chrono::duration<double, std::nano> construct = built - start;
+  std::chrono::duration<double, std::nano> stepping = end - built;
+  std::cout << name << ",ns_construct_per_agent," << construct.count() / N
+            << "\n";
+  std::cout << name << ",ns_per_agent_step,"
+            << stepping.count() / (static_cast<double>(N) * steps) << "\n";
+  std::cout << name << ",activated," << activated << "\n";
+}
+
+int main(int argc, char** argv) {
+  const long N = argc > 1 ? std::atol(argv[1]) : 1000000;
+  const int steps = argc > 2 ? std::atoi(argv[2]) : 50;
+  const double delay = argc > 3 ? std::atof(argv[3]) : 12.0;
+
+  std::cout << "layout,metric,value\n";
+  // The legacy queue also holds one heap allocation for its sentinel, not
+  // counting allocator overhead.
+  std::cout << "legacy,bytes_per_agent," << sizeof(LegacyPFalc) + sizeof(double)
+            << "\n";
+  std::cout << "pooled,bytes_per_agent," << sizeof(pfg::PFalc) << "\n";
+  run<LegacyPFalc>("legacy", N, steps, delay);
+  run<pfg::PFalc>("pooled", N, steps, delay);
+  std::cout << "pooled,pool_nodes_in_use,"
+            << pfg::InfectionPool::shared().size() << "\n";
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,79 @@
+// Compares one_step on the array of structs layout (std::vector of
+// Individual<PFalc>) against the column oriented Population.
+//
+// Usage: population_layout [steps] [N...]
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "PlasX/Falciparum/Griffin/population.hpp"
+#include "PlasX/Falciparum/griffin.hpp"
+#include "PlasX/random.hpp"
+#include "PlasX/simulation.hpp"
+#include "PlasX/thread_pool.hpp"
+#include "PlasX/udl.hpp"
+
+using namespace plasx;
+namespace pfg = falciparum::griffin;
+
+template <class PopulationType, class... Args>
+static double time_per_agent_step(PopulationType& population,
+                                  const pfg::Parameters& params,
+                                  const double days, Args&&... args) {
+  const auto n = static_cast<double>(population.size());
+  auto start = std::chrono::steady_clock::now();
+  plasx::simulation(0.0_days, days, 1.0_days, pfg::one_step, population,
+                    params, 1.0, args...);
+  auto end = std::chrono::steady_clock::now();
+  std::chrono::duration<double, std::nano> elapsed = end - start;
+  return elapsed.count() / (n * days);
+}
+
+int main(int argc, char** argv) {
+  pfg::Parameters params;
+  const double days = argc > 1 ? std::atof(argv[1]) : 10.0;
+  std::vector<long> sizes = {100000, 1000000, 10000000};
+  if (argc > 2) {
+    sizes.clear();
+    for (auto i = 2; i < argc; ++i) {
+      sizes.push_back(std::atol(argv[i]));
+    }
+  }
+
+  std::cerr << "N,layout,ns_per_agent_step\n";
+  for (const auto N : sizes) {
+    {
+      std::vector<Individual<pfg::PFalc>> population;
+      population.reserve(N);
+      for (auto i = 0; i < N; ++i) {
+        population.emplace_back(10.0, pfg::Status::S, 0.0, 0.0, 0.0);
+      }
+      std::cerr << N << ",aos," << time_per_agent_step(population, params, days)
+                << "\n";
+    }
+    {
+      pfg::Population population;
+      population.reserve(N);
+      for (auto i = 0; i < N; ++i) {
+        population.emplace_back(10.0, pfg::Status::S, 0.0, 0.0, 0.0);
+      }
+      std::cerr << N << ",soa," << time_per_agent_step(population, params, days)
+                << "\n";
+    }
+    {
+      // Batched kernels on a single thread.
+      pfg::Population population;
+      population.reserve(N);
+      for (auto i = 0; i < N; ++i) {
+        population.emplace_back(10.0, pfg::Status::S, 0.0, 0.0, 0.0);
+      }
+      ThreadPool pool(1);
+      RandomStreams streams(1);
+      std::cerr << N << ",soa_batched,"
+                << time_per_agent_step(population, params, days, pool, streams)
+                << "\n";
+    }
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,153 @@
+#ifndef PLASX_FALCIPARUM_GRIFFIN_BITING_HPP
+#define PLASX_FALCIPARUM_GRIFFIN_BITING_HPP
+/**
+ * @file biting.hpp
+ * @author Eamon Conway (conway.e@wehi.edu.au)
+ * @brief Heterogeneous biting, with the infectious bites of a step allocated
+ * to the population as a whole.
+ * @version 0.1
+ * @date 2023-07-25
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "PlasX/Falciparum/Griffin/immunity_functions.hpp"
+#include "PlasX/Falciparum/Griffin/parameters.h"
+#include "PlasX/random.hpp"
+#include "PlasX/types.hpp"
+namespace plasx {
+namespace falciparum {
+namespace griffin {
+
+inline namespace PLASX_PRECISION_NAMESPACE {
+class Population;
+}  // namespace PLASX_PRECISION_NAMESPACE
+
+/**
+ * @brief Draw a relative biting rate zeta from the log-normal distribution
+ * with mean 1 and standard deviation sigma of log(zeta). Everyone draws their
+ * own when the population is built and again when they are born.
+ *
+ * @tparam Generator Any uniform random bit generator, e.g. Xoshiro256.
+ * @param params
+ * @param rng
+ * @return double
+ */
+template <class Generator>
+double draw_zeta(const Parameters& params, Generator& rng) {
+  const auto sigma = params.sigma;
+  return std::exp(sigma * std::normal_distribution<double>()(rng) -
+                  0.5 * sigma * sigma);
+}
+
+inline namespace PLASX_PRECISION_NAMESPACE {
+
+/**
+ * @brief Allocates the infectious bites of a step, rather than deciding for
+ * every individual whether they are bitten.
+ *
+ * @details Individual i is bitten at rate eir * psi(age) * b(I_B) * zeta. As
+ * psi <= 1 and b <= b_max, the table draws the number of candidate bites on
+ * each block of OneStep::block_size individuals from a Poisson distribution of
+ * mean dt * eir * b_max * sum(zeta) over the block, and hands each to an
+ * individual of the block in proportion to zeta, found in O(log n) in a
+ * Fenwick tree of the block's zeta. A candidate is kept with probability
+ * psi * b / b_max, so the bites each individual gets are Poisson with exactly
+ * their own rate, and only those handed a candidate are looked at. The number
+ * of candidates grows with eir, so this pays off at low transmission.
+ *
+ * Each block draws from the stream of its place in the whole population, and
+ * its tree only holds its own zeta, so the bites do not depend on the number
+ * of threads or on how the population is split between processes (see
+ * Domain).
+ *
+ * zeta only changes at birth, when the newborn draws their own (see
+ * draw_zeta), and the tree of their block is updated in place (see born). The
+ * trees are rebuilt whenever the size of the population changes. Call rebuild
+ * if individuals are moved or their zeta is changed in any other way.
+ */
+class BitingTable {
+ public:
+  /**
+   * @brief Allocate the infectious bites of a step of length dt. Block b of
+   * population draws from streams.stream(epoch, first_block + b).
+   *
+   * @param population
+   * @param params
+   * @param functions
+   * @param eir
+   * @param dt
+   * @param streams
+   * @param epoch
+   * @param first_block Place of the first block of population in the whole
+   * population, as in Domain::first_block.
+   * @return const char* One flag per individual, 1 if they were bitten at
+   * least once. Valid until the next call.
+   */
+  const char* allocate(const Population& population, const Parameters& params,
+                       const ImmunityFunctions& functions, const double eir,
+                       const double dt, const RandomStreams& streams,
+                       const std::uint64_t epoch,
+                       const std::size_t first_block);
+
+  /**
+   * @brief The individual at index has just been born, with a zeta of their
+   * own. Update the tree.
+   *
+   * @param population
+   * @param index
+   */
+  void born(const Population& population, const std::size_t index) noexcept;
+
+  /**
+   * @brief Build the trees from the zeta of everyone in population.
+   *
+   * @param population
+   */
+  void rebuild(const Population& population);
+
+  /**
+   * @brief Sum of zeta over the population.
+   *
+   * @return double
+   */
+  double total() const noexcept;
+
+  /**
+   * @brief Number of candidate bites drawn in the most recent step.
+   *
+   * @return std::size_t
+   */
+  std::size_t candidates() const noexcept { return candidates_; };
+
+ private:
+  void build(const std::size_t block);
+  void add(std::size_t index, const double delta) noexcept;
+  double total(const std::size_t block) const noexcept;
+  std::size_t find(const std::size_t block, double u) const noexcept;
+
+  // Fenwick tree of each block, tree_[block * (block_size + 1) + k] for
+  // k = 1, ..., the size of the block.
+  std::vector<double> tree_;
+  // zeta of each individual, as held in the trees.
+  std::vector<StateType> zeta_;
+  // Births in each block since its tree was built. It is rebuilt after
+  // block_size of them, so that rounding errors in the sums do not build up.
+  std::vector<std::size_t> births_;
+  std::vector<char> bitten_;
+  std::vector<std::size_t> marked_;
+  std::size_t candidates_ = 0;
+};
+
+}  // namespace PLASX_PRECISION_NAMESPACE
+
+}  // namespace griffin
+}  // namespace falciparum
+}  // namespace plasx
+#endif
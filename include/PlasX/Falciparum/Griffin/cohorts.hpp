@@ -0,0 +1,181 @@
+#ifndef PLASX_FALCIPARUM_GRIFFIN_COHORTS_HPP
+#define PLASX_FALCIPARUM_GRIFFIN_COHORTS_HPP
+/**
+ * @file cohorts.hpp
+ * @author Eamon Conway (conway.e@wehi.edu.au)
+ * @brief Susceptibles held as counts in age and immunity bins, alongside
+ * individual agents for everyone else.
+ * @version 0.1
+ * @date 2023-07-04
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "PlasX/Falciparum/Griffin/immunity_functions.hpp"
+#include "PlasX/Falciparum/Griffin/mosquito.hpp"
+#include "PlasX/Falciparum/Griffin/parameters.h"
+#include "PlasX/Falciparum/Griffin/population.hpp"
+#include "PlasX/random.hpp"
+#include "PlasX/types.hpp"
+namespace plasx {
+namespace falciparum {
+namespace griffin {
+
+/**
+ * @brief Susceptibles with no infection pending, grouped by age and by
+ * immunity to bites I_B.
+ *
+ * @details A susceptible's chance of being infected in a step only depends on
+ * their age (through psi) and I_B (through b), so everyone in a bin is treated
+ * as having the bin's mean age and immunity. A step then only needs two
+ * binomial draws per bin: the number infected, and the number of the rest
+ * that die. The infected leave the bin as individual agents, since what
+ * happens to them next depends on the rest of their immunity, which is also
+ * kept as a mean per bin.
+ *
+ * Every bin is aged and its immunity decayed exactly, and bins that drift
+ * over an edge are merged into their new neighbour.
+ *
+ * Only the mean zeta of each bin is kept. It scales the bin's hazard, which
+ * gets the expected number infected right to first order in dt, and the
+ * infected leave with it. This is an approximation: among agents those with a
+ * high zeta are the more likely to be infected, and again once they are back
+ * in S, whereas a bin hands out its mean to whoever is infected. Newborns go
+ * into the youngest bin with zeta = 1, the mean of the distribution.
+ */
+class Cohorts {
+ public:
+  /**
+   * @brief Everyone in one bin.
+   *
+   */
+  struct Cohort {
+    std::uint64_t count;
+    double age;
+    double I_CA;
+    double I_CM;
+    double I_A;
+    double I_B;
+    double zeta;
+  };
+
+  /**
+   * @brief Construct a new Cohorts object, with no one in it.
+   *
+   * @param age_edges Lower edge of each age bin (in days), starting at 0.
+   * @param IB_edges Lower edge of each bin of I_B, starting at 0.
+   */
+  explicit Cohorts(std::vector<double> age_edges = default_age_edges(),
+                   std::vector<double> IB_edges = default_IB_edges());
+
+  /**
+   * @brief Move every agent that is in S, with no infection pending, into the
+   * bins. The remaining agents keep their order.
+   *
+   * @param agents
+   */
+  void absorb(Population& agents);
+
+  /**
+   * @brief Step every bin from t to t + dt. The infected are added to agents
+   * with their infection due at t. The dead are replaced by newborns, added to
+   * the youngest bin. The infectiousness of everyone left in the bins is
+   * added to humans.
+   *
+   * @param t
+   * @param dt
+   * @param params
+   * @param eir
+   * @param agents
+   * @param rng
+   * @param humans
+   */
+  void step(const double t, const double dt, const Parameters& params,
+            const double eir, Population& agents, Xoshiro256& rng,
+            Infectiousness& humans);
+
+  /**
+   * @brief Number of individuals in the bins.
+   *
+   * @return std::uint64_t
+   */
+  std::uint64_t count() const noexcept;
+
+  const std::vector<Cohort>& cohorts() const noexcept { return cohorts_; };
+
+  /**
+   * @brief Those who died in the most recent step, one Cohort per bin, as
+   * they were at the start of it.
+   *
+   * @return const std::vector<Cohort>&
+   */
+  const std::vector<Cohort>& died() const noexcept { return died_; };
+
+  /**
+   * @brief One bin per year of age up to 100 years.
+   *
+   * @return std::vector<double>
+   */
+  static std::vector<double> default_age_edges();
+
+  /**
+   * @brief Bins of I_B that double in width, 0, 0.25, 0.5, 1, ..., 1024.
+   *
+   * @return std::vector<double>
+   */
+  static std::vector<double> default_IB_edges();
+
+ private:
+  std::size_t bin(const double age, const double IB) const noexcept;
+  void add(const std::size_t bin, const Cohort& cohort) noexcept;
+  const ImmunityFunctions& functions(const Parameters& params);
+
+  std::vector<double> age_edges_;
+  std::vector<double> IB_edges_;
+  std::vector<Cohort> cohorts_;
+  // Bins are moved here, and swapped back, when they are rebinned.
+  std::vector<Cohort> next_;
+  std::vector<Cohort> died_;
+  std::optional<Parameters> params_;
+  std::optional<ImmunityFunctions> functions_;
+};
+
+inline namespace PLASX_PRECISION_NAMESPACE {
+
+/**
+ * @brief Population made of binned susceptibles and individual agents.
+ *
+ * @details Step it with one_step and a RandomStreams, and optionally a
+ * ThreadPool, Mosquitoes or a Recorder. The bins are stepped first, then the
+ * agents with the blocked step of OneStep, and finally any agent that has
+ * settled back into S is absorbed into the bins. A Recorder counts the binned
+ * in S, by the band of their bin's mean age, and is counted again at the end
+ * of every step. At low transmission nearly everyone is in the bins, and a
+ * step costs little more than the number of bins.
+ *
+ * Newborns that replace dead agents take their maternal immunity from the
+ * agents' mothers, those that replace the binned take it from everyone.
+ */
+struct HybridPopulation {
+  /**
+   * @brief Total number of individuals.
+   *
+   * @return std::size_t
+   */
+  std::size_t size() const noexcept { return agents.size() + cohorts.count(); };
+
+  Population agents;
+  Cohorts cohorts;
+};
+
+}  // namespace PLASX_PRECISION_NAMESPACE
+
+}  // namespace griffin
+}  // namespace falciparum
+}  // namespace plasx
+#endif
@@ -0,0 +1,130 @@
+#ifndef PLASX_FALCIPARUM_GRIFFIN_DOMAIN_HPP
+#define PLASX_FALCIPARUM_GRIFFIN_DOMAIN_HPP
+/**
+ * @file domain.hpp
+ * @author Eamon Conway (conway.e@wehi.edu.au)
+ * @brief A population split into shards held by separate processes.
+ * @version 0.1
+ * @date 2023-06-27
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+#include "PlasX/Falciparum/Griffin/mosquito.hpp"
+#include "PlasX/Falciparum/Griffin/population.hpp"
+#include "PlasX/Falciparum/Griffin/turnover.hpp"
+#include "PlasX/communicator.hpp"
+namespace plasx {
+namespace falciparum {
+namespace griffin {
+
+class Recorder;
+class Snapshot;
+
+/**
+ * @brief This process's part of a population that is spread over every
+ * process of a Communicator.
+ *
+ * @details The population is cut into the blocks of OneStep::block_size used
+ * by the blocked step, and each process holds a contiguous run of whole
+ * blocks, its shard. Pass the Domain to one_step, along with the
+ * RandomStreams and optionally a ThreadPool, to step the shard (see OneStep).
+ * Every block draws from the stream of its place in the whole population, and
+ * the only things shared between processes, the maternal immunity of newborns
+ * and the infectiousness of the humans, are shared block by block and added
+ * up in block order. A run therefore gives exactly the same result on any
+ * number of processes, and the same as the blocked step of the whole
+ * population on one.
+ *
+ * Each process should start from the same seed for its RandomStreams, and the
+ * same Mosquitoes, which then stay the same on every process. A process only
+ * ever needs its own shard in memory: build it individual by individual, or
+ * load it from a snapshot of the whole population (see shard).
+ */
+class Domain {
+ public:
+  /**
+   * @brief Construct a new Domain object.
+   *
+   * @param communicator
+   * @param n Size of the whole population.
+   */
+  Domain(Communicator& communicator, const std::size_t n);
+
+  /**
+   * @brief The shard, [begin(), end()), of the whole population.
+   *
+   * @return std::size_t
+   */
+  std::size_t begin() const noexcept { return begin_; };
+  std::size_t end() const noexcept { return end_; };
+  std::size_t first_block() const noexcept;
+
+  /**
+   * @brief Copy this process's shard out of the whole population.
+   *
+   * @param whole
+   * @return Population
+   */
+  Population shard(const Population& whole) const;
+
+  /**
+   * @brief Build this process's shard, calling add(index, shard) for each
+   * index of the whole population in [begin(), end()), in order. Each call
+   * must add exactly one individual to the end of shard (e.g. with
+   * emplace_back), otherwise std::logic_error is thrown.
+   *
+   * @param add
+   * @return Population
+   */
+  Population shard(
+      const std::function<void(std::size_t, Population&)>& add) const;
+
+  /**
+   * @brief Load this process's shard from a snapshot of the whole population,
+   * reading only its part of the file.
+   *
+   * @param whole
+   * @return Population
+   */
+  Population shard(const Snapshot& whole) const;
+
+  /**
+   * @brief Replace the counts of this process's blocks with those of every
+   * block of the whole population, in order.
+   *
+   * @param mothers
+   * @param humans
+   */
+  void share(std::vector<Mothers>& mothers,
+             std::vector<Infectiousness>& humans) const;
+
+  /**
+   * @brief Fill row with the row of recorder (see Recorder::fill_row), added up
+   * over every process. Each process's recorder should only count its shard.
+   *
+   * @param recorder
+   * @param t
+   * @param row
+   */
+  void gather(const Recorder& recorder, const double t,
+              std::vector<double>& row) const;
+
+  Communicator& communicator() const noexcept { return communicator_; };
+
+ private:
+  Communicator& communicator_;
+  std::size_t n_;
+  std::size_t n_blocks_;
+  std::size_t begin_;
+  std::size_t end_;
+};
+
+}  // namespace griffin
+}  // namespace falciparum
+}  // namespace plasx
+#endif
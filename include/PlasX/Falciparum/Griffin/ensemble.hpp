@@ -0,0 +1,157 @@
+#ifndef PLASX_FALCIPARUM_GRIFFIN_ENSEMBLE_HPP
+#define PLASX_FALCIPARUM_GRIFFIN_ENSEMBLE_HPP
+/**
+ * @file ensemble.hpp
+ * @author Eamon Conway (conway.e@wehi.edu.au)
+ * @brief Run many replicates of many scenarios side by side.
+ * @version 0.1
+ * @date 2023-05-16
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "PlasX/Falciparum/Griffin/parameters.h"
+#include "PlasX/Falciparum/Griffin/population.hpp"
+#include "PlasX/column_writer.hpp"
+#include "PlasX/thread_pool.hpp"
+namespace plasx {
+namespace falciparum {
+namespace griffin {
+
+/**
+ * @brief One point of a parameter grid.
+ *
+ */
+struct Scenario {
+  Parameters params;
+  double eir;
+};
+
+/**
+ * @brief Single output shared by every replicate of an ensemble.
+ *
+ * @details Every row is one step of one replicate: the columns "scenario" and
+ * "replicate", followed by the columns of a Recorder (see
+ * Recorder::column_names). Replicates buffer their own rows and hand them over
+ * in one go, so rows from different replicates are not interleaved. Each batch
+ * of rows has a place in the output (see reserve), and batches that arrive
+ * before an earlier place has been filled are held back until it is, so the
+ * file is always in the order of the places.
+ */
+class EnsembleOutput {
+ public:
+  /**
+   * @brief Construct a new EnsembleOutput object.
+   *
+   * @param path
+   * @param band_edges Age bands used by each replicate's Recorder.
+   * @param chunk_rows Number of rows buffered before writing.
+   */
+  EnsembleOutput(const std::string& path,
+                 std::vector<double> band_edges = {0.0},
+                 std::size_t chunk_rows = 4096);
+
+  /**
+   * @brief Set aside count consecutive places in the output.
+   *
+   * @param count
+   * @return std::size_t The first of them.
+   */
+  std::size_t reserve(const std::size_t count);
+
+  /**
+   * @brief Write n_rows rows, stored one after the other in rows, at place.
+   *
+   * @param place
+   * @param rows
+   * @param n_rows
+   */
+  void append(const std::size_t place, const std::vector<double>& rows,
+              const std::size_t n_rows);
+
+  const std::vector<double>& band_edges() const noexcept { return edges_; };
+  std::size_t width() const noexcept { return writer_.names().size(); };
+
+  /**
+   * @brief Write out any buffered rows.
+   *
+   */
+  void flush();
+
+ private:
+  std::vector<double> edges_;
+  std::mutex mutex_;
+  ColumnWriter writer_;
+  // Next place to be written, and the first that has not been reserved.
+  std::size_t next_ = 0;
+  std::size_t reserved_ = 0;
+  // Rows that arrived ahead of their place.
+  std::map<std::size_t, std::vector<double>> waiting_;
+};
+
+/**
+ * @brief Runs replicates of a set of scenarios concurrently on a ThreadPool.
+ *
+ * @details Each (scenario, replicate) pair is one task. Tasks are handed to
+ * the threads one at a time, so a thread that finishes early simply picks up
+ * the next replicate. A replicate steps its own copy of the initial population
+ * with the blocked step of OneStep and its own RandomStreams, keyed by the
+ * ensemble seed, the scenario and the replicate. The rows are written in
+ * (scenario, replicate) order, so the output does not depend on the number of
+ * threads or on which thread ran which replicate. A replicate that finishes
+ * before those ahead of it keeps its rows in memory until they are written.
+ *
+ * Populations are only ever copied into buffers that the Ensemble keeps
+ * between replicates (and between calls to run), so after the first replicate
+ * on each thread no more memory is allocated for them.
+ */
+class Ensemble {
+ public:
+  explicit Ensemble(ThreadPool& pool) : pool_(pool){};
+
+  /**
+   * @brief Run replicates of every scenario from t0 to t1.
+   *
+   * @param scenarios Shared, read-only, between all replicates.
+   * @param replicates Number of replicates of each scenario.
+   * @param initial Population every replicate starts from.
+   * @param t0
+   * @param t1
+   * @param dt
+   * @param output
+   * @param seed
+   */
+  void run(const std::vector<Scenario>& scenarios,
+           const std::size_t replicates, const Population& initial,
+           const double t0, const double t1, const double dt,
+           EnsembleOutput& output, const std::uint64_t seed);
+
+  /**
+   * @brief Number of population buffers that have been allocated.
+   *
+   * @return std::size_t
+   */
+  std::size_t buffers() const noexcept { return allocated_; };
+
+ private:
+  std::unique_ptr<Population> acquire();
+  void release(std::unique_ptr<Population> buffer);
+
+  ThreadPool& pool_;
+  std::mutex mutex_;
+  std::vector<std::unique_ptr<Population>> free_;
+  std::size_t allocated_ = 0;
+};
+
+}  // namespace griffin
+}  // namespace falciparum
+}  // namespace plasx
+#endif
@@ -0,0 +1,155 @@
+#ifndef PLASX_FALCIPARUM_GRIFFIN_EQUILIBRIUM_HPP
+#define PLASX_FALCIPARUM_GRIFFIN_EQUILIBRIUM_HPP
+/**
+ * @file equilibrium.hpp
+ * @author Eamon Conway (conway.e@wehi.edu.au)
+ * @brief Populations that start at equilibrium with a constant EIR, rather
+ * than having to be burned in.
+ * @version 0.1
+ * @date 2023-07-31
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#include <array>
+#include <cstddef>
+#include <vector>
+
+#include "PlasX/Falciparum/Griffin/parameters.h"
+#include "PlasX/Falciparum/griffin.hpp"
+#include "PlasX/random.hpp"
+#include "PlasX/thread_pool.hpp"
+#include "PlasX/types.hpp"
+namespace plasx {
+namespace falciparum {
+namespace griffin {
+
+inline namespace PLASX_PRECISION_NAMESPACE {
+class Population;
+}  // namespace PLASX_PRECISION_NAMESPACE
+
+/**
+ * @brief Share of each compartment and mean immunity by age and biting rate,
+ * at equilibrium with a constant EIR.
+ *
+ * @details Deaths do not depend on the compartment and everyone is born in S,
+ * so the population at equilibrium is a birth cohort followed through life.
+ * The cohort is stepped from birth with steps of dt, exactly as OneStep steps
+ * an individual, but with the share in each compartment and the mean of each
+ * immunity over those in it in place of one individual's. zeta is
+ * log-normal, and the cohort is followed at each node of a Gauss-Hermite rule
+ * in log zeta, which the shares are integrated over. The maternal immunity of
+ * a newborn depends on the immunity of the mothers, which in turn depends on
+ * their own maternal immunity, so the cohort is stepped again until it
+ * settles.
+ *
+ * fill draws an age, exponential with mean 1 / mu_d, and a zeta (see
+ * draw_zeta). The zeta falls in the share of the population that belongs to
+ * one node, and the compartment and immunity are drawn from that node's
+ * profile of the age. Everyone in a compartment is given its mean immunity,
+ * so the spread of immunity within a compartment is not kept. As b and phi
+ * are far from linear in immunity, a population filled from here is close
+ * to, not exactly at, the equilibrium of the simulation. With the default
+ * parameters, at EIRs from 0.005 to 0.5 a day, the share in S moves by about
+ * 3% of itself in the first year and those in A and U by up to 12%, and they
+ * change little after that. That is a short burn in, rather than the decades
+ * it takes the ages of a population that starts out all the same age to
+ * settle.
+ *
+ * Throws std::invalid_argument if mu_d, eir or dt are out of range.
+ */
+class Equilibrium {
+ public:
+  /**
+   * @brief Everyone of one age and node.
+   *
+   */
+  struct Profile {
+    std::array<double, n_status> share;
+    // Mean immunity of those in each compartment.
+    std::array<double, n_status> I_CA;
+    std::array<double, n_status> I_A;
+    std::array<double, n_status> I_B;
+    double I_CM;
+  };
+
+  /**
+   * @brief Construct a new Equilibrium object
+   *
+   * @param params
+   * @param eir
+   * @param dt Step the population will be simulated with.
+   */
+  Equilibrium(const Parameters& params, const double eir,
+              const double dt = 1.0);
+
+  /**
+   * @brief Profile of those of age and relative biting rate zeta, that of the
+   * node zeta belongs to. Profiles are kept for the first 128 steps of life
+   * and then every 1/128 of the age, so it is of those up to that much
+   * younger.
+   *
+   * @param age
+   * @param zeta
+   * @return const Profile&
+   */
+  const Profile& at(const double age, const double zeta = 1.0) const noexcept;
+
+  /**
+   * @brief Share of the whole population in compartment status.
+   *
+   * @param status
+   * @return double
+   */
+  double share(const Status status) const noexcept;
+
+  /**
+   * @brief Replace the contents of population with n individuals drawn from
+   * the equilibrium, filled in blocks of OneStep::block_size across pool.
+   * Each block has its own stream of streams, so the result does not depend
+   * on the number of threads.
+   *
+   * @param population
+   * @param n
+   * @param pool
+   * @param streams
+   */
+  void fill(Population& population, const std::size_t n, ThreadPool& pool,
+            RandomStreams& streams) const;
+
+  /**
+   * @brief As above, on this thread. Gives the same result.
+   *
+   * @param population
+   * @param n
+   * @param streams
+   */
+  void fill(Population& population, const std::size_t n,
+            RandomStreams& streams) const;
+
+ private:
+  template <class ForBlocks>
+  void fill(Population& population, const std::size_t n,
+            RandomStreams& streams, ForBlocks for_blocks) const;
+  std::size_t node(const double zeta) const noexcept;
+
+  // zeta is drawn with these.
+  Parameters params_;
+  double mu_d_;
+  double dt_;
+  // The zeta of each node, its weight, and the sum of the weights up to and
+  // including it.
+  std::vector<double> zeta_;
+  std::vector<double> weights_;
+  std::vector<double> bounds_;
+  // profiles_[j][r] is everyone aged [k * dt, (k + 1) * dt) at node j, where
+  // k = kept_[r].
+  std::vector<std::size_t> kept_;
+  std::vector<std::vector<Profile>> profiles_;
+  std::array<double, n_status> share_;
+};
+
+}  // namespace griffin
+}  // namespace falciparum
+}  // namespace plasx
+#endif
@@ -0,0 +1,138 @@
+#ifndef PLASX_FALCIPARUM_GRIFFIN_EVENT_DRIVEN_HPP
+#define PLASX_FALCIPARUM_GRIFFIN_EVENT_DRIVEN_HPP
+/**
+ * @file event_driven.hpp
+ * @author Eamon Conway (conway.e@wehi.edu.au)
+ * @brief Event driven (next reaction) simulation of the Griffin model.
+ * @version 0.1
+ * @date 2023-04-24
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "PlasX/Falciparum/Griffin/immunity_functions.hpp"
+#include "PlasX/Falciparum/Griffin/parameters.h"
+#include "PlasX/Falciparum/Griffin/population.hpp"
+#include "PlasX/random.hpp"
+#include "PlasX/types.hpp"
+namespace plasx {
+namespace falciparum {
+namespace griffin {
+
+/**
+ * @brief Continuous time alternative to OneStep.
+ *
+ * @details Between an individual's events their rates change only through
+ * their age (psi) and the decay of their immunity (b and r_A), and each has a
+ * bound that holds until their next event: psi is at most 1, b at most
+ * b_max, and r_A lies between its value at the last event and r_A0, as I_A
+ * only decays. Candidate events are sampled at these bounding rates (the EIR
+ * is fixed over a call), and at each candidate the individual is caught up
+ * and the candidate is kept with probability rate over bound. This thinning
+ * samples the continuous time model exactly. The candidate times are kept in
+ * a single calendar ordered by time, and only individuals whose candidate is
+ * due are ever visited. In low transmission settings, where most of the
+ * population sits in S with a tiny hazard, this is far less work than
+ * visiting everyone every step.
+ *
+ * Age and immunity are caught up exactly (see turnover.hpp) at every
+ * candidate of the individual, and for everyone when the calendar is rebuilt;
+ * call catch_up before reading them. As in OneStep, the dead are replaced in
+ * place by newborns.
+ *
+ * An EventDriven object has the same call signature as OneStep, so it can be
+ * passed to plasx::simulation, which steps the engine it is given rather than
+ * a copy. There dt only sets how often control returns to the caller, it has
+ * no effect on the dynamics. Bites become infections
+ * immediately, as they do in OneStep with no delay, so the pending infection
+ * columns of the population are not used.
+ *
+ * The mothers that newborns take their maternal immunity from (see Mothers)
+ * are kept up to date as individuals have events, die and age into or out of
+ * the maternal ages, the last in a second calendar of their own, so a death
+ * never needs a pass over the population. The I_CA of each mother is the one
+ * she had at her last candidate.
+ *
+ * The calendar belongs to one population. It is rebuilt when the EIR, the
+ * parameters or the size of the population change between calls.
+ */
+class EventDriven {
+ public:
+  explicit EventDriven(std::uint64_t seed) : rng_(seed){};
+
+  /**
+   * @brief Run every event in [t, t + dt).
+   *
+   * @param t
+   * @param dt
+   * @param population
+   * @param params
+   * @param eir
+   * @return double t + dt
+   */
+  double operator()(double t, double dt, Population& population,
+                    const Parameters& params, double eir);
+
+  /**
+   * @brief Total number of candidate events processed so far, including
+   * those rejected by thinning.
+   *
+   * @return std::size_t
+   */
+  std::size_t events() const noexcept { return events_; };
+
+ private:
+  struct Event {
+    double time;
+    std::uint32_t index;
+  };
+
+  void rebuild(const double t, Population& population,
+               const Parameters& params, const double eir);
+  void schedule(const std::size_t i, const double t,
+                const Population& population, const Parameters& params);
+  double exit_rate(const std::size_t i, const Population& population,
+                   const Parameters& params) const;
+  double exit_bound(const std::size_t i, const Population& population,
+                    const Parameters& params) const;
+  double force_of_infection(const std::size_t i,
+                            const Population& population) const;
+  void count_mothers(const double t, const Population& population);
+  void track_mother(const std::size_t i, const double t,
+                    const Population& population);
+  void update_mother(const std::size_t i, const Population& population);
+  void run_ageing(const double t, const Population& population);
+  bool fire(const std::size_t i, const double t, Population& population,
+            const Parameters& params);
+
+  // Min-heap on time, holding one entry per individual with a finite next
+  // event time.
+  std::vector<Event> calendar_;
+  Xoshiro256 rng_;
+  // Parameters and EIR the calendar was built for.
+  std::optional<Parameters> params_;
+  std::optional<ImmunityFunctions> functions_;
+  double eir_ = -1.0;
+  std::size_t events_ = 0;
+
+  // Min-heap of the times individuals age into or out of the maternal ages.
+  // Entries left over from before an individual died are skipped.
+  std::vector<Event> ageing_;
+  // Time each individual was born, possibly before the simulation started.
+  std::vector<double> born_;
+  // I_CA counted towards the mothers for each individual, or NaN if they are
+  // not one.
+  std::vector<double> mother_ICA_;
+  double mothers_sum_ = 0.0;
+  std::size_t mothers_count_ = 0;
+};
+
+}  // namespace griffin
+}  // namespace falciparum
+}  // namespace plasx
+#endif
@@ -0,0 +1,214 @@
+#ifndef PLASX_FALCIPARUM_GRIFFIN_EVENT_LOG_HPP
+#define PLASX_FALCIPARUM_GRIFFIN_EVENT_LOG_HPP
+/**
+ * @file event_log.hpp
+ * @author Eamon Conway (conway.e@wehi.edu.au)
+ * @brief Individual level history of a simulation, written to a compressed
+ * columnar file as it runs.
+ * @version 0.1
+ * @date 2023-07-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "PlasX/Falciparum/griffin.hpp"
+namespace plasx {
+namespace falciparum {
+namespace griffin {
+
+/**
+ * @brief What happened to an individual.
+ *
+ * @details An infection records the compartment the infection sent the
+ * individual to, those to D or T are clinical episodes and those to T are
+ * treated. Every other change of compartment is a transition. A death is
+ * followed, in the same step, by the birth of the newborn who takes the same
+ * place in the population.
+ */
+enum class Event : std::uint8_t { infection, transition, death, birth };
+
+/**
+ * @brief Events of one block of a step, so that no buffer is shared between
+ * threads.
+ *
+ */
+class EventBuffer {
+ public:
+  void add(const std::uint64_t individual, const Event event,
+           const Status from, const Status to) {
+    individual_.push_back(individual);
+    event_.push_back(static_cast<std::uint8_t>(event));
+    from_.push_back(static_cast<std::uint8_t>(from));
+    to_.push_back(static_cast<std::uint8_t>(to));
+  };
+
+  void clear() noexcept;
+  std::size_t size() const noexcept { return individual_.size(); };
+
+ private:
+  friend class EventLog;
+
+  std::vector<std::uint64_t> individual_;
+  std::vector<std::uint8_t> event_;
+  std::vector<std::uint8_t> from_;
+  std::vector<std::uint8_t> to_;
+};
+
+/**
+ * @brief Writes every event of a simulation to path.
+ *
+ * @details Give one to OneStep along with a Population. The events of each
+ * block are kept in a buffer of its own and appended in block order once the
+ * step is done, so the file does not depend on the number of threads. Full
+ * chunks are handed to a writer thread that compresses and writes them, and
+ * the step only waits for it when it is two chunks behind. The layout is
+ *
+ *   "PLASXEVT" | uint32 version | uint32 number of columns |
+ *   chunks of (uint64 records, (uint64 bytes, zlib stream) per column)
+ *
+ * in native byte order, the columns being time (double), individual (uint64),
+ * event, from and to (uint8 each). An event is timed by the start of the step
+ * it happened in, and the individual is their index in the population.
+ *
+ * Throws std::runtime_error if the file can not be opened or written.
+ */
+class EventLog {
+ public:
+  /**
+   * @brief Construct a new Event Log object and write the header.
+   *
+   * @param path
+   * @param chunk_records Number of events buffered before they are written.
+   * @param level zlib compression level, from 1 (fastest) to 9 (smallest).
+   */
+  explicit EventLog(const std::string& path,
+                    std::size_t chunk_records = 1 << 16, int level = 1);
+  ~EventLog();
+
+  EventLog(const EventLog&) = delete;
+  EventLog& operator=(const EventLog&) = delete;
+
+  /**
+   * @brief Clear one buffer per block for the step about to run.
+   *
+   * @param n_blocks
+   */
+  void start_step(const std::size_t n_blocks);
+
+  EventBuffer& buffer(const std::size_t block) noexcept {
+    return buffers_[block];
+  };
+
+  /**
+   * @brief Append the buffers, in block order, to the events of the step that
+   * started at t.
+   *
+   * @param t
+   */
+  void end_step(const double t);
+
+  /**
+   * @brief Write every remaining event and close the file. Called by the
+   * destructor, which ignores any failure.
+   *
+   */
+  void close();
+
+  /**
+   * @brief Number of events logged so far.
+   *
+   * @return std::uint64_t
+   */
+  std::uint64_t records() const noexcept { return records_; };
+
+ private:
+  struct Chunk {
+    std::vector<double> time;
+    std::vector<std::uint64_t> individual;
+    std::vector<std::uint8_t> event;
+    std::vector<std::uint8_t> from;
+    std::vector<std::uint8_t> to;
+  };
+
+  void hand_off();
+  void write_chunks();
+
+  std::ofstream file_;
+  std::string path_;
+  std::size_t chunk_records_;
+  int level_;
+  std::vector<EventBuffer> buffers_;
+  Chunk chunk_;
+  std::uint64_t records_ = 0;
+
+  // Chunks waiting for the writer thread.
+  std::mutex mutex_;
+  std::condition_variable changed_;
+  std::deque<Chunk> queue_;
+  bool closing_ = false;
+  bool failed_ = false;
+  bool closed_ = false;
+  std::thread writer_;
+};
+
+/**
+ * @brief Events of an individual, in the form handed to the update rules
+ * (see update.hpp).
+ *
+ */
+struct LogEvents {
+  void infection(const Status) noexcept { infected = true; };
+  void update(const Status before, const Status after, const bool death) {
+    if (death) {
+      buffer.add(individual, Event::death, before, before);
+    } else if (infected) {
+      buffer.add(individual, Event::infection, before, after);
+    } else if (before != after) {
+      buffer.add(individual, Event::transition, before, after);
+    }
+  };
+  void aged(const double, const Status) const noexcept {};
+  void birth() {
+    buffer.add(individual, Event::birth, Status::S, Status::S);
+  };
+
+  EventBuffer& buffer;
+  std::uint64_t individual;
+  bool infected = false;
+};
+
+/**
+ * @brief Contents of a file written by EventLog, one entry per event.
+ *
+ */
+struct EventTable {
+  std::vector<double> time;
+  std::vector<std::uint64_t> individual;
+  std::vector<Event> event;
+  std::vector<Status> from;
+  std::vector<Status> to;
+};
+
+/**
+ * @brief Read a whole file written by EventLog. Throws std::runtime_error if
+ * the file can not be read or is not in the expected format.
+ *
+ * @param path
+ * @return EventTable
+ */
+EventTable read_event_log(const std::string& path);
+
+}  // namespace griffin
+}  // namespace falciparum
+}  // namespace plasx
+#endif
@@ -0,0 +1,83 @@
+#ifndef PLASX_FALCIPARUM_GRIFFIN_IMMUNITY_HPP
+#define PLASX_FALCIPARUM_GRIFFIN_IMMUNITY_HPP
+/**
+ * @file immunity.hpp
+ * @author Eamon Conway (conway.e@wehi.edu.au)
+ * @brief Boosting and decay of the immunity levels I_CA, I_CM, I_A and I_B.
+ * @version 0.1
+ * @date 2023-05-30
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#include <cstddef>
+
+#include "PlasX/Falciparum/Griffin/parameters.h"
+#include "PlasX/types.hpp"
+namespace plasx {
+namespace falciparum {
+namespace griffin {
+
+inline namespace PLASX_PRECISION_NAMESPACE {
+class Population;
+}  // namespace PLASX_PRECISION_NAMESPACE
+
+/**
+ * @brief Share of each immunity level that remains after some time.
+ *
+ * @details Between boosts every level decays exponentially, dI/dt = -I / d,
+ * with d the matching duration d_C, d_M, d_A or d_B. Over an interval of
+ * length h a level is therefore multiplied by exp(-h / d), whatever h is.
+ */
+struct ImmunityDecay {
+  double I_CA;
+  double I_CM;
+  double I_A;
+  double I_B;
+};
+
+/**
+ * @brief Decay factors over an interval of length elapsed.
+ *
+ * @param params
+ * @param elapsed
+ * @return ImmunityDecay
+ */
+ImmunityDecay immunity_decay(const Parameters& params, const double elapsed);
+
+/**
+ * @brief Decay the immunity of population[begin, end), which is up to date at
+ * t - h, by the factors for h and mark it as up to date at t.
+ *
+ * @param population
+ * @param begin
+ * @param end
+ * @param decay Factors for h, see immunity_decay.
+ * @param t
+ */
+void decay_immunity(Population& population, const std::size_t begin,
+                    const std::size_t end, const ImmunityDecay& decay,
+                    const double t) noexcept;
+
+/**
+ * @brief Bring the immunity of population[begin, end) up to date at time t,
+ * each individual from the time it was last updated.
+ *
+ * @details Individuals that are only visited now and then (e.g. by
+ * EventDriven) can be left alone and caught up in one go when their immunity
+ * is needed.
+ *
+ * @param population
+ * @param begin
+ * @param end
+ * @param params
+ * @param t
+ */
+void catch_up_immunity(Population& population, const std::size_t begin,
+                       const std::size_t end, const Parameters& params,
+                       const double t);
+
+}  // namespace griffin
+}  // namespace falciparum
+}  // namespace plasx
+#endif
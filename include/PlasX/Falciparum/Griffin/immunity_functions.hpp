@@ -0,0 +1,164 @@
+#ifndef PLASX_FALCIPARUM_GRIFFIN_IMMUNITY_FUNCTIONS_HPP
+#define PLASX_FALCIPARUM_GRIFFIN_IMMUNITY_FUNCTIONS_HPP
+/**
+ * @file immunity_functions.hpp
+ * @author Eamon Conway (conway.e@wehi.edu.au)
+ * @brief Tabulated Hill functions and age dependent biting.
+ * @version 0.1
+ * @date 2023-04-27
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+#include "PlasX/Falciparum/Griffin/parameters.h"
+namespace plasx {
+namespace falciparum {
+namespace griffin {
+
+/**
+ * @brief Piecewise linear table of a smooth function on [0, infinity).
+ *
+ * @details The table is uniform in u = x / (x + scale), which maps [0,
+ * infinity) onto [0, 1) and puts half of the knots below scale. This suits
+ * Hill functions of x / scale, which change fastest around x = scale. The
+ * number of knots is doubled until the interpolation error at every midpoint
+ * between knots is at most tolerance times the largest value of |f|, or until
+ * the table would pass about a million knots, in which case converged() is
+ * false.
+ */
+class Tabulated {
+ public:
+  Tabulated() = default;
+
+  /**
+   * @brief Construct a new Tabulated object.
+   *
+   * @param f Function to tabulate.
+   * @param limit Limit of f as x goes to infinity.
+   * @param scale
+   * @param tolerance
+   */
+  Tabulated(const std::function<double(double)>& f, const double limit,
+            const double scale, const double tolerance);
+
+  double operator()(const double x) const noexcept {
+    const auto u = x / (x + scale_);
+    const auto position = u * (values_.size() - 1);
+    // This also sends x = infinity (u is NaN) to the last knot.
+    if (!(position < values_.size() - 1)) {
+      return values_.back();
+    }
+    const auto i = static_cast<std::size_t>(position);
+    const auto w = position - i;
+    return values_[i] + w * (values_[i + 1] - values_[i]);
+  };
+
+  /**
+   * @brief Number of knots in the table.
+   *
+   * @return std::size_t
+   */
+  std::size_t size() const noexcept { return values_.size(); };
+
+  /**
+   * @brief Largest error that was found at the midpoints between knots.
+   *
+   * @return double
+   */
+  double error() const noexcept { return error_; };
+
+  /**
+   * @brief Whether error() is within the tolerance.
+   *
+   * @return bool
+   */
+  bool converged() const noexcept { return converged_; };
+
+ private:
+  std::vector<double> values_;
+  double scale_ = 1.0;
+  double error_ = 0.0;
+  bool converged_ = false;
+};
+
+/**
+ * @brief The immunity dependent functions of the Griffin model, built once
+ * from a set of parameters.
+ *
+ * @details By default these are read from tables (see Tabulated), which
+ * replaces a pow or exp per individual per step with a division and a lookup.
+ * If Parameters::exact_functions is set they are evaluated directly instead,
+ * and so are they if any table cannot meet Parameters::function_tolerance
+ * (see Tabulated).
+ */
+class ImmunityFunctions {
+ public:
+  explicit ImmunityFunctions(const Parameters& params);
+
+  /**
+   * @brief Probability that an infectious bite leads to infection, given
+   * immunity to bites I_B.
+   *
+   * @param I_B
+   * @return double
+   */
+  double b(const double I_B) const noexcept {
+    return exact_ ? exact_b(I_B) : b_(I_B);
+  };
+
+  /**
+   * @brief Probability that an infection is clinical, given clinical immunity
+   * I_C.
+   *
+   * @param I_C
+   * @return double
+   */
+  double phi(const double I_C) const noexcept {
+    return exact_ ? exact_phi(I_C) : phi_(I_C);
+  };
+
+  /**
+   * @brief Rate of recovery from asymptomatic infection, given immunity to
+   * detection I_A.
+   *
+   * @param I_A
+   * @return double
+   */
+  double r_A(const double I_A) const noexcept {
+    return exact_ ? exact_r_A(I_A) : r_A_(I_A);
+  };
+
+  /**
+   * @brief Relative biting rate at a given age.
+   *
+   * @param age
+   * @return double
+   */
+  double psi(const double age) const noexcept {
+    return exact_ ? exact_psi(age) : psi_(age);
+  };
+
+  bool exact() const noexcept { return exact_; };
+
+  double exact_b(const double I_B) const noexcept;
+  double exact_phi(const double I_C) const noexcept;
+  double exact_r_A(const double I_A) const noexcept;
+  double exact_psi(const double age) const noexcept;
+
+ private:
+  Parameters params_;
+  bool exact_;
+  Tabulated b_;
+  Tabulated phi_;
+  Tabulated r_A_;
+  Tabulated psi_;
+};
+
+}  // namespace griffin
+}  // namespace falciparum
+}  // namespace plasx
+#endif
@@ -0,0 +1,126 @@
+#ifndef PLASX_FALCIPARUM_GRIFFIN_INFECTION_POOL_HPP
+#define PLASX_FALCIPARUM_GRIFFIN_INFECTION_POOL_HPP
+/**
+ * @file infection_pool.hpp
+ * @author Eamon Conway (conway.e@wehi.edu.au)
+ * @brief Shared storage for pending infections.
+ * @version 0.1
+ * @date 2023-04-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <vector>
+
+namespace plasx {
+namespace falciparum {
+namespace griffin {
+
+/**
+ * @brief Pool of pending infection times, shared by many individuals.
+ *
+ * @details Every individual stores the time of its next infection inline. Only
+ * the infections after that one live here, as sorted singly linked lists of
+ * nodes in one contiguous array. Each individual holds the index of the head of
+ * its list (or InfectionPool::none). Freed nodes are recycled, so after a short
+ * warm up the pool stops allocating.
+ *
+ * All member functions lock, so one pool can be used from several threads.
+ * They are only called when an individual has more than one pending infection,
+ * which makes contention rare.
+ */
+class InfectionPool {
+ public:
+  using Handle = std::uint32_t;
+  static constexpr Handle none = std::numeric_limits<Handle>::max();
+
+  InfectionPool() = default;
+  InfectionPool(const InfectionPool& other);
+  InfectionPool& operator=(const InfectionPool& other);
+
+  /**
+   * @brief Add an infection at time t to the list starting at head.
+   *
+   * @param head
+   * @param t
+   */
+  void insert(Handle& head, const double t);
+
+  /**
+   * @brief Remove every infection at or before time t from the list starting at
+   * head.
+   *
+   * @param head
+   * @param t
+   * @return double Time of the first remaining infection, or infinity if there
+   * is none.
+   */
+  double pop_until(Handle& head, const double t);
+
+  /**
+   * @brief Return every node in the list starting at head to the pool.
+   *
+   * @param head Set to none.
+   */
+  void release(Handle& head) noexcept;
+
+  /**
+   * @brief Make a copy of the list starting at head.
+   *
+   * @param head
+   * @return Handle Head of the copy.
+   */
+  Handle copy(const Handle head);
+
+  /**
+   * @brief Append the times in the list starting at head to times, in order.
+   *
+   * @param head
+   * @param times
+   */
+  void collect(const Handle head, std::vector<double>& times) const;
+
+  /**
+   * @brief Number of times in the list starting at head.
+   *
+   * @param head
+   * @return std::size_t
+   */
+  std::size_t length(const Handle head) const;
+
+  /**
+   * @brief Number of pending infections currently stored.
+   *
+   * @return std::size_t
+   */
+  std::size_t size() const noexcept { return in_use_; };
+
+  /**
+   * @brief Pool used by individuals that are not part of a Population.
+   *
+   * @return InfectionPool&
+   */
+  static InfectionPool& shared();
+
+ private:
+  struct Node {
+    double time;
+    Handle next;
+  };
+
+  Handle allocate(const double t, const Handle next);
+
+  std::vector<Node> nodes_;
+  Handle free_ = none;
+  std::size_t in_use_ = 0;
+  mutable std::mutex mutex_;
+};
+
+}  // namespace griffin
+}  // namespace falciparum
+}  // namespace plasx
+#endif
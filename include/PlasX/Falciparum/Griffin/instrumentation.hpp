@@ -0,0 +1,120 @@
+#ifndef PLASX_FALCIPARUM_GRIFFIN_INSTRUMENTATION_HPP
+#define PLASX_FALCIPARUM_GRIFFIN_INSTRUMENTATION_HPP
+/**
+ * @file instrumentation.hpp
+ * @author Eamon Conway (conway.e@wehi.edu.au)
+ * @brief Timers and counters of the blocked step, compiled in with
+ * -DPLASX_INSTRUMENT (make INSTRUMENT=1) and out otherwise.
+ * @version 0.1
+ * @date 2023-08-02
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <mutex>
+
+#include "PlasX/Falciparum/griffin.hpp"
+#include "PlasX/perf_counters.hpp"
+namespace plasx {
+namespace falciparum {
+namespace griffin {
+
+/**
+ * @brief Whether the step is instrumented. Everything that fills
+ * Instrumentation is behind if constexpr (instrumented), so without
+ * PLASX_INSTRUMENT none of it is compiled.
+ *
+ */
+#ifdef PLASX_INSTRUMENT
+inline constexpr bool instrumented = true;
+#else
+inline constexpr bool instrumented = false;
+#endif
+
+// Pending infections are counted 0, 1, ..., queue_bins - 2 and more.
+inline constexpr std::size_t queue_bins = 8;
+
+/**
+ * @brief What the update rules did with the individuals of one block, of one
+ * step or of a whole run, by the compartment they started the step in.
+ *
+ */
+struct StepCounters {
+  void merge(const StepCounters& other) noexcept;
+
+  // Individuals updated, and seconds spent updating them.
+  std::array<std::uint64_t, n_status> visits{};
+  std::array<double, n_status> seconds{};
+  // Uniform draws used.
+  std::array<std::uint64_t, n_status> draws{};
+  // transitions[from][to], staying put included, and deaths.
+  std::array<std::array<std::uint64_t, n_status>, n_status> transitions{};
+  std::array<std::uint64_t, n_status> deaths{};
+  // Number of individuals by how many infections they had pending.
+  std::array<std::uint64_t, queue_bins> queue_lengths{};
+};
+
+/**
+ * @brief Totals of every instrumented step of the process.
+ *
+ * @details Each step of OneStep that goes through blocks (with RandomStreams)
+ * adds its wall time and the counters of its blocks once it is done.
+ * Compartment times are summed over the blocks, so across threads they add up
+ * to more than the wall time. Hardware counters are only sampled once
+ * sample_hardware is called, and then only for that thread (see
+ * PerfCounters), i.e. for all of a serial step but only the share of a
+ * threaded one run by the calling thread. Safe to use from several threads.
+ */
+class Instrumentation {
+ public:
+  static Instrumentation& global();
+
+  void add_step(const double seconds, const StepCounters& counters,
+                const PerfCounters::Reading& hardware);
+
+  /**
+   * @brief Sample the hardware counters of the calling thread from now on.
+   *
+   * @return bool Whether they are available.
+   */
+  bool sample_hardware();
+
+  /**
+   * @brief Reading of the hardware counters, all 0 unless sampled.
+   *
+   * @return PerfCounters::Reading
+   */
+  PerfCounters::Reading hardware_now() const noexcept;
+
+  std::uint64_t steps() const;
+  double step_seconds() const;
+  StepCounters counters() const;
+  PerfCounters::Reading hardware() const;
+
+  void reset();
+
+  /**
+   * @brief Write the totals, as comma separated tables.
+   *
+   * @param out
+   */
+  void report(std::ostream& out) const;
+
+ private:
+  mutable std::mutex mutex_;
+  std::uint64_t steps_ = 0;
+  double step_seconds_ = 0.0;
+  StepCounters counters_;
+  PerfCounters::Reading hardware_;
+  std::unique_ptr<PerfCounters> perf_;
+};
+
+}  // namespace griffin
+}  // namespace falciparum
+}  // namespace plasx
+#endif
@@ -0,0 +1,254 @@
+#ifndef PLASX_FALCIPARUM_GRIFFIN_INTERVENTIONS_HPP
+#define PLASX_FALCIPARUM_GRIFFIN_INTERVENTIONS_HPP
+/**
+ * @file interventions.hpp
+ * @author Eamon Conway (conway.e@wehi.edu.au)
+ * @brief Interventions applied to a population at given times during a
+ * simulation: mass drug administration, bednet campaigns and changes to case
+ * management.
+ * @version 0.1
+ * @date 2023-07-27
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "PlasX/Falciparum/Griffin/parameters.h"
+#include "PlasX/Falciparum/griffin.hpp"
+#include "PlasX/random.hpp"
+#include "PlasX/types.hpp"
+namespace plasx {
+namespace falciparum {
+namespace griffin {
+
+inline namespace PLASX_PRECISION_NAMESPACE {
+class Population;
+}  // namespace PLASX_PRECISION_NAMESPACE
+
+/**
+ * @brief Treat a share of the population, whatever their compartment. Those
+ * treated move to T and lose any infection they have pending. Those already
+ * in T or P are left alone.
+ *
+ */
+struct MassDrugAdministration {
+  // Share of those in [min_age, max_age) who are treated.
+  double coverage;
+  double min_age = 0.0;
+  double max_age = std::numeric_limits<double>::infinity();
+};
+
+/**
+ * @brief Hand out bednets, which scale the biting rate zeta of a share of the
+ * population by 1 - efficacy for duration. Anyone who dies in the meantime
+ * loses their net.
+ *
+ * @details A BitingTable handed to Scheduled is rebuilt when a campaign
+ * starts or ends. Call its rebuild if the schedule is applied in any other
+ * way.
+ */
+struct BednetCampaign {
+  double coverage;
+  double efficacy;
+  double duration;
+};
+
+/**
+ * @brief Change the probability f_T that a clinical case is treated, from
+ * then on.
+ *
+ */
+struct CaseManagement {
+  double f_T;
+};
+
+/**
+ * @brief Interventions to apply to a population, each at a given time.
+ *
+ * @details Every intervention is one pass of masked operations over the
+ * columns of the population, with no branch per individual bar the rare one
+ * with more than one pending infection, so the cost of a campaign is bounded
+ * by a few passes over the population. A step with nothing due costs nothing.
+ * Those due in the same step are applied mass drug administration first, then
+ * bednets, then case management, each kind in order of time and then of being
+ * added.
+ *
+ * Individuals are recognised by their place in the population, so it should
+ * not be shuffled while a bednet campaign is running. Throws
+ * std::invalid_argument if an intervention is out of range.
+ *
+ * The changes are made outside of any step, so a Recorder, BitingTable or
+ * EventLog does not see them. Scheduled brings those it hands the step up to
+ * date (see update).
+ */
+class Schedule {
+ public:
+  /**
+   * @brief Construct a new Schedule object
+   *
+   * @param seed Seed of the draws that pick who is covered.
+   */
+  explicit Schedule(std::uint64_t seed = 0) noexcept : rng_(seed){};
+
+  void add(const double time, const MassDrugAdministration& mda);
+  void add(const double time, const BednetCampaign& nets);
+  void add(const double time, const CaseManagement& case_management);
+
+  /**
+   * @brief Apply everything due before t + dt to population, at the start of
+   * the step from t.
+   *
+   * @param t
+   * @param dt
+   * @param population
+   * @return bool Whether anything was applied.
+   */
+  bool apply(const double t, const double dt, Population& population);
+
+  /**
+   * @brief Bring recorder up to date with the most recent apply, by counting
+   * population again if anyone was treated.
+   *
+   * @param t
+   * @param population
+   * @param recorder
+   */
+  void update(const double t, const Population& population,
+              Recorder& recorder) const;
+
+  /**
+   * @brief Bring table up to date with the most recent apply, by rebuilding
+   * it if a bednet campaign started or ended.
+   *
+   * @param t
+   * @param population
+   * @param table
+   */
+  void update(const double t, const Population& population,
+              BitingTable& table) const;
+
+  /**
+   * @brief Log everyone treated by the most recent apply, as a transition to
+   * T at t.
+   *
+   * @param t
+   * @param population
+   * @param log
+   */
+  void update(const double t, const Population& population,
+              EventLog& log) const;
+
+  // Anything else handed to a step is left as it is.
+  template <class Other>
+  void update(const double, const Population&, const Other&) const noexcept {}
+
+  /**
+   * @brief params, with the case management in force.
+   *
+   * @param params
+   * @return const Parameters&
+   */
+  const Parameters& parameters(const Parameters& params);
+
+  /**
+   * @brief Number of interventions, and ends of bednet campaigns, still to
+   * come.
+   *
+   * @return std::size_t
+   */
+  std::size_t pending() const noexcept;
+
+ private:
+  // Items in order of time, and the first that is still due.
+  template <class T>
+  struct Timeline {
+    void add(const double time, const T& item);
+    // Call f on every item due before time, and move past them.
+    template <class F>
+    void due(const double time, F f) {
+      while (next < items.size() && items[next].first < time) {
+        f(items[next++].second);
+      }
+    }
+    std::size_t size() const noexcept { return items.size() - next; };
+
+    std::vector<std::pair<double, T>> items;
+    std::size_t next = 0;
+  };
+
+  // Those covered by a bednet campaign that started at start.
+  struct Nets {
+    double start;
+    double factor;
+    std::vector<std::size_t> covered;
+  };
+
+  void administer(const MassDrugAdministration& mda, Population& population);
+  void distribute(const double t, const BednetCampaign& nets,
+                  Population& population);
+  void withdraw(const double t, const double dt, Nets& nets,
+                Population& population);
+
+  Timeline<MassDrugAdministration> mda_;
+  Timeline<BednetCampaign> nets_;
+  Timeline<CaseManagement> case_management_;
+  // Index into campaigns_ of each campaign, at the time it ends.
+  Timeline<std::size_t> ends_;
+  std::vector<Nets> campaigns_;
+  // What the most recent apply changed: those treated, with the compartment
+  // each was in, and whether any zeta was.
+  std::vector<std::size_t> treated_;
+  std::vector<Status> treated_from_;
+  bool zeta_changed_ = false;
+  std::optional<double> f_T_;
+  Parameters params_;
+  Xoshiro256x4 rng_;
+  std::vector<double> draws_;
+  std::vector<char> covered_;
+  std::vector<Status> before_;
+};
+
+/**
+ * @brief A step function that applies a Schedule at the start of every step,
+ * for use with plasx::simulation, e.g.
+ *
+ *   plasx::simulation(t0, t1, dt, Scheduled(one_step, schedule), population,
+ *                     params, eir, streams);
+ *
+ * @details The step is handed params with the case management of the
+ * schedule, and the rest of the arguments as they are. A Recorder,
+ * BitingTable or EventLog among them is brought up to date with whatever the
+ * schedule applied before the step (see Schedule::update).
+ *
+ * @tparam Step
+ */
+template <class Step>
+class Scheduled {
+ public:
+  Scheduled(Step step, Schedule& schedule) : step_(step), schedule_(schedule){};
+
+  template <class... Args>
+  double operator()(const double t, const double dt, Population& population,
+                    const Parameters& params, Args&&... args) const {
+    if (schedule_.apply(t, dt, population)) {
+      (schedule_.update(t, population, args), ...);
+    }
+    return step_(t, dt, population, schedule_.parameters(params),
+                 std::forward<Args>(args)...);
+  }
+
+ private:
+  Step step_;
+  Schedule& schedule_;
+};
+
+}  // namespace griffin
+}  // namespace falciparum
+}  // namespace plasx
+#endif
@@ -0,0 +1,126 @@
+#ifndef PLASX_FALCIPARUM_GRIFFIN_METAPOPULATION_HPP
+#define PLASX_FALCIPARUM_GRIFFIN_METAPOPULATION_HPP
+/**
+ * @file metapopulation.hpp
+ * @author Eamon Conway (conway.e@wehi.edu.au)
+ * @brief Populations spread over many patches, with migration between them.
+ * @version 0.1
+ * @date 2023-06-20
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "PlasX/Falciparum/Griffin/mosquito.hpp"
+#include "PlasX/Falciparum/Griffin/population.hpp"
+#include "PlasX/random.hpp"
+#include "PlasX/thread_pool.hpp"
+#include "PlasX/types.hpp"
+namespace plasx {
+namespace falciparum {
+namespace griffin {
+
+inline namespace PLASX_PRECISION_NAMESPACE {
+
+/**
+ * @brief A village, district or any other place with a population of its own.
+ *
+ */
+struct Patch {
+  Population population;
+  // EIR in the patch, used when it has no mosquitoes of its own.
+  double eir = 0.0;
+  std::optional<Mosquitoes> mosquitoes;
+};
+
+/**
+ * @brief Set of patches that are stepped independently and exchange migrants
+ * between steps.
+ *
+ * @details A step of a Metapopulation (see OneStep) has two phases. First
+ * every patch is stepped on its own, with the blocked step of OneStep and a
+ * RandomStreams of its own, one patch per task of the ThreadPool. The largest
+ * patches are handed out first so that a single big district does not hold up
+ * the end of the step. Then migrants are exchanged: each patch picks out the
+ * people who leave it and copies them out, every patch takes in its arrivals
+ * from those copies, and finally the leavers are removed. Each of these is
+ * again one task per patch, no task reads what another is writing, and nothing
+ * depends on which thread ran which task, so the result does not depend on the
+ * number of threads.
+ *
+ * Migration is a permanent move. Short trips, where someone is bitten away
+ * from home, are not modelled.
+ */
+class Metapopulation {
+ public:
+  /**
+   * @brief Construct a new Metapopulation object.
+   *
+   * @param patches
+   * @param migration Row major matrix, migration[i * n + j] is the rate (per
+   * day) at which each person in patch i moves to patch j. The diagonal is
+   * ignored.
+   * @param seed Patch p is stepped with the streams of
+   * RandomStreams(seed).key(0, p), and migrants are drawn from those of
+   * RandomStreams(seed).key(1, 0).
+   */
+  Metapopulation(std::vector<Patch> patches, std::vector<double> migration,
+                 const std::uint64_t seed);
+
+  /**
+   * @brief Step every patch from t to t + dt, then exchange migrants.
+   *
+   * @param t
+   * @param dt
+   * @param params
+   * @param pool
+   */
+  void step(const double t, const double dt, const Parameters& params,
+            ThreadPool& pool);
+
+  std::vector<Patch>& patches() noexcept { return patches_; };
+  const std::vector<Patch>& patches() const noexcept { return patches_; };
+
+  /**
+   * @brief Total number of people over every patch.
+   *
+   * @return std::size_t
+   */
+  std::size_t size() const noexcept;
+
+  /**
+   * @brief Number of people that have moved between patches so far.
+   *
+   * @return std::size_t
+   */
+  std::size_t migrants() const noexcept { return migrants_; };
+
+ private:
+  struct Migrant {
+    std::size_t index;
+    std::size_t destination;
+  };
+
+  void exchange(const double dt, ThreadPool& pool);
+
+  std::vector<Patch> patches_;
+  std::vector<double> migration_;
+  std::vector<RandomStreams> streams_;
+  RandomStreams migration_streams_;
+  // Leavers from each patch, in increasing order of index, and copies of them
+  // in the same order.
+  std::vector<std::vector<Migrant>> leaving_;
+  std::vector<Population> departed_;
+  std::size_t migrants_ = 0;
+};
+
+}  // namespace PLASX_PRECISION_NAMESPACE
+
+}  // namespace griffin
+}  // namespace falciparum
+}  // namespace plasx
+#endif
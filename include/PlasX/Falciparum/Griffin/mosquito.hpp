@@ -0,0 +1,192 @@
+#ifndef PLASX_FALCIPARUM_GRIFFIN_MOSQUITO_HPP
+#define PLASX_FALCIPARUM_GRIFFIN_MOSQUITO_HPP
+/**
+ * @file mosquito.hpp
+ * @author Eamon Conway (conway.e@wehi.edu.au)
+ * @brief Mosquito population coupled to the human population of the Griffin
+ * model.
+ * @version 0.1
+ * @date 2023-06-13
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#include <array>
+#include <cstddef>
+#include <deque>
+
+#include "PlasX/Falciparum/griffin.hpp"
+namespace plasx {
+namespace falciparum {
+namespace griffin {
+
+/**
+ * @brief Parameters of the mosquito population, and of how infectious each
+ * human compartment is to a biting mosquito. Rates are per day.
+ *
+ */
+class MosquitoParameters {
+ public:
+  MosquitoParameters();
+
+  bool operator==(const MosquitoParameters&) const = default;
+
+  // Bites taken on humans per mosquito per day.
+  double a;
+  // Death rate of adult mosquitoes.
+  double mu_m;
+  // Extrinsic incubation period, from infection to infectious.
+  double tau_m;
+
+  // Probability that a bite infects the mosquito, by compartment. Detection
+  // immunity is not modelled, so c_A is a constant rather than a function of
+  // the probability of detection.
+  double c_D;
+  double c_A;
+  double c_U;
+  double c_T;
+};
+
+/**
+ * @brief Relative biting rate psi(age) * zeta of the human population, summed
+ * by compartment.
+ *
+ * @details The step functions fill one of these in the same pass that updates
+ * the individuals, one per block when run in parallel, so coupling the humans
+ * to the mosquitoes never needs a sweep of its own.
+ */
+class Infectiousness {
+ public:
+  void add(const double weight, const Status status) noexcept {
+    weight_[static_cast<std::size_t>(status)] += weight;
+  };
+
+  void merge(const Infectiousness& other) noexcept {
+    for (std::size_t s = 0; s < n_status; ++s) {
+      weight_[s] += other.weight_[s];
+    }
+  };
+
+  double weight(const Status status) const noexcept {
+    return weight_[static_cast<std::size_t>(status)];
+  };
+
+  /**
+   * @brief Probability that a bite taken at random, in proportion to the
+   * biting rate, infects the mosquito. 0 for an empty population.
+   *
+   * @param params
+   * @return double
+   */
+  double kappa(const MosquitoParameters& params) const noexcept;
+
+ private:
+  std::array<double, n_status> weight_{};
+};
+
+/**
+ * @brief Susceptible, incubating and infectious mosquitoes, as densities per
+ * human.
+ *
+ * @details Mosquitoes are born susceptible at rate mu_m * m, so the total m
+ * stays fixed, and are infected at rate a * kappa while susceptible. The
+ * extrinsic incubation period is a fixed delay tau_m, as in Griffin et al., so
+ * the incubating mosquitoes are held as cohorts that each become infectious
+ * tau_m after they were infected. Over a step kappa is held constant and the
+ * equations are solved exactly.
+ *
+ * The EIR faced by the humans is a times the density of infectious
+ * mosquitoes. OneStep uses the EIR at the start of a step, and steps the
+ * mosquitoes with the infectiousness of the humans at the end of it.
+ *
+ * The state is parameters(), m(), S(), I(), foi() and cohorts(), and the
+ * second constructor rebuilds the mosquitoes from it exactly (see
+ * save_snapshot).
+ */
+class Mosquitoes {
+ public:
+  /**
+   * @brief Mosquitoes infected together, that are still incubating.
+   *
+   */
+  struct Cohort {
+    // Time left before the cohort becomes infectious.
+    double incubating;
+    double size;
+
+    bool operator==(const Cohort&) const = default;
+  };
+
+  /**
+   * @brief Mosquitoes at equilibrium with a human population of constant
+   * infectiousness kappa.
+   *
+   * @param params
+   * @param m Mosquitoes per human.
+   * @param kappa See Infectiousness::kappa.
+   */
+  Mosquitoes(const MosquitoParameters& params, const double m,
+             const double kappa);
+
+  /**
+   * @brief Mosquitoes in a given state, e.g. one that was saved.
+   *
+   * @param params
+   * @param m Mosquitoes per human.
+   * @param S
+   * @param I
+   * @param foi Force of infection over the last step.
+   * @param cohorts Incubating cohorts, oldest first.
+   */
+  Mosquitoes(const MosquitoParameters& params, const double m, const double S,
+             const double I, const double foi, std::deque<Cohort> cohorts);
+
+  /**
+   * @brief Advance the mosquitoes from t to t + dt.
+   *
+   * @param dt
+   * @param humans Infectiousness of the humans over the step.
+   */
+  void step(const double dt, const Infectiousness& humans);
+
+  /**
+   * @brief Entomological inoculation rate, infectious bites per human per day.
+   *
+   * @return double
+   */
+  double eir() const noexcept { return params_.a * I_; };
+
+  /**
+   * @brief Force of infection on susceptible mosquitoes over the last step.
+   *
+   * @return double
+   */
+  double foi() const noexcept { return foi_; };
+
+  double S() const noexcept { return S_; };
+  double E() const noexcept;
+  double I() const noexcept { return I_; };
+  double m() const noexcept { return m_; };
+  const MosquitoParameters& parameters() const noexcept { return params_; };
+
+  /**
+   * @brief Incubating cohorts, oldest first.
+   *
+   * @return const std::deque<Cohort>&
+   */
+  const std::deque<Cohort>& cohorts() const noexcept { return cohorts_; };
+
+ private:
+  MosquitoParameters params_;
+  double m_;
+  double S_;
+  double I_;
+  double foi_;
+  // Oldest cohort first.
+  std::deque<Cohort> cohorts_;
+};
+
+}  // namespace griffin
+}  // namespace falciparum
+}  // namespace plasx
+#endif
@@ -0,0 +1,80 @@
+#ifndef PLASX_FALCIPARUM_GRIFFIN_PARAMETER_FILE_HPP
+#define PLASX_FALCIPARUM_GRIFFIN_PARAMETER_FILE_HPP
+/**
+ * @file parameter_file.hpp
+ * @author Eamon Conway (conway.e@wehi.edu.au)
+ * @brief Read the parameters of the Griffin model from a file at run time.
+ * @version 0.1
+ * @date 2023-07-11
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#include <iosfwd>
+#include <string>
+
+#include "PlasX/Falciparum/Griffin/mosquito.hpp"
+#include "PlasX/Falciparum/Griffin/parameters.h"
+namespace plasx {
+namespace falciparum {
+namespace griffin {
+
+/**
+ * @brief Every parameter of a simulation: the humans and the mosquitoes.
+ *
+ */
+struct ParameterSet {
+  bool operator==(const ParameterSet&) const = default;
+
+  Parameters human;
+  MosquitoParameters mosquito;
+};
+
+/**
+ * @brief Read a ParameterSet from a parameter file.
+ *
+ * @details A parameter file has one parameter per line, `name = value unit`,
+ * named as the members of Parameters. Everything after a # is a comment. The
+ * parameters of the mosquitoes follow a `[mosquito]` line, and those of the
+ * humans may be put after a `[human]` line. Anything not given keeps its
+ * default.
+ *
+ * Every value is checked against the dimension of its parameter:
+ * - durations (age_0, d_A, ..., tau_m) need a unit of days or yrs,
+ * - rates (mu_d, r_T, ..., a, mu_m) need a unit of /days or /yrs,
+ * - everything else takes no unit, and probabilities must be in [0, 1],
+ * - exact_functions is true or false.
+ * A year is 365 days, as in udl.hpp. Everything is stored in days.
+ *
+ * Throws std::invalid_argument, naming the line, for an unknown or repeated
+ * parameter, a missing or wrong unit, or a value out of range.
+ *
+ * @param in
+ * @param name Name of the input, used in error messages.
+ * @return ParameterSet
+ */
+ParameterSet read_parameters(std::istream& in,
+                             const std::string& name = "<input>");
+
+/**
+ * @brief Read a ParameterSet from the parameter file at path. Throws
+ * std::runtime_error if it can not be opened.
+ *
+ * @param path
+ * @return ParameterSet
+ */
+ParameterSet load_parameters(const std::string& path);
+
+/**
+ * @brief Write every parameter in the format read by read_parameters, with
+ * enough digits that it is read back exactly.
+ *
+ * @param out
+ * @param parameters
+ */
+void write_parameters(std::ostream& out, const ParameterSet& parameters);
+
+}  // namespace griffin
+}  // namespace falciparum
+}  // namespace plasx
+#endif
@@ -7,8 +7,11 @@ namespace griffin {
 class Parameters {
  private:
  public:
-  Parameters();  // Constructor function. Will probably just read in parameters
-                 // from file.
+  // The default values. To read them from a file instead, see
+  // load_parameters in parameter_file.hpp.
+  Parameters();
+
+  bool operator==(const Parameters&) const = default;
 
   // Death rate (1/average age)
   double mu_d;
@@ -50,6 +53,12 @@ class Parameters {
   // This one.
   double w_A;
 
+  // Evaluate the immunity functions and psi exactly, rather than from tables
+  // (see immunity_functions.hpp).
+  bool exact_functions;
+  // Largest error allowed in the tables, relative to the largest value.
+  double function_tolerance;
+
   // Currently a class (possibility that we are sampling here).
 };
 
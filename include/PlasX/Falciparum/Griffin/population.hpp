@@ -0,0 +1,191 @@
+#ifndef PLASX_FALCIPARUM_GRIFFIN_POPULATION_HPP
+#define PLASX_FALCIPARUM_GRIFFIN_POPULATION_HPP
+/**
+ * @file population.hpp
+ * @author Eamon Conway (conway.e@wehi.edu.au)
+ * @brief Column oriented (structure of arrays) storage for the Griffin model.
+ * @version 0.1
+ * @date 2023-04-12
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#include <cstddef>
+#include <vector>
+
+#include "PlasX/Falciparum/Griffin/infection_pool.hpp"
+#include "PlasX/Falciparum/griffin.hpp"
+#include "PlasX/types.hpp"
+namespace plasx {
+namespace falciparum {
+namespace griffin {
+
+inline namespace PLASX_PRECISION_NAMESPACE {
+
+/**
+ * @brief Population of individuals stored as one contiguous array per
+ * variable.
+ *
+ * @details This holds exactly the same information as a
+ * std::vector<Individual<PFalc>>, but the step function only has to stream
+ * through a handful of flat arrays. The time of the next pending infection is
+ * stored inline, so the common case (no pending infection) never leaves the
+ * next_infection_ array. Any further pending infections are kept in a pool
+ * owned by the population, which is only touched when an individual has more
+ * than one infection scheduled. Age, immunity and zeta are stored as
+ * StateType, so in a single precision build they are rounded to float.
+ */
+class Population {
+ public:
+  /**
+   * @brief Lightweight handle to a single individual in the population. It
+   * exposes the same interface as PFalc, so the update functions in the
+   * Griffin model can be used on either layout.
+   *
+   */
+  class Agent {
+   public:
+    Agent(Population& population, std::size_t index) noexcept
+        : current_(population.current_[index]),
+          population_(population),
+          index_(index){};
+
+    void clearInfectionQueue() noexcept;
+    void scheduleInfection(const double t);
+    bool updateInfection(const double t);
+
+    void boostBiteImmunity() noexcept { population_.I_B_[index_] += 1.0; };
+    void boostInfectionImmunity() noexcept {
+      population_.I_CA_[index_] += 1.0;
+      population_.I_A_[index_] += 1.0;
+    };
+
+    double getIC() const noexcept {
+      return population_.I_CA_[index_] + population_.I_CM_[index_];
+    };
+    double getIA() const noexcept { return population_.I_A_[index_]; };
+    double getIB() const noexcept { return population_.I_B_[index_]; };
+    double getZeta() const noexcept { return population_.zeta_[index_]; };
+
+    /**
+     * @brief Current state of the individual.
+     *
+     */
+    Status& current_;
+
+   private:
+    Population& population_;
+    std::size_t index_;
+  };
+
+  /**
+   * @brief Reserve storage for n individuals in every column.
+   *
+   * @param n
+   */
+  void reserve(const std::size_t n);
+
+  /**
+   * @brief Add an individual to the end of the population. The arguments
+   * mirror the constructor of Individual<PFalc>.
+   *
+   * @param age
+   * @param status
+   * @param ICA
+   * @param ICM
+   * @param IA
+   */
+  void emplace_back(double age, const Status& status, double ICA, double ICM,
+                    double IA);
+
+  /**
+   * @brief Add a copy of other's individual at index to the end of the
+   * population, including any infections they have pending.
+   *
+   * @param other
+   * @param index
+   */
+  void append(const Population& other, const std::size_t index);
+
+  /**
+   * @brief Replace the individual stored at index with a new one, e.g. a
+   * newborn taking the place of someone who died. The other arguments are the
+   * same as for emplace_back, along with their relative biting rate (see
+   * draw_zeta).
+   *
+   * @param index
+   * @param age
+   * @param status
+   * @param ICA
+   * @param ICM
+   * @param IA
+   * @param zeta
+   */
+  void assign(const std::size_t index, double age, const Status& status,
+              double ICA, double ICM, double IA, double zeta) noexcept;
+
+  /**
+   * @brief Move the individual stored at index from into index to. The
+   * contents of from are left in a valid but unspecified state.
+   *
+   * @param from
+   * @param to
+   */
+  void relocate(const std::size_t from, const std::size_t to) noexcept;
+
+  /**
+   * @brief Shrink the population to the first n individuals.
+   *
+   * @param n
+   */
+  void truncate(const std::size_t n);
+
+  /**
+   * @brief Grow or shrink the population to n individuals. Any new ones are
+   * newborns in S with no immunity, to be filled in place (e.g. with assign,
+   * from several threads).
+   *
+   * @param n
+   */
+  void resize(const std::size_t n);
+
+  std::size_t size() const noexcept { return current_.size(); };
+  const InfectionPool& pool() const noexcept { return pool_; };
+  Agent operator[](const std::size_t index) noexcept {
+    return Agent(*this, index);
+  };
+
+  std::vector<StateType> age_;
+  std::vector<Status> current_;
+  std::vector<StateType> I_CA_;
+  std::vector<StateType> I_CM_;
+  std::vector<StateType> I_A_;
+  std::vector<StateType> I_B_;
+  std::vector<StateType> zeta_;
+  std::vector<double> next_infection_;
+
+  /**
+   * @brief Time that the age and immunity of each individual were last brought
+   * up to date (see turnover.hpp), or NaN if they are up to date whenever
+   * first asked.
+   *
+   */
+  std::vector<double> updated_;
+
+  /**
+   * @brief Head of each individual's list of infections scheduled after
+   * next_infection_, or InfectionPool::none.
+   *
+   */
+  std::vector<InfectionPool::Handle> overflow_;
+
+ private:
+  InfectionPool pool_;
+};
+
+}  // namespace PLASX_PRECISION_NAMESPACE
+
+}  // namespace griffin
+}  // namespace falciparum
+}  // namespace plasx
+#endif
@@ -0,0 +1,229 @@
+#ifndef PLASX_FALCIPARUM_GRIFFIN_RECORDER_HPP
+#define PLASX_FALCIPARUM_GRIFFIN_RECORDER_HPP
+/**
+ * @file recorder.hpp
+ * @author Eamon Conway (conway.e@wehi.edu.au)
+ * @brief Compartment counts and incidence by age band, kept up to date by the
+ * step function.
+ * @version 0.1
+ * @date 2023-05-02
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "PlasX/Falciparum/griffin.hpp"
+#include "PlasX/column_writer.hpp"
+#include "PlasX/individual.hpp"
+#include "PlasX/types.hpp"
+namespace plasx {
+namespace falciparum {
+namespace griffin {
+
+inline namespace PLASX_PRECISION_NAMESPACE {
+class Population;
+}  // namespace PLASX_PRECISION_NAMESPACE
+
+/**
+ * @brief Everything that happened over (part of) one step, by age band.
+ *
+ * @details The step function fills one of these per block of individuals and
+ * merges them, so no counter is ever shared between threads.
+ */
+class Tally {
+ public:
+  Tally() = default;
+  explicit Tally(const std::size_t bands) { reset(bands); };
+
+  /**
+   * @brief Zero every counter and resize for the given number of age bands.
+   *
+   * @param bands
+   */
+  void reset(const std::size_t bands);
+
+  /**
+   * @brief An infection became active and sent the individual to outcome.
+   * Infections that end in D or T are clinical.
+   *
+   * @param band
+   * @param outcome
+   */
+  void infection(const std::size_t band, const Status outcome) noexcept {
+    ++infections_[band];
+    clinical_[band] += outcome == Status::D || outcome == Status::T;
+  };
+
+  void transition(const std::size_t band, const Status from,
+                  const Status to) noexcept {
+    --change_[band * n_status + static_cast<std::size_t>(from)];
+    ++change_[band * n_status + static_cast<std::size_t>(to)];
+  };
+
+  void death(const std::size_t band, const Status from) noexcept {
+    --change_[band * n_status + static_cast<std::size_t>(from)];
+    ++deaths_[band];
+  };
+
+  /**
+   * @brief A newborn joined the population, in S.
+   *
+   * @param band
+   */
+  void birth(const std::size_t band) noexcept {
+    ++change_[band * n_status + static_cast<std::size_t>(Status::S)];
+  };
+
+  /**
+   * @brief An individual aged from one band into the next.
+   *
+   * @param from
+   * @param to
+   * @param status
+   */
+  void aged(const std::size_t from, const std::size_t to,
+            const Status status) noexcept {
+    --change_[from * n_status + static_cast<std::size_t>(status)];
+    ++change_[to * n_status + static_cast<std::size_t>(status)];
+  };
+
+  /**
+   * @brief Add the counts of other to this.
+   *
+   * @param other
+   */
+  void merge(const Tally& other);
+
+  // Net change in the number of individuals in each (band, status).
+  std::vector<std::int64_t> change_;
+  std::vector<std::uint64_t> infections_;
+  std::vector<std::uint64_t> clinical_;
+  std::vector<std::uint64_t> deaths_;
+};
+
+/**
+ * @brief Keeps the number of individuals in each Status, and the infections,
+ * clinical cases and deaths in each step, for a set of age bands.
+ *
+ * @details Pass a Recorder to one_step (see OneStep). The population is
+ * counted once, the first time the recorder is used. After that the counts are
+ * only changed by the transitions that happen inside the step, so there is
+ * never a second pass over the population. Call count() again if the
+ * population is changed outside of one_step.
+ *
+ * If a path is given, a row is written at the end of every step through a
+ * ColumnWriter: the time t, then for each band b the columns S[b], A[b], U[b],
+ * D[b], T[b], P[b], infections[b], clinical[b] and deaths[b].
+ */
+class Recorder {
+ public:
+  /**
+   * @brief Construct a new Recorder object.
+   *
+   * @param band_edges Lower edge of each age band (in days), in increasing
+   * order. The first should be 0.
+   * @param path File to write to. Nothing is written if this is empty.
+   * @param chunk_rows Number of steps buffered before writing.
+   */
+  explicit Recorder(std::vector<double> band_edges = {0.0},
+                    const std::string& path = "",
+                    std::size_t chunk_rows = 1024);
+
+  /**
+   * @brief Age band that age falls in.
+   *
+   * @param age
+   * @return std::size_t
+   */
+  std::size_t band(const double age) const noexcept;
+
+  std::size_t bands() const noexcept { return edges_.size(); };
+
+  /**
+   * @brief Count the population from scratch.
+   *
+   * @param population
+   */
+  void count(const Population& population);
+  void count(const std::vector<Individual<PFalc>>& population);
+  // The binned are counted in S, by the band of their bin's mean age.
+  void count(const HybridPopulation& population);
+
+  bool counted() const noexcept { return counted_; };
+
+  /**
+   * @brief Apply the events of a step that ended at time t, and write a row.
+   *
+   * @param t
+   * @param tally
+   */
+  void end_step(const double t, const Tally& tally);
+
+  /**
+   * @brief Number of individuals in band with the given status.
+   *
+   * @param band
+   * @param status
+   * @return std::uint64_t
+   */
+  std::uint64_t count(const std::size_t band, const Status status) const {
+    return counts_[band * n_status + static_cast<std::size_t>(status)];
+  };
+
+  /**
+   * @brief Number of individuals with the given status, over all bands.
+   *
+   * @param status
+   * @return std::uint64_t
+   */
+  std::uint64_t total(const Status status) const;
+
+  /**
+   * @brief Events in the most recent step.
+   *
+   * @return const Tally&
+   */
+  const Tally& last_step() const noexcept { return last_; };
+
+  /**
+   * @brief Names of the columns written for the given number of bands.
+   *
+   * @param bands
+   * @return std::vector<std::string>
+   */
+  static std::vector<std::string> column_names(const std::size_t bands);
+
+  /**
+   * @brief Fill row with the current counts and the events of the last step,
+   * in the order of column_names.
+   *
+   * @param t
+   * @param row
+   */
+  void fill_row(const double t, double* row) const;
+
+  /**
+   * @brief Write out any buffered rows.
+   *
+   */
+  void flush();
+
+ private:
+  std::vector<double> edges_;
+  std::vector<std::uint64_t> counts_;
+  Tally last_;
+  bool counted_ = false;
+  std::unique_ptr<ColumnWriter> writer_;
+  std::vector<double> row_;
+};
+
+}  // namespace griffin
+}  // namespace falciparum
+}  // namespace plasx
+#endif
@@ -0,0 +1,149 @@
+#ifndef PLASX_FALCIPARUM_GRIFFIN_SNAPSHOT_HPP
+#define PLASX_FALCIPARUM_GRIFFIN_SNAPSHOT_HPP
+/**
+ * @file snapshot.hpp
+ * @author Eamon Conway (conway.e@wehi.edu.au)
+ * @brief Save the full state of a Griffin simulation and restart from it.
+ * @version 0.1
+ * @date 2023-05-09
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "PlasX/Falciparum/Griffin/mosquito.hpp"
+#include "PlasX/Falciparum/Griffin/parameters.h"
+#include "PlasX/Falciparum/griffin.hpp"
+#include "PlasX/individual.hpp"
+#include "PlasX/random.hpp"
+#include "PlasX/types.hpp"
+namespace plasx {
+namespace falciparum {
+namespace griffin {
+
+inline namespace PLASX_PRECISION_NAMESPACE {
+class Population;
+}  // namespace PLASX_PRECISION_NAMESPACE
+
+/**
+ * @brief Write the state of a simulation to path: the time t, every individual
+ * (including all their pending infections), the parameters, the state of
+ * plasx::generator and, if given, the position of streams and the state of
+ * the mosquitoes the population is coupled to.
+ *
+ * @details The file holds one array per variable, each aligned to 64 bytes,
+ * so that a Snapshot can map it and copy the arrays straight out.
+ *
+ * @param path
+ * @param t
+ * @param population
+ * @param params
+ * @param streams
+ * @param mosquitoes
+ */
+void save_snapshot(const std::string& path, const double t,
+                   const Population& population, const Parameters& params,
+                   const RandomStreams* streams = nullptr,
+                   const Mosquitoes* mosquitoes = nullptr);
+void save_snapshot(const std::string& path, const double t,
+                   const std::vector<Individual<PFalc>>& population,
+                   const Parameters& params,
+                   const RandomStreams* streams = nullptr,
+                   const Mosquitoes* mosquitoes = nullptr);
+
+/**
+ * @brief Read-only view of a file written by save_snapshot.
+ *
+ * @details The file is memory mapped, so opening it costs nothing and the
+ * pages are shared between every process that opens the same snapshot. A
+ * burned in equilibrium can be saved once and then restored any number of
+ * times, e.g. once for each intervention scenario.
+ *
+ * Throws std::runtime_error if the file can not be read, was written by an
+ * incompatible build or is truncated or corrupt.
+ */
+class Snapshot {
+ public:
+  explicit Snapshot(const std::string& path);
+  Snapshot(const Snapshot&) = delete;
+  Snapshot& operator=(const Snapshot&) = delete;
+  Snapshot(Snapshot&& other) noexcept;
+  Snapshot& operator=(Snapshot&& other) noexcept;
+  ~Snapshot();
+
+  /**
+   * @brief Time of the simulation when the snapshot was taken.
+   *
+   * @return double
+   */
+  double time() const noexcept;
+
+  /**
+   * @brief Number of individuals in the snapshot.
+   *
+   * @return std::size_t
+   */
+  std::size_t size() const noexcept;
+
+  Parameters parameters() const;
+
+  /**
+   * @brief Random streams as they were when saved, if any were given.
+   *
+   * @return std::optional<RandomStreams>
+   */
+  std::optional<RandomStreams> streams() const;
+
+  /**
+   * @brief Mosquitoes as they were when saved, if any were given. Stepping
+   * them on from here is the same as stepping the saved ones.
+   *
+   * @return std::optional<Mosquitoes>
+   */
+  std::optional<Mosquitoes> mosquitoes() const;
+
+  /**
+   * @brief Replace the contents of population with the saved individuals.
+   *
+   * @param population
+   */
+  void restore(Population& population) const;
+  void restore(std::vector<Individual<PFalc>>& population) const;
+
+  /**
+   * @brief Replace the contents of population with the saved individuals
+   * [begin, end). Only those pages of the file are read. Throws
+   * std::out_of_range unless begin <= end <= size().
+   *
+   * @param population
+   * @param begin
+   * @param end
+   */
+  void restore(Population& population, const std::size_t begin,
+               const std::size_t end) const;
+
+  /**
+   * @brief Put the generator back in its saved state.
+   *
+   * @param engine
+   */
+  void restore_generator(std::default_random_engine& engine = generator) const;
+
+ private:
+  template <class T>
+  const T* section(const std::size_t index) const noexcept;
+
+  const unsigned char* data_ = nullptr;
+  std::size_t bytes_ = 0;
+};
+
+}  // namespace griffin
+}  // namespace falciparum
+}  // namespace plasx
+#endif
@@ -0,0 +1,111 @@
+#ifndef PLASX_FALCIPARUM_GRIFFIN_TURNOVER_HPP
+#define PLASX_FALCIPARUM_GRIFFIN_TURNOVER_HPP
+/**
+ * @file turnover.hpp
+ * @author Eamon Conway (conway.e@wehi.edu.au)
+ * @brief Births, ageing and maternal immunity.
+ * @version 0.1
+ * @date 2023-06-06
+ *
+ * @details The population has a fixed size. Every individual that dies is
+ * replaced, in the same slot, by a newborn in S. Nothing is ever erased, so no
+ * individual has to move when someone dies.
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#include <cstddef>
+
+#include "PlasX/Falciparum/Griffin/parameters.h"
+#include "PlasX/types.hpp"
+namespace plasx {
+namespace falciparum {
+namespace griffin {
+
+inline namespace PLASX_PRECISION_NAMESPACE {
+class Population;
+}  // namespace PLASX_PRECISION_NAMESPACE
+
+/**
+ * @brief Ages (in days) of the mothers that newborns take their maternal
+ * immunity from, [maternal_age_min, maternal_age_max).
+ *
+ */
+inline constexpr double maternal_age_min = 15.0 * 365.0;
+inline constexpr double maternal_age_max = 35.0 * 365.0;
+
+/**
+ * @brief Running mean of the clinical immunity I_CA of women of child bearing
+ * age.
+ *
+ * @details A newborn starts with maternal immunity I_CM = P_M * the mean I_CA
+ * of the mothers. Everyone in the age range counts, as the model does not
+ * track sex.
+ */
+class Mothers {
+ public:
+  Mothers() = default;
+  Mothers(const double sum, const std::size_t count) noexcept
+      : sum_(sum), count_(count){};
+
+  void add(const double age, const double ICA) noexcept {
+    const auto mother = age >= maternal_age_min && age < maternal_age_max;
+    sum_ += mother ? ICA : 0.0;
+    count_ += mother;
+  };
+
+  void merge(const Mothers& other) noexcept {
+    sum_ += other.sum_;
+    count_ += other.count_;
+  };
+
+  /**
+   * @brief Maternal immunity of a newborn, or 0 if there are no mothers.
+   *
+   * @param params
+   * @return double
+   */
+  double newborn_ICM(const Parameters& params) const noexcept {
+    return count_ == 0 ? 0.0 : params.P_M * sum_ / count_;
+  };
+
+  // Sum of I_CA over, and number of, the mothers.
+  double sum() const noexcept { return sum_; };
+  std::size_t count() const noexcept { return count_; };
+
+ private:
+  double sum_ = 0.0;
+  std::size_t count_ = 0;
+};
+
+/**
+ * @brief Replace the individual at index with a newborn, whose age and
+ * immunity are up to date at time t.
+ *
+ * @param population
+ * @param index
+ * @param ICM Maternal immunity, see Mothers.
+ * @param t
+ * @param zeta The newborn's own relative biting rate, see draw_zeta.
+ */
+void give_birth(Population& population, const std::size_t index,
+                const double ICM, const double t, const double zeta) noexcept;
+
+/**
+ * @brief Bring the age and immunity of population[begin, end) up to date at
+ * time t, each individual from the time it was last updated (see
+ * catch_up_immunity).
+ *
+ * @param population
+ * @param begin
+ * @param end
+ * @param params
+ * @param t
+ */
+void catch_up(Population& population, const std::size_t begin,
+              const std::size_t end, const Parameters& params, const double t);
+
+}  // namespace griffin
+}  // namespace falciparum
+}  // namespace plasx
+#endif
@@ -0,0 +1,487 @@
+#ifndef PLASX_FALCIPARUM_GRIFFIN_UPDATE_HPP
+#define PLASX_FALCIPARUM_GRIFFIN_UPDATE_HPP
+/**
+ * @file update.hpp
+ * @author Eamon Conway (conway.e@wehi.edu.au)
+ * @brief Update rules for a single individual in the Griffin model.
+ * @version 0.1
+ * @date 2023-05-23
+ *
+ * @details These are shared by every step function in griffin.cpp. They only
+ * live in a header so that they can be benchmarked on their own.
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+
+#include "PlasX/Falciparum/Griffin/immunity_functions.hpp"
+#include "PlasX/Falciparum/Griffin/parameters.h"
+#include "PlasX/Falciparum/Griffin/recorder.hpp"
+#include "PlasX/Falciparum/griffin.hpp"
+namespace plasx {
+namespace falciparum {
+namespace griffin {
+
+// Delay between bite and infection.
+inline auto delay = 0.0;
+
+// Probability that an individual stays in its compartment over one step, and
+// the share of departures that are deaths.
+struct Exit {
+  double survival;
+  double death_share;
+};
+
+inline Exit make_exit(const double rate, const double mu_d, const double dt) {
+  const auto prob_event = rate + mu_d;
+  return {std::exp(-dt * prob_event), mu_d / prob_event};
+}
+
+/**
+ * @brief Everything the update rules need that only depends on the parameters
+ * and the length of the step, worked out once per step.
+ *
+ * @details The immunity functions are kept in the forms used by the block
+ * kernels in griffin.cpp, with each division by a constant replaced by a
+ * multiplication:
+ *
+ *   b(I_B) = b_min + bdiff / (1 + (I_B * inv_I_B0)^kappa_B)
+ *   psi(age) = 1 - rho * exp(-age * inv_age_0)
+ *   r_A(I_A) = r_A0 + r_A0_w / (1 + (I_A * inv_I_A0)^-kappa_A)
+ */
+struct StepConstants {
+  StepConstants(const Parameters& params, const double dt);
+
+  // Probability of staying in each compartment over the step, and the share
+  // of departures that are deaths. The entry for A is only the template, its
+  // rate depends on the individual's immunity (see A_exit).
+  std::array<Exit, 6> exits;
+  double dt;
+  double mu_d;
+  double f_T;
+
+  double b_min;
+  double bdiff;
+  double inv_I_B0;
+  double kappa_B;
+  double rho;
+  double inv_age_0;
+  double r_A0;
+  double r_A0_w;
+  double inv_I_A0;
+  double kappa_A;
+};
+
+inline StepConstants::StepConstants(const Parameters& params,
+                                    const double dt)
+    : dt(dt),
+      mu_d(params.mu_d),
+      f_T(params.f_T),
+      b_min(params.b_min),
+      bdiff(params.b_max - params.b_min),
+      inv_I_B0(1.0 / params.I_B0),
+      kappa_B(params.kappa_B),
+      rho(params.rho),
+      inv_age_0(1.0 / params.age_0),
+      r_A0(params.r_A0),
+      r_A0_w(params.r_A0 * (params.w_A - 1.0)),
+      inv_I_A0(1.0 / params.I_A0),
+      kappa_A(params.kappa_A) {
+  // The only way out of S (other than infection) is death.
+  exits[static_cast<int>(Status::S)] = {std::exp(-dt * mu_d), 1.0};
+  exits[static_cast<int>(Status::A)] = make_exit(params.r_A0, mu_d, dt);
+  exits[static_cast<int>(Status::U)] = make_exit(params.r_U, mu_d, dt);
+  exits[static_cast<int>(Status::D)] = make_exit(params.r_D, mu_d, dt);
+  exits[static_cast<int>(Status::T)] = make_exit(params.r_T, mu_d, dt);
+  exits[static_cast<int>(Status::P)] = make_exit(params.r_P, mu_d, dt);
+}
+
+inline Exit A_exit(const double IA, const ImmunityFunctions& functions,
+                   const StepConstants& constants) {
+  // Construct the rate that the individual will leave A .
+  return make_exit(functions.r_A(IA), constants.mu_d, constants.dt);
+}
+
+template <class Uniform>
+bool determine_event(double survival, Uniform& uniform) {
+  // Determine if an event happens, given the probability that it does not.
+  auto r = uniform();
+  if (survival < r) {
+    return true;  // It happened.
+  }
+  return false;  // It did not.
+}
+
+// Boost the immunity of the bitten, and check whether an infection starts
+// this step. With Enabled::delay the infection from the bite is scheduled for
+// delay later. Without it the infection starts now, so it never needs to be
+// scheduled, and anything else that is due is discarded with it.
+template <class Enabled, class State>
+bool infection_starts(State& state, const bool bitten, const double t) {
+  if (bitten) {
+    if constexpr (Enabled::delay) {
+      state.scheduleInfection(t + delay);
+    }
+    if constexpr (Enabled::immunity) {
+      state.boostBiteImmunity();
+    }
+  }
+  const auto due = state.updateInfection(t);
+  return Enabled::delay ? due : bitten || due;
+}
+
+template <class Enabled = AllFeatures, class State, class Uniform,
+          class Events>
+void SAU_infection(State& state, const StepConstants& constants,
+                   const ImmunityFunctions& functions, const double t,
+                   Uniform& uniform, Events& events) {
+  // This function determines what happens with an infection in the S A or U
+  // compartment. It is assumed that Treatment wipes all infections that could
+  // occur
+
+  // You only come into this function if you are in S A or U, we do not need to
+  // consider the case of D going to D.
+  const auto r1 = uniform(), r2 = uniform();
+
+  // Get parameters
+  const auto f_T = constants.f_T;
+  // Do not have this in the individual as we do not want accidentally forget
+  // to update it.
+  const auto I_C = state.getIC();
+  // Get phi (immunity dependent)
+  const auto phi = functions.phi(I_C);
+  // Immunity is boosted by the infection, after it has played its part.
+  if constexpr (Enabled::immunity) {
+    state.boostInfectionImmunity();
+  }
+
+  // Which compartment does the new infection go to.
+  auto clinical_infection = r1 <= phi;
+  if (!clinical_infection) {
+    state.current_ = Status::A;
+    events.infection(state.current_);
+    return;
+  }
+
+  // Clinical infections - treated or untreated.
+  auto is_treated = r2 <= f_T;
+  if (is_treated) {
+    state.clearInfectionQueue();
+    state.current_ = Status::T;
+  } else {
+    // You have an untreated clinical disease
+    state.current_ = Status::D;
+  }
+  events.infection(state.current_);
+  return;
+}
+
+// Update the state of individuals. The model only draws the bites that go on
+// to become infections, so those are the bites that boost I_B.
+template <class Enabled = AllFeatures, class State, class Uniform,
+          class Events>
+bool S_update(State& state, const StepConstants& constants,
+              const ImmunityFunctions& functions,
+              const double bite, const Exit& exit,
+              const double t, Uniform& uniform,
+              Events& events) {
+  // Check to see if a bite occurs this time step.
+  const auto bitten = determine_event(bite, uniform);
+
+  // Check if a prior bite becomes an active infection this timestep.
+  auto infection_active = infection_starts<Enabled>(state, bitten, t);
+  if (!infection_active) {
+    return Enabled::mortality && determine_event(exit.survival, uniform);
+  }
+
+  // There was an infection activated, determine what happened.
+  SAU_infection<Enabled>(state, constants, functions, t, uniform, events);
+  return false;
+}
+
+template <class Enabled = AllFeatures, class State, class Uniform,
+          class Events>
+bool A_update(State& state, const StepConstants& constants,
+              const ImmunityFunctions& functions,
+              const double bite, const Exit& exit,
+              const double t, Uniform& uniform,
+              Events& events) noexcept {
+  // The rate that the individual will leave A depends on their immunity, exit
+  // has been built for this individual by A_exit.
+
+  // Check to see if a bite occurs this time step.
+  const auto bitten = determine_event(bite, uniform);
+
+  // Check and update the infection Queue - this function changes the update
+  // function.
+  auto infection_active = infection_starts<Enabled>(state, bitten, t);
+  if (infection_active) {
+    SAU_infection<Enabled>(state, constants, functions, t, uniform, events);
+    return false;
+  }
+
+  // Does a non-infection event occur.
+  const auto event_occurs = determine_event(exit.survival, uniform);
+  if (!event_occurs) {
+    return false;
+  }
+
+  // What event occurs.
+  const auto death = Enabled::mortality && uniform() < exit.death_share;
+  if (!death) {
+    // Move from A to U.
+    state.current_ = Status::U;
+  }
+  return death;
+}
+
+template <class Enabled = AllFeatures, class State, class Uniform,
+          class Events>
+bool U_update(State& state, const StepConstants& constants,
+              const ImmunityFunctions& functions,
+              const double bite, const Exit& exit,
+              const double t, Uniform& uniform,
+              Events& events) noexcept {
+  // In this compartment you can be infected or move to susceptible.
+  // Check to see if a bite occurs this time step.
+  const auto bitten = determine_event(bite, uniform);
+
+  // Check and update the infection Queue - this function changes the update
+  // function.
+  auto infection_active = infection_starts<Enabled>(state, bitten, t);
+  if (infection_active) {
+    SAU_infection<Enabled>(state, constants, functions, t, uniform, events);
+    return false;
+  }
+
+  // Does a non-infection event occur.
+  const auto event_occurs = determine_event(exit.survival, uniform);
+  if (!event_occurs) {
+    return false;
+  }
+
+  // Hey something is going to happen, but what! Lets find out.
+  const auto death = Enabled::mortality && uniform() < exit.death_share;
+  if (!death) {
+    // Move to S
+    state.current_ = Status::S;
+  }
+  return death;
+}
+
+template <class Enabled = AllFeatures, class State, class Uniform,
+          class Events>
+bool D_update(State& state, const StepConstants& constants,
+              const ImmunityFunctions& functions,
+              const double bite, const Exit& exit,
+              const double t, Uniform& uniform,
+              Events& events) noexcept {
+  // This checks to see if the time you are in D is enough to transition.
+
+  // Check to see if a bite occurs this time step.
+  const auto bitten = determine_event(bite, uniform);
+
+  // Check and update the infection Queue - this function changes the update
+  // function. Throw away result.
+
+  // Do we want to skip the function if this is the case?
+  // We need to keep checking the queue, but we throw out any that activate as
+  // we will stay in D. Hilariously, this is equivalent to just being infected
+  // and going to D again thanks to the wonders of the exponential
+  // distribution.
+  auto infection_active = infection_starts<Enabled>(state, bitten, t);
+  if (infection_active) {
+    // They go to D... so do not remove them from D and continue to do nothing
+    // else. The infection still boosts their immunity.
+    if constexpr (Enabled::immunity) {
+      state.boostInfectionImmunity();
+    }
+    return false;
+  }
+
+  // Does a non-infection event occur.
+  const auto event_occurs = determine_event(exit.survival, uniform);
+  if (!event_occurs) {
+    return event_occurs;
+  }
+
+  const auto death = Enabled::mortality && uniform() < exit.death_share;
+  if (!death) {
+    // You've been here long enough, move from D to A.
+    state.current_ = Status::A;
+  }
+  return death;
+}
+
+template <class Enabled = AllFeatures, class State, class Uniform,
+          class Events>
+bool T_update(State& state, const StepConstants& constants,
+              const ImmunityFunctions& functions,
+              const double bite, const Exit& exit,
+              const double t, Uniform& uniform,
+              Events& events) {
+  // This checks to see if the time you are in T is enough to transition.
+  const auto event_occurs = determine_event(exit.survival, uniform);
+
+  if (!event_occurs) {
+    return event_occurs;
+  }
+
+  const auto death = Enabled::mortality && uniform() < exit.death_share;
+  if (!death) {
+    state.current_ = Status::P;
+  }
+  return death;
+}
+
+template <class Enabled = AllFeatures, class State, class Uniform,
+          class Events>
+bool P_update(State& state, const StepConstants& constants,
+              const ImmunityFunctions& functions,
+              const double bite, const Exit& exit,
+              const double t, Uniform& uniform,
+              Events& events) {
+  // This checks to see if the time you are in P is enough to transition.
+  const auto event_occurs = determine_event(exit.survival, uniform);
+
+  if (!event_occurs) {
+    return event_occurs;
+  }
+
+  const auto death = Enabled::mortality && uniform() < exit.death_share;
+  if (!death) {
+    state.current_ = Status::S;
+  }
+  return death;
+}
+
+// Dispatch to the update for the individual's compartment. bite is the
+// probability of not being bitten this step and exit describes leaving the
+// current compartment. State is either PFalc or Population::Agent and uniform()
+// draws from U(0, 1). Returns true if the individual died.
+template <class Enabled = AllFeatures, class State, class Uniform,
+          class Events>
+bool update_compartment(State& state, const StepConstants& constants,
+                        const ImmunityFunctions& functions,
+                        const double bite, const Exit& exit,
+                        const double t, Uniform& uniform,
+                        Events& events) {
+  switch (state.current_) {
+    case Status::S:
+      return S_update<Enabled>(state, constants, functions, bite, exit, t,
+                               uniform, events);
+      break;
+    case Status::A:
+      return A_update<Enabled>(state, constants, functions, bite, exit, t,
+                               uniform, events);
+      break;
+    case Status::U:
+      return U_update<Enabled>(state, constants, functions, bite, exit, t,
+                               uniform, events);
+      break;
+    case Status::D:
+      return D_update<Enabled>(state, constants, functions, bite, exit, t,
+                               uniform, events);
+      break;
+    case Status::T:
+      return T_update<Enabled>(state, constants, functions, bite, exit, t,
+                               uniform, events);
+      break;
+    case Status::P:
+      return P_update<Enabled>(state, constants, functions, bite, exit, t,
+                               uniform, events);
+      break;
+    default:
+      throw std::logic_error("You messed up");
+  }
+}
+
+// Events receives every infection as it happens (see SAU_infection) and, once
+// the update is done, the individual's change of compartment or death. The
+// step functions also report the individual's new age and, in place of the
+// dead, births. NoEvents is used when nothing is being recorded and compiles
+// away.
+struct NoEvents {
+  void infection(const Status) const noexcept {};
+  void update(const Status, const Status, const bool) const noexcept {};
+  void aged(const double, const Status) const noexcept {};
+  void birth() const noexcept {};
+};
+
+struct TallyEvents {
+  void infection(const Status outcome) noexcept {
+    tally.infection(band, outcome);
+  };
+  void update(const Status before, const Status after,
+              const bool death) noexcept {
+    if (death) {
+      tally.death(band, before);
+    } else if (before != after) {
+      tally.transition(band, before, after);
+    }
+  };
+  void aged(const double age, const Status status) noexcept {
+    const auto now = recorder.band(age);
+    if (now != band) {
+      tally.aged(band, now, status);
+    }
+  };
+  void birth() noexcept { tally.birth(band); };
+
+  Tally& tally;
+  const Recorder& recorder;
+  // Band of the individual at the start of the step.
+  std::size_t band;
+};
+
+template <class Enabled = AllFeatures, class State, class Uniform,
+          class Events>
+bool update_state(State& state, const StepConstants& constants,
+                  const ImmunityFunctions& functions, const double bite,
+                  const Exit& exit, const double t, Uniform& uniform,
+                  Events&& events) {
+  const auto before = state.current_;
+  const auto death = update_compartment<Enabled>(state, constants, functions,
+                                                 bite, exit, t, uniform,
+                                                 events);
+  events.update(before, state.current_, death);
+  return death;
+}
+
+// Relative rate at which an individual is bitten, psi(age) * zeta. Bites on
+// humans are shared out in proportion to it, both those that infect the
+// individual and those that infect a mosquito (see mosquito.hpp).
+template <class State>
+double biting_weight(State& state, const double age,
+                     const ImmunityFunctions& functions) {
+  return functions.psi(age) * state.getZeta();
+}
+
+// Construct Lambda(t) for a single individual and update it. weight is the
+// individual's biting_weight.
+template <class Enabled = AllFeatures, class State, class Uniform,
+          class Events>
+bool update_individual(State& state, const double weight,
+                       const StepConstants& constants,
+                       const ImmunityFunctions& functions,
+                       const double eir, const double t,
+                       Uniform& uniform, Events&& events) {
+  auto b = functions.b(state.getIB());
+  auto lambda = eir * weight * b;
+
+  const auto bite = std::exp(-constants.dt * lambda);
+  const auto exit = state.current_ == Status::A
+                        ? A_exit(state.getIA(), functions, constants)
+                        : constants.exits[static_cast<int>(state.current_)];
+  return update_state<Enabled>(state, constants, functions, bite, exit, t,
+                               uniform, std::forward<Events>(events));
+}
+
+}  // namespace griffin
+}  // namespace falciparum
+}  // namespace plasx
+#endif
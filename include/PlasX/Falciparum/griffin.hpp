@@ -10,10 +10,17 @@
  * @copyright Copyright (c) 2023
  *
  */
-#include <queue>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
 
+#include "PlasX/Falciparum/Griffin/immunity.hpp"
+#include "PlasX/Falciparum/Griffin/infection_pool.hpp"
 #include "PlasX/Falciparum/Griffin/parameters.h"
 #include "PlasX/individual.hpp"
+#include "PlasX/random.hpp"
+#include "PlasX/thread_pool.hpp"
+#include "PlasX/types.hpp"
 namespace plasx {
 namespace falciparum {
 namespace griffin {
@@ -24,6 +31,12 @@ namespace griffin {
  */
 enum class Status { S, A, U, D, T, P };
 
+/**
+ * @brief Number of values of Status.
+ *
+ */
+inline constexpr std::size_t n_status = 6;
+
 /**
  * @brief Class defining all individual level variables in the model of Griffin
  * et al.
@@ -38,6 +51,13 @@ class PFalc {
    */
   PFalc(const Status& status, double ICA, double ICM, double IA);
 
+  // Pending infections beyond the next one are held in InfectionPool::shared().
+  PFalc(const PFalc& other);
+  PFalc(PFalc&& other) noexcept;
+  PFalc& operator=(const PFalc& other);
+  PFalc& operator=(PFalc&& other) noexcept;
+  ~PFalc();
+
   /**
    * @brief Clear the queue of infections that will occur. This is only called
    * when an individual will go into the treated compartment.
@@ -75,7 +95,37 @@ class PFalc {
    */
   double getIA() noexcept;
 
+  double getICA() noexcept { return I_CA_; };
+
+  /**
+   * @brief Boost the immunity gained from an infectious bite (I_B).
+   *
+   */
+  void boostBiteImmunity() noexcept { I_B_ += 1.0; };
+
+  /**
+   * @brief Boost the immunity gained from an infection (I_CA and I_A).
+   *
+   */
+  void boostInfectionImmunity() noexcept {
+    I_CA_ += 1.0;
+    I_A_ += 1.0;
+  };
+
+  /**
+   * @brief Let every immunity level decay by the given factors.
+   *
+   * @param decay
+   */
+  void decayImmunity(const ImmunityDecay& decay) noexcept {
+    I_CA_ *= decay.I_CA;
+    I_CM_ *= decay.I_CM;
+    I_A_ *= decay.I_A;
+    I_B_ *= decay.I_B;
+  };
+
   double getZeta() noexcept { return zeta_; };
+  void setZeta(const double zeta) noexcept { zeta_ = zeta; };
   double getIB() noexcept { return I_B_; };
 
   /**
@@ -85,6 +135,11 @@ class PFalc {
   Status current_;
 
  private:
+  // Reads and restores the private state (see Griffin/snapshot.hpp).
+  friend struct SnapshotAccess;
+
+  // Declared next to current_ so that the two share one 8 byte slot.
+  InfectionPool::Handle overflow_;
   double I_CA_;
   double I_CM_;
   double I_A_;
@@ -92,24 +147,225 @@ class PFalc {
   double I_B_;
 
   // I am assuming that you only want the force of infection to be lagged, hence
-  // we only have to store the time of the next infection.
-  std::priority_queue<double, std::vector<double>, std::greater<double>>
-      infection_queue_;
+  // we only have to store the time of the next infection. Any later ones are
+  // kept in the shared pool, starting at overflow_.
+  double next_infection_;
+};
+
+class Domain;
+class EventLog;
+class Mosquitoes;
+class Recorder;
+
+inline namespace PLASX_PRECISION_NAMESPACE {
+class BitingTable;
+struct HybridPopulation;
+class Metapopulation;
+class Population;
+}  // namespace PLASX_PRECISION_NAMESPACE
+
+/**
+ * @brief Everything OneStep is handed after the parameters: a fixed EIR or
+ * Mosquitoes, and any options of the step. Every option that was not given is
+ * null.
+ *
+ */
+struct StepOptions {
+  void set(const double eir) noexcept { this->eir = eir; };
+  void set(Mosquitoes& mosquitoes) noexcept { this->mosquitoes = &mosquitoes; };
+  void set(RandomStreams& streams) noexcept { this->streams = &streams; };
+  void set(ThreadPool& pool) noexcept { this->pool = &pool; };
+  void set(Domain& domain) noexcept { this->domain = &domain; };
+  void set(BitingTable& table) noexcept { this->table = &table; };
+  void set(Recorder& recorder) noexcept { this->recorder = &recorder; };
+  void set(EventLog& log) noexcept { this->log = &log; };
+
+  // Only used without mosquitoes.
+  double eir = 0.0;
+  Mosquitoes* mosquitoes = nullptr;
+  RandomStreams* streams = nullptr;
+  ThreadPool* pool = nullptr;
+  Domain* domain = nullptr;
+  BitingTable* table = nullptr;
+  Recorder* recorder = nullptr;
+  EventLog* log = nullptr;
 };
 
+/**
+ * @brief Number of Options that are a Kind.
+ *
+ */
+template <class Kind, class... Options>
+inline constexpr std::size_t count_of =
+    (std::size_t{std::is_same_v<std::decay_t<Options>, Kind>} + ... + 0);
+
 /**
  * @brief Runs a single step in time for the Griffin model.
  *
- * @param t
- * @param dt
- * @param population
- * @param params
- * @param eir
- * @return RealType
+ * @details This is a function object rather than a function so that the
+ * steps of every population layout can be handed to plasx::simulation as a
+ * single argument.
  */
-RealType one_step(double t, double dt,
-                  std::vector<Individual<PFalc>>& population,
-                  const Parameters& params, double eir);
+struct OneStep {
+  /**
+   * @brief Step a population from t to t + dt.
+   *
+   * @details The population is an array of individuals
+   * (std::vector<Individual<PFalc>>), stored column-wise (Population, see
+   * Griffin/population.hpp), or binned (HybridPopulation, see
+   * Griffin/cohorts.hpp). transmission is either a fixed EIR or Mosquitoes
+   * (see Griffin/mosquito.hpp). The humans see the EIR of the mosquitoes at
+   * the start of the step, and the mosquitoes are then stepped with the
+   * infectiousness of the humans at its end, summed in the same pass that
+   * updates the individuals.
+   *
+   * The options follow in any order and combination, each at most once:
+   * - RandomStreams: the blocked step. The population is split into fixed
+   *   blocks of block_size individuals and every block draws from its own
+   *   stream, advanced by one epoch per step. Within a block the infection
+   *   and recovery probabilities are computed for every individual at once
+   *   with the kernels in vector_math.hpp, and the uniform draws are
+   *   generated into a buffer before any individual is updated. Without it a
+   *   step draws from the global generator. Every option below bar a
+   *   Recorder needs it, as does a HybridPopulation.
+   * - ThreadPool: the blocks are stepped across the pool rather than in order
+   *   on this thread. The result depends on the seed and block size, but not
+   *   on the number of threads, so many independent simulations can each be
+   *   run on a thread of their own.
+   * - Domain: the population is this process's shard of one spread over many
+   *   processes (see Griffin/domain.hpp). Not with an EventLog.
+   * - BitingTable: the bites of each step are allocated by the table (see
+   *   Griffin/biting.hpp), from an epoch of its own taken before the step's.
+   *   Only those handed a bite are looked at, which is worth it when the EIR
+   *   is low.
+   * - Recorder: the compartment counts and the infections, clinical cases
+   *   and deaths of the step are kept (see Griffin/recorder.hpp).
+   * - EventLog: every infection, change of compartment, death and birth is
+   *   written to the log (see Griffin/event_log.hpp). Not with a Recorder or
+   *   a Domain.
+   *
+   * A HybridPopulation cannot be given a Domain, BitingTable or EventLog, and
+   * an array of individuals only a Recorder. Every combination that is not
+   * allowed fails to compile.
+   *
+   * @param t
+   * @param dt
+   * @param population
+   * @param params
+   * @param transmission
+   * @param options
+   * @return double
+   */
+  template <class Layout, class Transmission, class... Options>
+    requires std::is_same_v<Layout, std::vector<Individual<PFalc>>> ||
+             std::is_same_v<Layout, Population> ||
+             std::is_same_v<Layout, HybridPopulation>
+  double operator()(double t, double dt, Layout& population,
+                    const Parameters& params, Transmission&& transmission,
+                    Options&&... options) const {
+    constexpr auto blocked = count_of<RandomStreams, Options...> > 0;
+    static_assert(((count_of<std::decay_t<Options>, Options...> == 1) && ...),
+                  "Each option can only be given once.");
+    static_assert(
+        count_of<Recorder, Options...> + count_of<EventLog, Options...> <= 1,
+        "A step can be given a Recorder or an EventLog, not both.");
+    static_assert(
+        blocked || sizeof...(Options) == count_of<Recorder, Options...>,
+        "Every option but a Recorder needs RandomStreams.");
+    static_assert(!std::is_same_v<Layout, std::vector<Individual<PFalc>>> ||
+                      !blocked,
+                  "An array of individuals can only be given a Recorder.");
+    static_assert(
+        count_of<Domain, Options...> + count_of<EventLog, Options...> <= 1,
+        "A Domain cannot be given an EventLog.");
+    static_assert(!std::is_same_v<Layout, HybridPopulation> ||
+                      (blocked && count_of<Domain, Options...> == 0 &&
+                       count_of<BitingTable, Options...> == 0 &&
+                       count_of<EventLog, Options...> == 0),
+                  "A HybridPopulation needs RandomStreams, and cannot be given "
+                  "a Domain, BitingTable or EventLog.");
+    StepOptions chosen;
+    chosen.set(transmission);
+    (chosen.set(options), ...);
+    return step(t, dt, population, params, chosen);
+  }
+
+  /**
+   * @brief Step every patch of a metapopulation and then exchange migrants
+   * between them (see Griffin/metapopulation.hpp). Patches are stepped in
+   * parallel, one per task of the pool.
+   *
+   * @param t
+   * @param dt
+   * @param metapopulation
+   * @param params
+   * @param pool
+   * @return double
+   */
+  double operator()(double t, double dt, Metapopulation& metapopulation,
+                    const Parameters& params, ThreadPool& pool) const;
+
+  /**
+   * @brief Number of individuals handled by each stream in the blocked step.
+   *
+   */
+  static constexpr std::size_t block_size = 4096;
+
+ private:
+  double step(double t, double dt, std::vector<Individual<PFalc>>& population,
+              const Parameters& params, const StepOptions& options) const;
+  double step(double t, double dt, Population& population,
+              const Parameters& params, const StepOptions& options) const;
+  // A HybridPopulation's bins are stepped first, then the agents with the
+  // blocked step, and finally the agents that settled back into S are
+  // absorbed into the bins. RandomStreams are advanced by an extra epoch for
+  // the bins.
+  double step(double t, double dt, HybridPopulation& population,
+              const Parameters& params, const StepOptions& options) const;
+};
+
+inline constexpr OneStep one_step{};
+
+/**
+ * @brief Parts of the model that a step can leave out at compile time. A step
+ * without a feature has no instructions for it in the loop over individuals.
+ *
+ * @tparam Mortality Individuals die at rate mu_d and are replaced by newborns.
+ * Without it mu_d is taken to be 0.
+ * @tparam Delay Infections start delay after the bite (see update.hpp).
+ * Without it they start in the step of the bite, whatever delay is.
+ * @tparam Immunity Bites and infections boost immunity, and immunity decays.
+ * Without it everyone keeps the immunity they started with.
+ */
+template <bool Mortality, bool Delay, bool Immunity>
+struct Features {
+  static constexpr bool mortality = Mortality;
+  static constexpr bool delay = Delay;
+  static constexpr bool immunity = Immunity;
+};
+
+using AllFeatures = Features<true, true, true>;
+
+/**
+ * @brief The blocked and threaded steps of OneStep, with only the Enabled
+ * features compiled in.
+ *
+ * @details OneStep already leaves out mortality when mu_d is 0 and the delay
+ * when delay is 0, which gives exactly the same result, so this is only
+ * needed to force a feature off. It is instantiated for every combination of
+ * Features.
+ *
+ * @tparam Enabled A Features.
+ */
+template <class Enabled>
+struct FeatureStep {
+  double operator()(double t, double dt, Population& population,
+                    const Parameters& params, double eir, ThreadPool& pool,
+                    RandomStreams& streams) const;
+  double operator()(double t, double dt, Population& population,
+                    const Parameters& params, double eir,
+                    RandomStreams& streams) const;
+};
 }  // namespace griffin
 }  // namespace falciparum
 }  // namespace plasx
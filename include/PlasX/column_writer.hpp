@@ -0,0 +1,100 @@
+#ifndef PLASX_COLUMN_WRITER_HPP
+#define PLASX_COLUMN_WRITER_HPP
+/**
+ * @file column_writer.hpp
+ * @author Eamon Conway (conway.e@wehi.edu.au)
+ * @brief Buffered writer (and reader) for chunked columnar binary files.
+ * @version 0.1
+ * @date 2023-05-02
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace plasx {
+/**
+ * @brief Writes rows of doubles to a file, column by column.
+ *
+ * @details Rows are buffered in memory and written out one chunk at a time,
+ * so the file is only touched every chunk_rows rows. The layout is
+ *
+ *   "PLASXCOL" | uint32 version | uint32 number of columns |
+ *   (uint32 length, name) per column |
+ *   chunks of (uint64 rows, rows doubles for column 0, column 1, ...)
+ *
+ * in native byte order. Each chunk stores whole columns, so a reader can pull
+ * out a single variable without touching the rest.
+ */
+class ColumnWriter {
+ public:
+  /**
+   * @brief Construct a new Column Writer object and write the header.
+   *
+   * @param path
+   * @param names Name of each column.
+   * @param chunk_rows Number of rows buffered before they are written.
+   */
+  ColumnWriter(const std::string& path, std::vector<std::string> names,
+               std::size_t chunk_rows = 1024);
+  ~ColumnWriter();
+
+  ColumnWriter(const ColumnWriter&) = delete;
+  ColumnWriter& operator=(const ColumnWriter&) = delete;
+
+  /**
+   * @brief Append a row. values must point to one value per column.
+   *
+   * @param values
+   */
+  void write_row(const double* values);
+
+  /**
+   * @brief Write any buffered rows to the file.
+   *
+   */
+  void flush();
+
+  const std::vector<std::string>& names() const noexcept { return names_; };
+
+ private:
+  std::ofstream file_;
+  std::vector<std::string> names_;
+  std::size_t chunk_rows_;
+  std::size_t rows_ = 0;
+  // Buffered values, stored column after column.
+  std::vector<double> buffer_;
+};
+
+/**
+ * @brief Contents of a file written by ColumnWriter.
+ *
+ */
+struct ColumnTable {
+  std::vector<std::string> names;
+  std::vector<std::vector<double>> columns;
+
+  /**
+   * @brief Column with the given name. Throws std::out_of_range if there is no
+   * such column.
+   *
+   * @param name
+   * @return const std::vector<double>&
+   */
+  const std::vector<double>& operator[](const std::string& name) const;
+};
+
+/**
+ * @brief Read a whole file written by ColumnWriter. Throws std::runtime_error
+ * if the file cannot be read or is not in the expected format.
+ *
+ * @param path
+ * @return ColumnTable
+ */
+ColumnTable read_columns(const std::string& path);
+}  // namespace plasx
+#endif
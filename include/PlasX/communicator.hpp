@@ -0,0 +1,111 @@
+#ifndef PLASX_COMMUNICATOR_HPP
+#define PLASX_COMMUNICATOR_HPP
+/**
+ * @file communicator.hpp
+ * @author Eamon Conway (conway.e@wehi.edu.au)
+ * @brief Collective communication between the processes of a distributed run.
+ * @version 0.1
+ * @date 2023-06-27
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#include <cstddef>
+#include <functional>
+
+namespace plasx {
+/**
+ * @brief The few collective operations a distributed simulation needs.
+ *
+ * @details Every process of a run holds a Communicator with its own rank in
+ * [0, size). Every operation is collective: each process has to call it, in
+ * the same order. Backends for a cluster (e.g. MPI) only need to implement
+ * this interface.
+ */
+class Communicator {
+ public:
+  virtual ~Communicator() = default;
+
+  virtual std::size_t rank() const noexcept = 0;
+  virtual std::size_t size() const noexcept = 0;
+
+  /**
+   * @brief Wait until every process has reached the barrier.
+   *
+   */
+  virtual void barrier() = 0;
+
+  /**
+   * @brief Replace data[0, n) on every process with its sum over all
+   * processes. The sum is taken in order of rank, so every process gets
+   * exactly the same result.
+   *
+   * @param data
+   * @param n
+   */
+  virtual void all_reduce_sum(double* data, const std::size_t n) = 0;
+};
+
+/**
+ * @brief Communicator for a run on a single process.
+ *
+ */
+class LocalCommunicator final : public Communicator {
+ public:
+  std::size_t rank() const noexcept override { return 0; };
+  std::size_t size() const noexcept override { return 1; };
+  void barrier() override{};
+  void all_reduce_sum(double*, const std::size_t) override{};
+};
+
+/**
+ * @brief Communicator for processes on one machine, that talk through a
+ * region of shared memory. See run_local.
+ *
+ * @details Each process owns a slot of the region. A reduction copies the
+ * data into the process's slot, waits for everyone, and then sums every slot.
+ * Data larger than a slot is reduced one slot sized piece at a time.
+ */
+class SharedMemoryCommunicator final : public Communicator {
+ public:
+  struct Region;
+
+  SharedMemoryCommunicator(Region& region, const std::size_t rank);
+
+  std::size_t rank() const noexcept override { return rank_; };
+  std::size_t size() const noexcept override;
+  void barrier() override;
+  void all_reduce_sum(double* data, const std::size_t n) override;
+
+  /**
+   * @brief Tell every other process that this one has failed, so that they
+   * stop waiting for it.
+   *
+   */
+  void abort() noexcept;
+
+ private:
+  Region& region_;
+  std::size_t rank_;
+};
+
+/**
+ * @brief Run task in n_processes processes on this machine, connected by a
+ * SharedMemoryCommunicator, and wait for all of them.
+ *
+ * @details The calling process is rank 0, the others are forked from it, so
+ * they start with a copy of everything the caller had set up. Anything they
+ * want to hand back has to go through the communicator. If task throws in any
+ * process, the others are stopped at their next collective operation and a
+ * std::runtime_error is thrown here (or, if it was rank 0 that failed, its own
+ * exception is rethrown).
+ *
+ * @param n_processes
+ * @param task
+ * @param slot_size Number of doubles each process can reduce at once.
+ */
+void run_local(const std::size_t n_processes,
+               const std::function<void(Communicator&)>& task,
+               const std::size_t slot_size = 1 << 16);
+}  // namespace plasx
+#endif
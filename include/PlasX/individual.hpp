@@ -32,7 +32,7 @@ class Individual {
   Individual(double age, auto&&... dargs)
       : age_(age), status_(std::forward<decltype(dargs)>(dargs)...){};
 
-  RealType age_;
+  double age_;
   DiseaseStatus status_;
 };
 }  // namespace plasx
@@ -0,0 +1,67 @@
+#ifndef PLASX_PERF_COUNTERS_HPP
+#define PLASX_PERF_COUNTERS_HPP
+/**
+ * @file perf_counters.hpp
+ * @author Eamon Conway (conway.e@wehi.edu.au)
+ * @brief Hardware performance counters of a thread, read with perf_event_open.
+ * @version 0.1
+ * @date 2023-08-02
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#include <array>
+#include <cstdint>
+
+namespace plasx {
+/**
+ * @brief Cycles, instructions, cache misses and branch misses of the thread
+ * that constructed it, in user space.
+ *
+ * @details Only on Linux, and only where the kernel allows it (see
+ * /proc/sys/kernel/perf_event_paranoid) and the hardware has the counters,
+ * which virtual machines often do not. Otherwise available() is false and
+ * every reading is 0. The counters run from construction, so take the
+ * difference of two readings.
+ */
+class PerfCounters {
+ public:
+  struct Reading {
+    std::uint64_t cycles = 0;
+    std::uint64_t instructions = 0;
+    std::uint64_t cache_misses = 0;
+    std::uint64_t branch_misses = 0;
+  };
+
+  PerfCounters() noexcept;
+  ~PerfCounters();
+
+  PerfCounters(const PerfCounters&) = delete;
+  PerfCounters& operator=(const PerfCounters&) = delete;
+
+  bool available() const noexcept { return fds_[0] != -1; };
+  Reading read() const noexcept;
+
+ private:
+  void close() noexcept;
+
+  // The first is the leader of the group, all are read at once through it.
+  std::array<int, 4> fds_;
+};
+
+inline PerfCounters::Reading operator-(const PerfCounters::Reading& a,
+                                       const PerfCounters::Reading& b) {
+  return {a.cycles - b.cycles, a.instructions - b.instructions,
+          a.cache_misses - b.cache_misses, a.branch_misses - b.branch_misses};
+}
+
+inline PerfCounters::Reading& operator+=(PerfCounters::Reading& a,
+                                         const PerfCounters::Reading& b) {
+  a.cycles += b.cycles;
+  a.instructions += b.instructions;
+  a.cache_misses += b.cache_misses;
+  a.branch_misses += b.branch_misses;
+  return a;
+}
+}  // namespace plasx
+#endif
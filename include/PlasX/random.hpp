@@ -10,10 +10,198 @@
  * @copyright Copyright (c) 2023
  *
  */
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
 #include <random>
 
 namespace plasx {
 extern std::uniform_real_distribution<double> genunf_std;
 extern std::default_random_engine generator;
+
+/**
+ * @brief SplitMix64 mixing function. Used to turn (seed, counter) pairs into
+ * well separated generator states.
+ *
+ * @param x
+ * @return std::uint64_t
+ */
+constexpr std::uint64_t splitmix64(std::uint64_t x) noexcept {
+  x += 0x9e3779b97f4a7c15;
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111eb;
+  return x ^ (x >> 31);
+}
+
+/**
+ * @brief xoshiro256++ generator of Blackman and Vigna. Satisfies
+ * UniformRandomBitGenerator, so it can be used with the standard
+ * distributions.
+ *
+ */
+class Xoshiro256 {
+ public:
+  using result_type = std::uint64_t;
+
+  /**
+   * @brief Construct a new Xoshiro256 object. The state is filled by running
+   * SplitMix64 from seed.
+   *
+   * @param seed
+   */
+  explicit Xoshiro256(std::uint64_t seed = 0) noexcept {
+    for (auto& s : state_) {
+      seed += 0x9e3779b97f4a7c15;
+      s = splitmix64(seed);
+    }
+  };
+
+  static constexpr result_type min() noexcept { return 0; };
+  static constexpr result_type max() noexcept {
+    return std::numeric_limits<result_type>::max();
+  };
+
+  result_type operator()() noexcept {
+    const auto result = rotl(state_[0] + state_[3], 23) + state_[0];
+    const auto t = state_[1] << 17;
+    state_[2] ^= state_[0];
+    state_[3] ^= state_[1];
+    state_[1] ^= state_[2];
+    state_[0] ^= state_[3];
+    state_[2] ^= t;
+    state_[3] = rotl(state_[3], 45);
+    return result;
+  };
+
+  /**
+   * @brief Uniform double on [0, 1) built from the top 53 bits.
+   *
+   * @return double
+   */
+  double uniform() noexcept { return ((*this)() >> 11) * 0x1.0p-53; };
+
+ private:
+  static constexpr std::uint64_t rotl(const std::uint64_t x, int k) noexcept {
+    return (x << k) | (x >> (64 - k));
+  };
+  std::array<std::uint64_t, 4> state_;
+};
+
+/**
+ * @brief Four interleaved xoshiro256++ generators, used to fill buffers of
+ * uniform numbers in bulk.
+ *
+ * @details The state is stored lane by lane, so every update is the same
+ * operation on four 64 bit integers and the loop in fill_uniform compiles to
+ * SIMD instructions where they are available.
+ */
+class Xoshiro256x4 {
+ public:
+  static constexpr std::size_t lanes = 4;
+
+  explicit Xoshiro256x4(std::uint64_t seed = 0) noexcept {
+    for (auto& word : state_) {
+      for (auto& s : word) {
+        seed += 0x9e3779b97f4a7c15;
+        s = splitmix64(seed);
+      }
+    }
+  };
+
+  /**
+   * @brief Fill out[0, n) with uniform doubles on [0, 1).
+   *
+   * @param out
+   * @param n
+   */
+  void fill_uniform(double* out, std::size_t n) noexcept {
+    auto& [s0, s1, s2, s3] = state_;
+    for (std::size_t i = 0; i < n; i += lanes) {
+      std::uint64_t result[lanes];
+      for (std::size_t l = 0; l < lanes; ++l) {
+        result[l] = rotl(s0[l] + s3[l], 23) + s0[l];
+        const auto t = s1[l] << 17;
+        s2[l] ^= s0[l];
+        s3[l] ^= s1[l];
+        s1[l] ^= s2[l];
+        s0[l] ^= s3[l];
+        s2[l] ^= t;
+        s3[l] = rotl(s3[l], 45);
+      }
+      const auto count = n - i < lanes ? n - i : lanes;
+      for (std::size_t l = 0; l < count; ++l) {
+        out[i + l] = (result[l] >> 11) * 0x1.0p-53;
+      }
+    }
+  };
+
+ private:
+  static constexpr std::uint64_t rotl(const std::uint64_t x, int k) noexcept {
+    return (x << k) | (x >> (64 - k));
+  };
+  std::array<std::array<std::uint64_t, lanes>, 4> state_;
+};
+
+/**
+ * @brief Family of independent random number streams derived from a single
+ * seed.
+ *
+ * @details A stream is identified by an epoch (for example the step number)
+ * and an index (for example a block of the population). The same (seed, epoch,
+ * index) triple always gives the same stream, so work can be split between
+ * threads in any way without changing the results.
+ */
+class RandomStreams {
+ public:
+  explicit RandomStreams(std::uint64_t seed) noexcept : seed_(seed){};
+
+  /**
+   * @brief Construct a new RandomStreams object that starts at a given epoch,
+   * e.g. to carry on from a snapshot.
+   *
+   * @param seed
+   * @param epoch
+   */
+  RandomStreams(std::uint64_t seed, std::uint64_t epoch) noexcept
+      : seed_(seed), epoch_(epoch){};
+
+  /**
+   * @brief Get the stream for a given epoch and index.
+   *
+   * @param epoch
+   * @param index
+   * @return Xoshiro256
+   */
+  Xoshiro256 stream(std::uint64_t epoch, std::uint64_t index) const noexcept {
+    return Xoshiro256(key(epoch, index));
+  };
+
+  /**
+   * @brief Seed that identifies the stream for a given epoch and index. Use
+   * this to seed generators other than Xoshiro256.
+   *
+   * @param epoch
+   * @param index
+   * @return std::uint64_t
+   */
+  std::uint64_t key(std::uint64_t epoch, std::uint64_t index) const noexcept {
+    return splitmix64(splitmix64(seed_ ^ splitmix64(epoch)) + index);
+  };
+
+  /**
+   * @brief Return the current epoch and move on to the next one.
+   *
+   * @return std::uint64_t
+   */
+  std::uint64_t next_epoch() noexcept { return epoch_++; };
+
+  std::uint64_t seed() const noexcept { return seed_; };
+  std::uint64_t epoch() const noexcept { return epoch_; };
+
+ private:
+  std::uint64_t seed_;
+  std::uint64_t epoch_ = 0;
+};
 }  // namespace plasx
-#endif
\ No newline at end of file
+#endif
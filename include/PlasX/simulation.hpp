@@ -1,33 +1,73 @@
 #ifndef PLASX_SIMULATION_HPP
 #define PLASX_SIMULATION_HPP
 #include <algorithm>
+#include <type_traits>
+#include <utility>
 
 #include "PlasX/types.hpp"
 
 namespace plasx {
 
 /**
- * @brief
+ * @brief Step from t0 until t1 with one_step, like simulation, but call
+ * observer(t) after every step with the time reached. If observer returns a
+ * bool, the simulation stops as soon as it returns false.
+ *
+ * @details one_step is taken by reference, so a step with state of its own,
+ * such as an EventDriven engine, is the caller's and carries on from where it
+ * was left.
  *
  * @tparam OneStepFunction
+ * @tparam Observer
  * @tparam OneStepArgs
  * @param t0
  * @param t1
  * @param dt
  * @param one_step
+ * @param observer
  * @param function_args
- * @return RealType
+ * @return double Time reached.
  */
-template <class OneStepFunction, class... OneStepArgs>
-RealType simulation(const double t0, const double t1, const double dt,
-                    OneStepFunction one_step, OneStepArgs&&... function_args) {
+template <class OneStepFunction, class Observer, class... OneStepArgs>
+double observed_simulation(const double t0, const double t1, const double dt,
+                           OneStepFunction&& one_step, Observer&& observer,
+                           OneStepArgs&&... function_args) {
   auto t = t0;
 
   while (t < t1) {
     t = one_step(t, dt,
                  std::forward<decltype(function_args)>(function_args)...);
+    if constexpr (std::is_same_v<decltype(observer(t)), bool>) {
+      if (!observer(t)) {
+        break;
+      }
+    } else {
+      observer(t);
+    }
   }
   return t;
 }
+
+/**
+ * @brief Step from t0 until t1 with one_step, which is handed the time, dt
+ * and function_args and returns the time reached. one_step is taken by
+ * reference (see observed_simulation).
+ *
+ * @tparam OneStepFunction
+ * @tparam OneStepArgs
+ * @param t0
+ * @param t1
+ * @param dt
+ * @param one_step
+ * @param function_args
+ * @return double
+ */
+template <class OneStepFunction, class... OneStepArgs>
+double simulation(const double t0, const double t1, const double dt,
+                  OneStepFunction&& one_step, OneStepArgs&&... function_args) {
+  return observed_simulation(
+      t0, t1, dt, std::forward<OneStepFunction>(one_step), [](double) {},
+      std::forward<decltype(function_args)>(function_args)...);
+}
 }  // namespace plasx
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,81 @@
+#ifndef PLASX_THREAD_POOL_HPP
+#define PLASX_THREAD_POOL_HPP
+/**
+ * @file thread_pool.hpp
+ * @author Eamon Conway (conway.e@wehi.edu.au)
+ * @brief
+ * @version 0.1
+ * @date 2023-04-14
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace plasx {
+/**
+ * @brief Fixed set of worker threads that run indexed loops.
+ *
+ * @details Tasks are handed out one index at a time from a shared counter, so
+ * which thread runs a given index is not defined. Anything that has to be
+ * reproducible must therefore only depend on the index.
+ */
+class ThreadPool {
+ public:
+  /**
+   * @brief Construct a new Thread Pool object.
+   *
+   * @param n_threads Total number of threads, including the calling thread.
+   */
+  explicit ThreadPool(
+      std::size_t n_threads = std::thread::hardware_concurrency());
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  /**
+   * @brief Call task(i) for every i in [0, n_tasks) and wait for all of them to
+   * finish. The calling thread also runs tasks. The first exception thrown by a
+   * task is rethrown here.
+   *
+   * @param n_tasks
+   * @param task
+   */
+  void parallel_for(std::size_t n_tasks,
+                    const std::function<void(std::size_t)>& task);
+
+  /**
+   * @brief Number of threads that run tasks, including the calling thread.
+   *
+   * @return std::size_t
+   */
+  std::size_t size() const noexcept { return workers_.size() + 1; };
+
+ private:
+  void work();
+  void run_tasks();
+
+  std::vector<std::thread> workers_;
+  std::mutex mutex_;
+  std::condition_variable start_;
+  std::condition_variable finished_;
+
+  // State of the loop currently being run.
+  const std::function<void(std::size_t)>* task_ = nullptr;
+  std::size_t n_tasks_ = 0;
+  std::atomic<std::size_t> next_{0};
+  std::size_t active_ = 0;
+  std::size_t generation_ = 0;
+  std::exception_ptr error_;
+  bool stop_ = false;
+};
+}  // namespace plasx
+#endif
@@ -10,7 +10,35 @@
  * @copyright Copyright (c) 2023
  * 
  */
+
+/**
+ * @brief Inline namespace of StateType and of every class whose layout depends
+ * on it (the Griffin Population and the classes that hold one). Its name
+ * follows the precision, so that code built with FLOAT=1 fails to link
+ * against code built without it, rather than disagreeing on their layout.
+ *
+ */
+#ifdef PLASX_SINGLE_PRECISION
+#define PLASX_PRECISION_NAMESPACE f32
+#else
+#define PLASX_PRECISION_NAMESPACE f64
+#endif
+
 namespace plasx {
-  using RealType = double;
+inline namespace PLASX_PRECISION_NAMESPACE {
+  /**
+   * @brief Type of the per individual columns of the Griffin Population (age,
+   * immunity and biting heterogeneity) and of the step's scratch arrays. It is
+   * float when compiled with -DPLASX_SINGLE_PRECISION (make FLOAT=1), which
+   * halves their memory and doubles the lanes of the exp and pow kernels, and
+   * double otherwise. Times (next_infection_, updated_, t) stay double.
+   *
+   */
+#ifdef PLASX_SINGLE_PRECISION
+  using StateType = float;
+#else
+  using StateType = double;
+#endif
+}  // namespace PLASX_PRECISION_NAMESPACE
 }
-#endif
\ No newline at end of file
+#endif
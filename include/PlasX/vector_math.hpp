@@ -0,0 +1,76 @@
+#ifndef PLASX_VECTOR_MATH_HPP
+#define PLASX_VECTOR_MATH_HPP
+/**
+ * @file vector_math.hpp
+ * @author Eamon Conway (conway.e@wehi.edu.au)
+ * @brief Elementwise exp and pow over arrays, in double or single precision.
+ * @version 0.1
+ * @date 2023-04-20
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#include <cstddef>
+
+namespace plasx {
+/**
+ * @brief Number of doubles processed together by the kernels below. This is 8
+ * when compiled for AVX-512, 4 for AVX2 and 1 (plain scalar code) otherwise.
+ *
+ */
+extern const std::size_t vector_lanes;
+
+/**
+ * @brief Number of floats processed together by the single precision kernels,
+ * twice vector_lanes.
+ *
+ */
+extern const std::size_t float_vector_lanes;
+
+/**
+ * @brief Compute y[i] = exp(x[i]) for i in [0, n). x and y may alias.
+ *
+ * @details Accurate to a few ulp for x in [-708, 709]. Inputs outside that
+ * range are clamped to it, so the result never underflows to zero or overflows
+ * to infinity.
+ *
+ * @param x
+ * @param y
+ * @param n
+ */
+void batch_exp(const double* x, double* y, std::size_t n) noexcept;
+
+/**
+ * @brief Compute y[i] = pow(x[i], k) for i in [0, n). x and y may alias.
+ *
+ * @details Only defined for x[i] >= 0, which is all the model needs. A zero (or
+ * subnormal) base gives 0 for positive k and infinity for negative k.
+ *
+ * @param x
+ * @param k
+ * @param y
+ * @param n
+ */
+void batch_pow(const double* x, double k, double* y, std::size_t n) noexcept;
+
+/**
+ * @brief Single precision batch_exp, accurate to a few ulp for x in [-87, 88]
+ * and clamped to it.
+ *
+ * @param x
+ * @param y
+ * @param n
+ */
+void batch_exp(const float* x, float* y, std::size_t n) noexcept;
+
+/**
+ * @brief Single precision batch_pow, with the same treatment of a zero base.
+ *
+ * @param x
+ * @param k
+ * @param y
+ * @param n
+ */
+void batch_pow(const float* x, float k, float* y, std::size_t n) noexcept;
+}  // namespace plasx
+#endif
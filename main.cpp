@@ -1,31 +1,71 @@
 #include <chrono>
 #include <iostream>
 
+#include "PlasX/Falciparum/Griffin/biting.hpp"
+#include "PlasX/Falciparum/Griffin/equilibrium.hpp"
+#include "PlasX/Falciparum/Griffin/instrumentation.hpp"
+#include "PlasX/Falciparum/Griffin/mosquito.hpp"
+#include "PlasX/Falciparum/Griffin/parameter_file.hpp"
+#include "PlasX/Falciparum/Griffin/population.hpp"
 #include "PlasX/Falciparum/griffin.hpp"
+#include "PlasX/random.hpp"
 #include "PlasX/simulation.hpp"
+#include "PlasX/thread_pool.hpp"
 #include "PlasX/udl.hpp"
 
 using namespace plasx;
 namespace pfg = falciparum::griffin;
 
-int main() {
-  // Create parameters.
-  pfg::Parameters params;
+int main(int argc, char* argv[]) {
+  // Create parameters, from the parameter file if one is given.
+  const auto parameters =
+      argc > 1 ? pfg::load_parameters(argv[1]) : pfg::ParameterSet();
+  const auto& params = parameters.human;
   const int N = 1000000;
-  // Create individuals.
-  std::vector<Individual<pfg::PFalc>> population;
-  for (auto i = 0; i < N; ++i) {
-    population.emplace_back(10.0, pfg::Status::S, 0.0, 0.0, 0.0);
+
+  // Mosquitoes (20 per person) start in equilibrium with a human population
+  // of infectiousness 0.05, and the EIR follows the humans from there.
+  pfg::Mosquitoes mosquitoes(parameters.mosquito, 20.0, 0.05);
+
+  // Create individuals, at equilibrium with the EIR of the mosquitoes if
+  // anyone dies, and otherwise all susceptible and 10 days old.
+  auto setup = std::chrono::steady_clock::now();
+  ThreadPool pool;
+  RandomStreams streams(1);
+  pfg::Population population;
+  if (params.mu_d > 0.0) {
+    pfg::Equilibrium(params, mosquitoes.eir())
+        .fill(population, N, pool, streams);
+  } else {
+    auto rng = streams.stream(streams.next_epoch(), 0);
+    population.reserve(N);
+    for (auto i = 0; i < N; ++i) {
+      population.emplace_back(10.0, pfg::Status::S, 0.0, 0.0, 0.0);
+      population.zeta_.back() = pfg::draw_zeta(params, rng);
+    }
   }
+  std::chrono::duration<double> setup_seconds =
+      std::chrono::steady_clock::now() - setup;
+  std::cout << "setup time: " << setup_seconds.count() << " s\n";
 
+  if constexpr (pfg::instrumented) {
+    pfg::Instrumentation::global().sample_hardware();
+  }
   auto start = std::chrono::steady_clock::now();
   [[maybe_unused]] auto t2 =
       plasx::simulation(0.0_yrs, 1.0_yrs, 1.0_days, pfg::one_step,
-                        population, params, 1.0);
+                        population, params, mosquitoes, pool, streams);
   auto end = std::chrono::steady_clock::now();
-  auto elapsed_seconds = end - start;
-  std::cout << "elapsed time with no switches: " << elapsed_seconds.count() * 1e-6 << "\n";
+  // steady_clock ticks are not seconds, convert explicitly.
+  std::chrono::duration<double> elapsed_seconds = end - start;
+  std::cout << "elapsed time with no switches: " << elapsed_seconds.count()
+            << " s\n";
   std::cout << "pop size " << population.size() << std::endl;
+  std::cout << "final EIR " << mosquitoes.eir() << " per day" << std::endl;
+  if constexpr (pfg::instrumented) {
+    std::cout << '\n';
+    pfg::Instrumentation::global().report(std::cout);
+  }
 
   return EXIT_SUCCESS;
 }
\ No newline at end of file
@@ -0,0 +1,145 @@
+#include "PlasX/Falciparum/Griffin/biting.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+
+#include "PlasX/Falciparum/Griffin/population.hpp"
+#include "PlasX/Falciparum/griffin.hpp"
+
+namespace plasx {
+namespace falciparum {
+namespace griffin {
+
+static constexpr auto block_size = OneStep::block_size;
+
+void BitingTable::rebuild(const Population& population) {
+  const auto n = population.size();
+  const auto n_blocks = (n + block_size - 1) / block_size;
+  zeta_ = population.zeta_;
+  tree_.assign(n_blocks * (block_size + 1), 0.0);
+  births_.assign(n_blocks, 0);
+  for (std::size_t block = 0; block < n_blocks; ++block) {
+    build(block);
+  }
+  bitten_.assign(n, 0);
+  marked_.clear();
+}
+
+// Build the tree of block in O(block_size) by pushing every node's sum up to
+// its parent.
+void BitingTable::build(const std::size_t block) {
+  const auto begin = block * block_size;
+  const auto size = std::min(block_size, zeta_.size() - begin);
+  auto* tree = tree_.data() + block * (block_size + 1);
+  std::fill(tree, tree + block_size + 1, 0.0);
+  for (std::size_t k = 1; k <= size; ++k) {
+    tree[k] += zeta_[begin + k - 1];
+    const auto parent = k + (k & -k);
+    if (parent <= size) {
+      tree[parent] += tree[k];
+    }
+  }
+  births_[block] = 0;
+}
+
+void BitingTable::add(std::size_t index, const double delta) noexcept {
+  const auto block = index / block_size;
+  const auto size = std::min(block_size, zeta_.size() - block * block_size);
+  auto* tree = tree_.data() + block * (block_size + 1);
+  for (auto k = index % block_size + 1; k <= size; k += k & -k) {
+    tree[k] += delta;
+  }
+}
+
+double BitingTable::total(const std::size_t block) const noexcept {
+  const auto* tree = tree_.data() + block * (block_size + 1);
+  auto sum = 0.0;
+  for (auto k = std::min(block_size, zeta_.size() - block * block_size); k > 0;
+       k -= k & -k) {
+    sum += tree[k];
+  }
+  return sum;
+}
+
+double BitingTable::total() const noexcept {
+  auto sum = 0.0;
+  for (std::size_t block = 0; block < births_.size(); ++block) {
+    sum += total(block);
+  }
+  return sum;
+}
+
+// Index of the individual whose share of [0, total(block)) holds u.
+std::size_t BitingTable::find(const std::size_t block,
+                              double u) const noexcept {
+  const auto begin = block * block_size;
+  const auto size = std::min(block_size, zeta_.size() - begin);
+  const auto* tree = tree_.data() + block * (block_size + 1);
+  std::size_t position = 0;
+  std::size_t step = 1;
+  while (step * 2 <= size) {
+    step *= 2;
+  }
+  for (; step > 0; step /= 2) {
+    if (position + step <= size && tree[position + step] <= u) {
+      position += step;
+      u -= tree[position];
+    }
+  }
+  // Rounding can leave u just past the last share.
+  return begin + std::min(position, size - 1);
+}
+
+const char* BitingTable::allocate(const Population& population,
+                                  const Parameters& params,
+                                  const ImmunityFunctions& functions,
+                                  const double eir, const double dt,
+                                  const RandomStreams& streams,
+                                  const std::uint64_t epoch,
+                                  const std::size_t first_block) {
+  const auto n = population.size();
+  if (zeta_.size() != n) {
+    rebuild(population);
+  }
+  for (const auto i : marked_) {
+    bitten_[i] = 0;
+  }
+  marked_.clear();
+
+  candidates_ = 0;
+  for (std::size_t block = 0; block < births_.size(); ++block) {
+    if (births_[block] >= block_size) {
+      build(block);
+    }
+    auto rng = streams.stream(epoch, first_block + block);
+    const auto total = this->total(block);
+    const auto mean = dt * eir * params.b_max * total;
+    const auto candidates =
+        mean > 0.0 ? std::poisson_distribution<std::uint64_t>(mean)(rng) : 0;
+    for (std::size_t c = 0; c < candidates; ++c) {
+      const auto i = find(block, rng.uniform() * total);
+      const auto keep = functions.psi(population.age_[i]) *
+                        functions.b(population.I_B_[i]) / params.b_max;
+      if (rng.uniform() < keep && !bitten_[i]) {
+        bitten_[i] = 1;
+        marked_.push_back(i);
+      }
+    }
+    candidates_ += candidates;
+  }
+  return bitten_.data();
+}
+
+void BitingTable::born(const Population& population,
+                       const std::size_t index) noexcept {
+  const auto zeta = population.zeta_[index];
+  add(index, zeta - zeta_[index]);
+  zeta_[index] = zeta;
+  ++births_[index / block_size];
+}
+
+}  // namespace griffin
+}  // namespace falciparum
+}  // namespace plasx
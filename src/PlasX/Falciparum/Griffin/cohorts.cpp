@@ -0,0 +1,173 @@
+#include "PlasX/Falciparum/Griffin/cohorts.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+
+#include "PlasX/Falciparum/Griffin/immunity.hpp"
+#include "PlasX/Falciparum/Griffin/turnover.hpp"
+#include "PlasX/udl.hpp"
+
+namespace plasx {
+namespace falciparum {
+namespace griffin {
+
+Cohorts::Cohorts(std::vector<double> age_edges, std::vector<double> IB_edges)
+    : age_edges_(std::move(age_edges)),
+      IB_edges_(std::move(IB_edges)),
+      cohorts_(age_edges_.size() * IB_edges_.size(), Cohort{}) {}
+
+std::vector<double> Cohorts::default_age_edges() {
+  std::vector<double> edges;
+  for (auto year = 0; year < 100; ++year) {
+    edges.push_back(year * 1.0_yrs);
+  }
+  return edges;
+}
+
+std::vector<double> Cohorts::default_IB_edges() {
+  std::vector<double> edges = {0.0};
+  for (auto edge = 0.25; edge <= 1024.0; edge *= 2.0) {
+    edges.push_back(edge);
+  }
+  return edges;
+}
+
+std::size_t Cohorts::bin(const double age, const double IB) const noexcept {
+  auto index = [](const std::vector<double>& edges, const double x) {
+    const auto upper = std::upper_bound(edges.begin(), edges.end(), x);
+    return upper == edges.begin() ? 0 : upper - edges.begin() - 1;
+  };
+  return index(age_edges_, age) * IB_edges_.size() + index(IB_edges_, IB);
+}
+
+void Cohorts::add(const std::size_t bin, const Cohort& cohort) noexcept {
+  // Keep the means of everyone in the bin.
+  auto& into = cohorts_[bin];
+  const auto count = into.count + cohort.count;
+  if (count == 0) {
+    return;
+  }
+  const auto share = static_cast<double>(cohort.count) / count;
+  into.age += share * (cohort.age - into.age);
+  into.I_CA += share * (cohort.I_CA - into.I_CA);
+  into.I_CM += share * (cohort.I_CM - into.I_CM);
+  into.I_A += share * (cohort.I_A - into.I_A);
+  into.I_B += share * (cohort.I_B - into.I_B);
+  into.zeta += share * (cohort.zeta - into.zeta);
+  into.count = count;
+}
+
+const ImmunityFunctions& Cohorts::functions(const Parameters& params) {
+  if (!params_ || !(*params_ == params)) {
+    params_ = params;
+    functions_.emplace(params);
+  }
+  return *functions_;
+}
+
+std::uint64_t Cohorts::count() const noexcept {
+  std::uint64_t total = 0;
+  for (const auto& cohort : cohorts_) {
+    total += cohort.count;
+  }
+  return total;
+}
+
+void Cohorts::absorb(Population& agents) {
+  std::size_t kept = 0;
+  for (std::size_t i = 0; i < agents.size(); ++i) {
+    const auto settled =
+        agents.current_[i] == Status::S &&
+        agents.next_infection_[i] == std::numeric_limits<double>::infinity() &&
+        agents.overflow_[i] == InfectionPool::none;
+    if (settled) {
+      add(bin(agents.age_[i], agents.I_B_[i]),
+          {1, agents.age_[i], agents.I_CA_[i], agents.I_CM_[i], agents.I_A_[i],
+           agents.I_B_[i], agents.zeta_[i]});
+      continue;
+    }
+    if (kept != i) {
+      agents.relocate(i, kept);
+    }
+    ++kept;
+  }
+  agents.truncate(kept);
+}
+
+void Cohorts::step(const double t, const double dt, const Parameters& params,
+                   const double eir, Population& agents, Xoshiro256& rng,
+                   Infectiousness& humans) {
+  const auto& f = functions(params);
+  const auto decay = immunity_decay(params, dt);
+  const auto death = 1.0 - std::exp(-params.mu_d * dt);
+
+  // The mothers are counted before anyone ages, as in OneStep.
+  Mothers mothers;
+  for (std::size_t i = 0; i < agents.size(); ++i) {
+    mothers.add(agents.age_[i], agents.I_CA_[i]);
+  }
+
+  std::uint64_t dead = 0;
+  died_.clear();
+  for (auto& cohort : cohorts_) {
+    if (cohort.count == 0) {
+      continue;
+    }
+    const auto lambda =
+        eir * f.psi(cohort.age) * f.b(cohort.I_B) * cohort.zeta;
+    const auto infection = 1.0 - std::exp(-dt * lambda);
+    const auto infected = std::binomial_distribution<std::uint64_t>(
+        cohort.count, infection)(rng);
+    for (std::uint64_t k = 0; k < infected; ++k) {
+      agents.emplace_back(cohort.age, Status::S, cohort.I_CA, cohort.I_CM,
+                          cohort.I_A);
+      agents.I_B_.back() = cohort.I_B;
+      agents.zeta_.back() = cohort.zeta;
+      auto agent = agents[agents.size() - 1];
+      agent.scheduleInfection(t);
+      agent.boostBiteImmunity();
+    }
+    // As for an agent in S, only those who were not infected can die.
+    const auto deaths = std::binomial_distribution<std::uint64_t>(
+        cohort.count - infected, death)(rng);
+    cohort.count -= infected + deaths;
+    dead += deaths;
+    if (deaths > 0) {
+      died_.push_back(cohort);
+      died_.back().count = deaths;
+    }
+    humans.add(cohort.count * f.psi(cohort.age) * cohort.zeta, Status::S);
+
+    const auto mother = cohort.age >= maternal_age_min &&
+                        cohort.age < maternal_age_max && cohort.count > 0;
+    if (mother) {
+      mothers.merge(Mothers(cohort.count * cohort.I_CA, cohort.count));
+    }
+    cohort.age += dt;
+    cohort.I_CA *= decay.I_CA;
+    cohort.I_CM *= decay.I_CM;
+    cohort.I_A *= decay.I_A;
+    cohort.I_B *= decay.I_B;
+  }
+
+  // Move any bin that has drifted over an edge.
+  next_.assign(cohorts_.size(), Cohort{});
+  std::swap(next_, cohorts_);
+  for (const auto& cohort : next_) {
+    if (cohort.count > 0) {
+      add(bin(cohort.age, cohort.I_B), cohort);
+    }
+  }
+
+  if (dead > 0) {
+    humans.add(dead * f.psi(0.0), Status::S);
+    add(bin(0.0, 0.0),
+        {dead, 0.0, 0.0, mothers.newborn_ICM(params), 0.0, 0.0, 1.0});
+  }
+}
+
+}  // namespace griffin
+}  // namespace falciparum
+}  // namespace plasx
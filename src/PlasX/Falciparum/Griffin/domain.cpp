@@ -0,0 +1,102 @@
+#include "PlasX/Falciparum/Griffin/domain.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "PlasX/Falciparum/Griffin/recorder.hpp"
+#include "PlasX/Falciparum/Griffin/snapshot.hpp"
+#include "PlasX/Falciparum/griffin.hpp"
+
+namespace plasx {
+namespace falciparum {
+namespace griffin {
+
+Domain::Domain(Communicator& communicator, const std::size_t n)
+    : communicator_(communicator),
+      n_(n),
+      n_blocks_((n + OneStep::block_size - 1) / OneStep::block_size) {
+  const auto rank = communicator.rank(), size = communicator.size();
+  const auto first = n_blocks_ * rank / size;
+  const auto last = n_blocks_ * (rank + 1) / size;
+  begin_ = std::min(n, first * OneStep::block_size);
+  end_ = std::min(n, last * OneStep::block_size);
+}
+
+std::size_t Domain::first_block() const noexcept {
+  return begin_ / OneStep::block_size;
+}
+
+Population Domain::shard(const Population& whole) const {
+  Population shard;
+  shard.reserve(end_ - begin_);
+  for (auto i = begin_; i < end_; ++i) {
+    shard.append(whole, i);
+  }
+  return shard;
+}
+
+Population Domain::shard(
+    const std::function<void(std::size_t, Population&)>& add) const {
+  Population shard;
+  shard.reserve(end_ - begin_);
+  for (auto i = begin_; i < end_; ++i) {
+    add(i, shard);
+    if (shard.size() != i + 1 - begin_) {
+      throw std::logic_error("Each index must add one individual to a shard.");
+    }
+  }
+  return shard;
+}
+
+Population Domain::shard(const Snapshot& whole) const {
+  if (whole.size() != n_) {
+    throw std::invalid_argument(
+        "The snapshot is not of the population the domain was made for.");
+  }
+  Population shard;
+  whole.restore(shard, begin_, end_);
+  return shard;
+}
+
+void Domain::share(std::vector<Mothers>& mothers,
+                   std::vector<Infectiousness>& humans) const {
+  // Every block is given its own place, and zero everywhere else, so the sum
+  // over processes is exact.
+  constexpr std::size_t width = 2 + n_status;
+  thread_local std::vector<double> blocks;
+  blocks.assign(n_blocks_ * width, 0.0);
+  auto* mine = blocks.data() + first_block() * width;
+  for (std::size_t b = 0; b < mothers.size(); ++b) {
+    auto* block = mine + b * width;
+    block[0] = mothers[b].sum();
+    block[1] = mothers[b].count();
+    for (std::size_t s = 0; s < n_status; ++s) {
+      block[2 + s] = humans[b].weight(static_cast<Status>(s));
+    }
+  }
+  communicator_.all_reduce_sum(blocks.data(), blocks.size());
+
+  mothers.clear();
+  humans.assign(n_blocks_, Infectiousness());
+  for (std::size_t b = 0; b < n_blocks_; ++b) {
+    const auto* block = blocks.data() + b * width;
+    mothers.emplace_back(block[0], static_cast<std::size_t>(block[1]));
+    for (std::size_t s = 0; s < n_status; ++s) {
+      humans[b].add(block[2 + s], static_cast<Status>(s));
+    }
+  }
+}
+
+void Domain::gather(const Recorder& recorder, const double t,
+                    std::vector<double>& row) const {
+  row.resize(Recorder::column_names(recorder.bands()).size());
+  recorder.fill_row(t, row.data());
+  // Everything but the time is a count.
+  row[0] = 0.0;
+  communicator_.all_reduce_sum(row.data(), row.size());
+  row[0] = t;
+}
+
+}  // namespace griffin
+}  // namespace falciparum
+}  // namespace plasx
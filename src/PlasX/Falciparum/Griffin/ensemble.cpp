@@ -0,0 +1,114 @@
+#include "PlasX/Falciparum/Griffin/ensemble.hpp"
+
+#include "PlasX/Falciparum/Griffin/recorder.hpp"
+#include "PlasX/Falciparum/griffin.hpp"
+#include "PlasX/random.hpp"
+
+namespace plasx {
+namespace falciparum {
+namespace griffin {
+
+static std::vector<std::string> ensemble_columns(const std::size_t bands) {
+  auto names = Recorder::column_names(bands);
+  names.insert(names.begin(), {"scenario", "replicate"});
+  return names;
+}
+
+EnsembleOutput::EnsembleOutput(const std::string& path,
+                               std::vector<double> band_edges,
+                               std::size_t chunk_rows)
+    : edges_(std::move(band_edges)),
+      writer_(path, ensemble_columns(edges_.size()), chunk_rows) {}
+
+std::size_t EnsembleOutput::reserve(const std::size_t count) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const auto first = reserved_;
+  reserved_ += count;
+  return first;
+}
+
+void EnsembleOutput::append(const std::size_t place,
+                            const std::vector<double>& rows,
+                            const std::size_t n_rows) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (place != next_) {
+    waiting_.emplace(place, std::vector<double>(
+                                rows.begin(), rows.begin() + n_rows * width()));
+    return;
+  }
+  for (std::size_t r = 0; r < n_rows; ++r) {
+    writer_.write_row(rows.data() + r * width());
+  }
+  ++next_;
+  // Then everything that was waiting on this place.
+  for (auto it = waiting_.begin();
+       it != waiting_.end() && it->first == next_; it = waiting_.erase(it)) {
+    for (std::size_t r = 0; r < it->second.size() / width(); ++r) {
+      writer_.write_row(it->second.data() + r * width());
+    }
+    ++next_;
+  }
+}
+
+void EnsembleOutput::flush() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  writer_.flush();
+}
+
+std::unique_ptr<Population> Ensemble::acquire() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (free_.empty()) {
+    ++allocated_;
+    return std::make_unique<Population>();
+  }
+  auto buffer = std::move(free_.back());
+  free_.pop_back();
+  return buffer;
+}
+
+void Ensemble::release(std::unique_ptr<Population> buffer) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  free_.push_back(std::move(buffer));
+}
+
+void Ensemble::run(const std::vector<Scenario>& scenarios,
+                   const std::size_t replicates, const Population& initial,
+                   const double t0, const double t1, const double dt,
+                   EnsembleOutput& output, const std::uint64_t seed) {
+  const RandomStreams ensemble(seed);
+  const auto width = output.width();
+  const auto tasks = scenarios.size() * replicates;
+  const auto first = output.reserve(tasks);
+  pool_.parallel_for(tasks, [&](std::size_t task) {
+    const auto scenario = task / replicates;
+    const auto replicate = task % replicates;
+    const auto& [params, eir] = scenarios[scenario];
+
+    // Copy assignment keeps the capacity of the buffer.
+    auto population = acquire();
+    *population = initial;
+    RandomStreams streams(ensemble.key(scenario, replicate));
+    Recorder recorder(output.band_edges());
+
+    thread_local std::vector<double> rows;
+    rows.clear();
+    std::size_t n_rows = 0;
+    auto t = t0;
+    while (t < t1) {
+      t = one_step(t, dt, *population, params, eir, streams, recorder);
+      rows.resize((n_rows + 1) * width);
+      auto* row = rows.data() + n_rows * width;
+      row[0] = scenario;
+      row[1] = replicate;
+      recorder.fill_row(t, row + 2);
+      ++n_rows;
+    }
+    release(std::move(population));
+    output.append(first + task, rows, n_rows);
+  });
+  output.flush();
+}
+
+}  // namespace griffin
+}  // namespace falciparum
+}  // namespace plasx
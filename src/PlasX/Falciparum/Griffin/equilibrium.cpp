@@ -0,0 +1,329 @@
+#include "PlasX/Falciparum/Griffin/equilibrium.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "PlasX/Falciparum/Griffin/biting.hpp"
+#include "PlasX/Falciparum/Griffin/immunity.hpp"
+#include "PlasX/Falciparum/Griffin/immunity_functions.hpp"
+#include "PlasX/Falciparum/Griffin/population.hpp"
+#include "PlasX/Falciparum/Griffin/turnover.hpp"
+
+namespace plasx {
+namespace falciparum {
+namespace griffin {
+
+// The cohort is followed until all but this share of it has died.
+static constexpr double survivors = 1e-9;
+// Largest number of times the cohort is stepped through life while the
+// maternal immunity settles.
+static constexpr int max_passes = 50;
+// Profiles are kept for every step up to 1 / resolution steps, and then at
+// steps this far apart relative to the age.
+static constexpr double resolution = 1.0 / 128.0;
+// Number of Gauss-Hermite nodes that zeta is integrated over.
+static constexpr std::size_t n_nodes = 9;
+
+// Nodes z and weights w of the Gauss-Hermite rule for the standard normal, so
+// that E[f(Z)] is about the sum of w * f(z), in increasing order of z. The
+// roots of the Hermite polynomial are found by Newton's method, from the
+// usual initial guesses (Numerical Recipes, gauher).
+static void gauss_hermite(std::vector<double>& z, std::vector<double>& w) {
+  const auto n = n_nodes;
+  const auto pi = std::acos(-1.0);
+  std::vector<double> x(n);
+  w.assign(n, 0.0);
+  auto root = 0.0;
+  for (std::size_t i = 0; i < (n + 1) / 2; ++i) {
+    if (i == 0) {
+      root = std::sqrt(2.0 * n + 1.0) -
+             1.85575 * std::pow(2.0 * n + 1.0, -1.0 / 6.0);
+    } else if (i == 1) {
+      root -= 1.14 * std::pow(static_cast<double>(n), 0.426) / root;
+    } else if (i == 2) {
+      root = 1.86 * root - 0.86 * x[0];
+    } else if (i == 3) {
+      root = 1.91 * root - 0.91 * x[1];
+    } else {
+      root = 2.0 * root - x[i - 2];
+    }
+    // The orthonormal Hermite polynomials at root, and the derivative of the
+    // last.
+    auto p = 0.0, dp = 0.0;
+    for (int iteration = 0; iteration < 100; ++iteration) {
+      auto p1 = std::pow(pi, -0.25), p2 = 0.0;
+      for (std::size_t j = 0; j < n; ++j) {
+        const auto p3 = p2;
+        p2 = p1;
+        p1 = root * std::sqrt(2.0 / (j + 1.0)) * p2 -
+             std::sqrt(j / (j + 1.0)) * p3;
+      }
+      p = p1;
+      dp = std::sqrt(2.0 * n) * p2;
+      const auto previous = root;
+      root -= p / dp;
+      if (std::abs(root - previous) <= 1e-14) {
+        break;
+      }
+    }
+    x[i] = root;
+    x[n - 1 - i] = -root;
+    w[i] = w[n - 1 - i] = 2.0 / (dp * dp) / std::sqrt(pi);
+  }
+  z.resize(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    z[i] = std::sqrt(2.0) * x[n - 1 - i];
+  }
+  std::reverse(w.begin(), w.end());
+}
+
+// Weight of those aged [k * dt, (k + 1) * dt) relative to the newborns.
+static double weight(const double mu_d, const double dt, const std::size_t k) {
+  return std::exp(-mu_d * dt * k);
+}
+
+// Sums over a cohort's life, weighted by the share of the population of each
+// age.
+struct Totals {
+  std::array<double, n_status> share{};
+  double weight = 0.0;
+  double mothers_I_CA = 0.0;
+  double mothers = 0.0;
+};
+
+// Step a birth cohort with relative biting rate zeta, whose newborns have
+// maternal immunity ICM, through n_steps, keeping its profile at the start of
+// the steps in kept and adding it to totals at the start of every step.
+static void step_cohort(const Parameters& params,
+                        const ImmunityFunctions& functions, const double eir,
+                        const double zeta, const double dt, const double ICM,
+                        const std::size_t n_steps,
+                        const std::vector<std::size_t>& kept,
+                        std::vector<Equilibrium::Profile>& profiles,
+                        Totals& totals) {
+  constexpr auto S = static_cast<std::size_t>(Status::S);
+  constexpr auto A = static_cast<std::size_t>(Status::A);
+  constexpr auto U = static_cast<std::size_t>(Status::U);
+  constexpr auto D = static_cast<std::size_t>(Status::D);
+  constexpr auto T = static_cast<std::size_t>(Status::T);
+  constexpr auto P = static_cast<std::size_t>(Status::P);
+  using Shares = std::array<double, n_status>;
+  auto leave = [dt](const double rate) { return 1.0 - std::exp(-dt * rate); };
+  const auto decay = immunity_decay(params, dt);
+  // Where each compartment goes other than by infection, and the chance of
+  // going in a step, bar A's.
+  constexpr std::array<std::size_t, n_status> exit_to = {S, U, S, A, P, S};
+  Shares exit = {0.0, 0.0, leave(params.r_U), leave(params.r_D),
+                 leave(params.r_T), leave(params.r_P)};
+
+  // The share of the cohort in each compartment, and the sum of each
+  // immunity over those in it, so that immunity follows the individuals
+  // between compartments.
+  Shares p{}, I_CA{}, I_A{}, I_B{};
+  p[S] = 1.0;
+  std::size_t next_kept = 0;
+  for (std::size_t k = 0; k < n_steps; ++k) {
+    const auto age = k * dt;
+    const auto I_CM = ICM * std::exp(-age / params.d_M);
+    auto mean = [&p](const Shares& sum) {
+      Shares m{};
+      for (std::size_t s = 0; s < n_status; ++s) {
+        m[s] = p[s] > 0.0 ? sum[s] / p[s] : 0.0;
+      }
+      return m;
+    };
+    const auto mean_CA = mean(I_CA), mean_A = mean(I_A), mean_B = mean(I_B);
+    if (next_kept < kept.size() && kept[next_kept] == k) {
+      profiles[next_kept++] = {p, mean_CA, mean_A, mean_B, I_CM};
+    }
+    const auto w = weight(params.mu_d, dt, k);
+    for (std::size_t s = 0; s < n_status; ++s) {
+      totals.share[s] += w * p[s];
+    }
+    totals.weight += w;
+    if (age >= maternal_age_min && age < maternal_age_max) {
+      for (std::size_t s = 0; s < n_status; ++s) {
+        totals.mothers_I_CA += w * I_CA[s];
+      }
+      totals.mothers += w;
+    }
+
+    // The same rules as S_update, ..., P_update, for the mean individual of
+    // each compartment. Every bite is an infection, and both boost before the
+    // step's decay.
+    Shares q{}, J_CA{}, J_A{}, J_B{};
+    auto move = [&](const std::size_t from, const std::size_t to,
+                    const double share, const double boost) {
+      q[to] += share * p[from];
+      J_CA[to] += share * (I_CA[from] + boost * p[from]);
+      J_A[to] += share * (I_A[from] + boost * p[from]);
+      J_B[to] += share * (I_B[from] + boost * p[from]);
+    };
+    exit[A] = leave(functions.r_A(mean_A[A]));
+    for (const auto s : {S, A, U, D}) {
+      const auto bitten = 1.0 - std::exp(-dt * eir * functions.psi(age) *
+                                         functions.b(mean_B[s]) * zeta);
+      if (s == D) {
+        move(D, D, bitten, 1.0);
+      } else {
+        const auto phi = functions.phi(mean_CA[s] + I_CM);
+        move(s, A, bitten * (1.0 - phi), 1.0);
+        move(s, D, bitten * phi * (1.0 - params.f_T), 1.0);
+        move(s, T, bitten * phi * params.f_T, 1.0);
+      }
+      move(s, exit_to[s], (1.0 - bitten) * exit[s], 0.0);
+      move(s, s, (1.0 - bitten) * (1.0 - exit[s]), 0.0);
+    }
+    for (const auto s : {T, P}) {
+      move(s, exit_to[s], exit[s], 0.0);
+      move(s, s, 1.0 - exit[s], 0.0);
+    }
+    p = q;
+    for (std::size_t s = 0; s < n_status; ++s) {
+      I_CA[s] = J_CA[s] * decay.I_CA;
+      I_A[s] = J_A[s] * decay.I_A;
+      I_B[s] = J_B[s] * decay.I_B;
+    }
+  }
+}
+
+Equilibrium::Equilibrium(const Parameters& params, const double eir,
+                         const double dt)
+    : params_(params), mu_d_(params.mu_d), dt_(dt) {
+  if (!(params.mu_d > 0.0)) {
+    throw std::invalid_argument("The equilibrium needs mu_d > 0");
+  }
+  if (!(eir >= 0.0)) {
+    throw std::invalid_argument("The EIR must not be negative");
+  }
+  if (!(dt > 0.0)) {
+    throw std::invalid_argument("The step must be positive");
+  }
+  const ImmunityFunctions functions(params);
+  const auto oldest = -std::log(survivors) / params.mu_d;
+  const auto n_steps = static_cast<std::size_t>(std::ceil(oldest / dt)) + 1;
+  kept_.clear();
+  for (std::size_t k = 0; k < n_steps;
+       k += std::max<std::size_t>(1, k * resolution)) {
+    kept_.push_back(k);
+  }
+
+  // zeta is log-normal, exp(sigma * Z - sigma^2 / 2) for a standard normal Z.
+  // Without any spread a single node is exact.
+  std::vector<double> z{0.0};
+  weights_ = {1.0};
+  if (params.sigma > 0.0) {
+    gauss_hermite(z, weights_);
+  }
+  zeta_.clear();
+  bounds_.clear();
+  auto cumulative = 0.0;
+  for (std::size_t j = 0; j < z.size(); ++j) {
+    zeta_.push_back(std::exp(params.sigma * z[j] -
+                             0.5 * params.sigma * params.sigma));
+    cumulative += weights_[j];
+    bounds_.push_back(cumulative);
+  }
+  profiles_.assign(zeta_.size(), std::vector<Profile>(kept_.size()));
+
+  // Newborns get P_M times the mean I_CA of the mothers (see Mothers), over
+  // every zeta.
+  auto ICM = 0.0;
+  for (int pass = 0; pass < max_passes; ++pass) {
+    share_.fill(0.0);
+    auto mothers_I_CA = 0.0, mothers = 0.0;
+    for (std::size_t j = 0; j < zeta_.size(); ++j) {
+      Totals node;
+      step_cohort(params, functions, eir, zeta_[j], dt, ICM, n_steps, kept_,
+                  profiles_[j], node);
+      for (std::size_t s = 0; s < n_status; ++s) {
+        share_[s] += weights_[j] * node.share[s] / node.weight;
+      }
+      mothers_I_CA += weights_[j] * node.mothers_I_CA;
+      mothers += weights_[j] * node.mothers;
+    }
+    const auto next = mothers > 0.0 ? params.P_M * mothers_I_CA / mothers : 0.0;
+    if (std::abs(next - ICM) <= 1e-12 * std::max(1.0, next)) {
+      break;
+    }
+    ICM = next;
+  }
+}
+
+std::size_t Equilibrium::node(const double zeta) const noexcept {
+  if (zeta_.size() == 1) {
+    return 0;
+  }
+  // The share of the population with a smaller zeta, and the node whose share
+  // of the weights holds it.
+  const auto sigma = params_.sigma;
+  const auto z = (std::log(zeta) + 0.5 * sigma * sigma) / sigma;
+  const auto u = 0.5 * std::erfc(-z / std::sqrt(2.0));
+  const auto j = std::upper_bound(bounds_.begin(), bounds_.end(), u) -
+                 bounds_.begin();
+  return std::min(static_cast<std::size_t>(j), zeta_.size() - 1);
+}
+
+const Equilibrium::Profile& Equilibrium::at(const double age,
+                                            const double zeta) const noexcept {
+  // The last profile kept at or before the step of age.
+  const auto k = static_cast<std::size_t>(std::max(age, 0.0) / dt_);
+  const auto kept = std::upper_bound(kept_.begin(), kept_.end(), k) -
+                    kept_.begin() - 1;
+  return profiles_[node(zeta)][kept];
+}
+
+double Equilibrium::share(const Status status) const noexcept {
+  return share_[static_cast<std::size_t>(status)];
+}
+
+template <class ForBlocks>
+void Equilibrium::fill(Population& population, const std::size_t n,
+                       RandomStreams& streams, ForBlocks for_blocks) const {
+  population.truncate(0);
+  population.resize(n);
+  const auto n_blocks = (n + OneStep::block_size - 1) / OneStep::block_size;
+  const auto epoch = streams.next_epoch();
+  for_blocks(n_blocks, [&](const std::size_t block) {
+    auto rng = streams.stream(epoch, block);
+    const auto begin = block * OneStep::block_size;
+    const auto end = std::min(n, begin + OneStep::block_size);
+    for (auto i = begin; i < end; ++i) {
+      const auto age = -std::log1p(-rng.uniform()) / mu_d_;
+      const auto zeta = draw_zeta(params_, rng);
+      const auto& profile = at(age, zeta);
+      // The compartment that u falls in, by the shares of the age.
+      auto u = rng.uniform();
+      std::size_t s = 0;
+      while (s + 1 < n_status && u >= profile.share[s]) {
+        u -= profile.share[s++];
+      }
+      population.assign(i, age, static_cast<Status>(s), profile.I_CA[s],
+                        profile.I_CM, profile.I_A[s], zeta);
+      population.I_B_[i] = profile.I_B[s];
+    }
+  });
+}
+
+void Equilibrium::fill(Population& population, const std::size_t n,
+                       ThreadPool& pool, RandomStreams& streams) const {
+  fill(population, n, streams,
+       [&pool](const std::size_t n_blocks, const auto& block) {
+         pool.parallel_for(n_blocks, block);
+       });
+}
+
+void Equilibrium::fill(Population& population, const std::size_t n,
+                       RandomStreams& streams) const {
+  fill(population, n, streams,
+       [](const std::size_t n_blocks, const auto& block) {
+         for (std::size_t i = 0; i < n_blocks; ++i) {
+           block(i);
+         }
+       });
+}
+
+}  // namespace griffin
+}  // namespace falciparum
+}  // namespace plasx
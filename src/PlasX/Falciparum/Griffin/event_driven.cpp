@@ -0,0 +1,261 @@
+#include "PlasX/Falciparum/Griffin/event_driven.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "PlasX/Falciparum/Griffin/biting.hpp"
+#include "PlasX/Falciparum/Griffin/turnover.hpp"
+
+namespace plasx {
+namespace falciparum {
+namespace griffin {
+
+// Order the calendar so that the earliest event is at the front of the heap.
+constexpr auto later = [](const auto& a, const auto& b) {
+  return a.time > b.time;
+};
+
+double EventDriven::exit_rate(const std::size_t i, const Population& population,
+                              const Parameters& params) const {
+  // Rate of leaving the current compartment by any route other than infection.
+  switch (population.current_[i]) {
+    case Status::S:
+      return 0.0;
+    case Status::A:
+      return functions_->r_A(population.I_A_[i]);
+    case Status::U:
+      return params.r_U;
+    case Status::D:
+      return params.r_D;
+    case Status::T:
+      return params.r_T;
+    case Status::P:
+      return params.r_P;
+  }
+  return 0.0;
+}
+
+double EventDriven::exit_bound(const std::size_t i,
+                               const Population& population,
+                               const Parameters& params) const {
+  // Bound on exit_rate until the next candidate of i. Only r_A changes
+  // between candidates: I_A decays towards 0, and r_A is monotone in I_A, so
+  // it stays between its value now and r_A0.
+  if (population.current_[i] == Status::A) {
+    return std::max(functions_->r_A(population.I_A_[i]), params.r_A0);
+  }
+  return exit_rate(i, population, params);
+}
+
+// Bound on the force of infection until the next candidate of i, as psi <= 1
+// and b <= b_max.
+static double infection_bound(const double eir, const double zeta,
+                              const Parameters& params) {
+  return eir * params.b_max * zeta;
+}
+
+void EventDriven::schedule(const std::size_t i, const double t,
+                           const Population& population,
+                           const Parameters& params) {
+  // Infections only change the state of individuals in S, A, U and D. In D
+  // they return the individual to D and only boost their immunity.
+  const auto status = population.current_[i];
+  const auto infectable = status == Status::S || status == Status::A ||
+                          status == Status::U || status == Status::D;
+  const auto infection =
+      infectable ? infection_bound(eir_, population.zeta_[i], params) : 0.0;
+  const auto rate = infection + exit_bound(i, population, params) + params.mu_d;
+  if (rate <= 0.0) {
+    return;
+  }
+  const auto wait = -std::log1p(-rng_.uniform()) / rate;
+  calendar_.push_back({t + wait, static_cast<std::uint32_t>(i)});
+  std::push_heap(calendar_.begin(), calendar_.end(), later);
+}
+
+void EventDriven::rebuild(const double t, Population& population,
+                          const Parameters& params, const double eir) {
+  if (!params_ || !(*params_ == params)) {
+    params_ = params;
+    functions_.emplace(params);
+  }
+  const auto n = population.size();
+  catch_up(population, 0, n, params, t);
+  eir_ = eir;
+
+  // Waiting times are memoryless, so throwing away the old calendar and
+  // sampling afresh from t does not change the dynamics.
+  calendar_.clear();
+  calendar_.reserve(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    schedule(i, t, population, params);
+  }
+  count_mothers(t, population);
+}
+
+void EventDriven::count_mothers(const double t, const Population& population) {
+  // Everyone is caught up to t. The sums start again from scratch, so rounding
+  // errors do not build up.
+  const auto n = population.size();
+  born_.resize(n);
+  mother_ICA_.assign(n, std::numeric_limits<double>::quiet_NaN());
+  mothers_sum_ = 0.0;
+  mothers_count_ = 0;
+  ageing_.clear();
+  for (std::size_t i = 0; i < n; ++i) {
+    born_[i] = t - population.age_[i];
+    track_mother(i, t, population);
+  }
+}
+
+void EventDriven::track_mother(const std::size_t i, const double t,
+                               const Population& population) {
+  // Whether i is a mother at t, and when that next changes.
+  const auto age = t - born_[i];
+  const auto mother = age >= maternal_age_min && age < maternal_age_max;
+  if (!std::isnan(mother_ICA_[i])) {
+    mothers_sum_ -= mother_ICA_[i];
+    --mothers_count_;
+    mother_ICA_[i] = std::numeric_limits<double>::quiet_NaN();
+  }
+  if (mother) {
+    mother_ICA_[i] = population.I_CA_[i];
+    mothers_sum_ += mother_ICA_[i];
+    ++mothers_count_;
+  }
+  if (age < maternal_age_max) {
+    const auto boundary =
+        age < maternal_age_min ? maternal_age_min : maternal_age_max;
+    ageing_.push_back({born_[i] + boundary, static_cast<std::uint32_t>(i)});
+    std::push_heap(ageing_.begin(), ageing_.end(), later);
+  }
+}
+
+void EventDriven::update_mother(const std::size_t i,
+                                const Population& population) {
+  if (!std::isnan(mother_ICA_[i])) {
+    mothers_sum_ += population.I_CA_[i] - mother_ICA_[i];
+    mother_ICA_[i] = population.I_CA_[i];
+  }
+}
+
+void EventDriven::run_ageing(const double t, const Population& population) {
+  while (!ageing_.empty() && ageing_.front().time <= t) {
+    std::pop_heap(ageing_.begin(), ageing_.end(), later);
+    const auto [time, i] = ageing_.back();
+    ageing_.pop_back();
+    // Anyone who died since was born again later, and their crossings moved
+    // with them.
+    if (time == born_[i] + maternal_age_min ||
+        time == born_[i] + maternal_age_max) {
+      track_mother(i, time, population);
+    }
+  }
+}
+
+double EventDriven::force_of_infection(const std::size_t i,
+                                      const Population& population) const {
+  // Same force of infection as OneStep.
+  const auto b = functions_->b(population.I_B_[i]);
+  const auto psi = functions_->psi(population.age_[i]);
+  return eir_ * psi * b * population.zeta_[i];
+}
+
+bool EventDriven::fire(const std::size_t i, const double t,
+                       Population& population, const Parameters& params) {
+  // The bounds that i was scheduled with, then the rates now.
+  auto& status = population.current_[i];
+  const auto infectable = status == Status::S || status == Status::A ||
+                          status == Status::U || status == Status::D;
+  const auto infection_max =
+      infectable ? infection_bound(eir_, population.zeta_[i], params) : 0.0;
+  const auto exit_max = exit_bound(i, population, params);
+  const auto r = rng_.uniform() * (infection_max + exit_max + params.mu_d);
+  catch_up(population, i, i + 1, params, t);
+
+  if (r < infection_max) {
+    if (r >= force_of_infection(i, population)) {
+      return false;  // Thinned.
+    }
+    // As in S_update and SAU_infection, or D_update.
+    population.I_B_[i] += 1.0;
+    const auto I_C = population.I_CA_[i] + population.I_CM_[i];
+    const auto phi = functions_->phi(I_C);
+    population.I_CA_[i] += 1.0;
+    population.I_A_[i] += 1.0;
+    if (status == Status::D) {
+      return false;
+    }
+    if (rng_.uniform() > phi) {
+      status = Status::A;
+    } else if (rng_.uniform() <= params.f_T) {
+      status = Status::T;
+    } else {
+      status = Status::D;
+    }
+    return false;
+  }
+  if (r >= infection_max + exit_max) {
+    return true;  // Death.
+  }
+  if (r - infection_max >= exit_rate(i, population, params)) {
+    return false;  // Thinned.
+  }
+
+  switch (status) {
+    case Status::A:
+      status = Status::U;
+      break;
+    case Status::U:
+      status = Status::S;
+      break;
+    case Status::D:
+      status = Status::A;
+      break;
+    case Status::T:
+      status = Status::P;
+      break;
+    case Status::P:
+      status = Status::S;
+      break;
+    case Status::S:
+      break;
+  }
+  return false;
+}
+
+double EventDriven::operator()(const double t, const double dt,
+                               Population& population, const Parameters& params,
+                               double eir) {
+  if (eir != eir_ || born_.size() != population.size() || !params_ ||
+      !(*params_ == params)) {
+    rebuild(t, population, params, eir);
+  }
+
+  const auto t_end = t + dt;
+  while (!calendar_.empty() && calendar_.front().time < t_end) {
+    std::pop_heap(calendar_.begin(), calendar_.end(), later);
+    const auto [time, i] = calendar_.back();
+    calendar_.pop_back();
+    ++events_;
+    run_ageing(time, population);
+    if (fire(i, time, population, params)) {
+      // A newborn takes the place of the dead.
+      const Mothers mothers(mothers_sum_, mothers_count_);
+      give_birth(population, i, mothers.newborn_ICM(params), time,
+                 draw_zeta(params, rng_));
+      born_[i] = time;
+      track_mother(i, time, population);
+    } else {
+      update_mother(i, population);
+    }
+    schedule(i, time, population, params);
+  }
+  run_ageing(t_end, population);
+  return t_end;
+}
+
+}  // namespace griffin
+}  // namespace falciparum
+}  // namespace plasx
@@ -0,0 +1,214 @@
+#include "PlasX/Falciparum/Griffin/event_log.hpp"
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace plasx {
+namespace falciparum {
+namespace griffin {
+
+static constexpr char magic[8] = {'P', 'L', 'A', 'S', 'X', 'E', 'V', 'T'};
+static constexpr std::uint32_t version = 1;
+static constexpr std::uint32_t n_columns = 5;
+// Chunks waiting to be written before end_step waits for the writer.
+static constexpr std::size_t queue_limit = 2;
+
+template <class T>
+static void put(std::ofstream& file, const T& value) {
+  file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <class T>
+static T get(std::ifstream& file) {
+  T value;
+  file.read(reinterpret_cast<char*>(&value), sizeof(T));
+  return value;
+}
+
+template <class T>
+static void append(std::vector<T>& into, const std::vector<T>& from) {
+  into.insert(into.end(), from.begin(), from.end());
+}
+
+void EventBuffer::clear() noexcept {
+  individual_.clear();
+  event_.clear();
+  from_.clear();
+  to_.clear();
+}
+
+EventLog::EventLog(const std::string& path, std::size_t chunk_records,
+                   int level)
+    : file_(path, std::ios::binary),
+      path_(path),
+      chunk_records_(std::max<std::size_t>(chunk_records, 1)),
+      level_(level) {
+  if (!file_) {
+    throw std::runtime_error("Could not open " + path + " for writing");
+  }
+  file_.write(magic, sizeof(magic));
+  put(file_, version);
+  put(file_, n_columns);
+  writer_ = std::thread([this] { write_chunks(); });
+}
+
+EventLog::~EventLog() {
+  try {
+    close();
+  } catch (...) {
+  }
+}
+
+void EventLog::start_step(const std::size_t n_blocks) {
+  buffers_.resize(n_blocks);
+  for (auto& buffer : buffers_) {
+    buffer.clear();
+  }
+}
+
+void EventLog::end_step(const double t) {
+  for (const auto& buffer : buffers_) {
+    chunk_.time.insert(chunk_.time.end(), buffer.size(), t);
+    append(chunk_.individual, buffer.individual_);
+    append(chunk_.event, buffer.event_);
+    append(chunk_.from, buffer.from_);
+    append(chunk_.to, buffer.to_);
+    records_ += buffer.size();
+  }
+  if (chunk_.time.size() >= chunk_records_) {
+    hand_off();
+  }
+}
+
+void EventLog::hand_off() {
+  std::unique_lock lock(mutex_);
+  changed_.wait(lock, [this] { return queue_.size() < queue_limit; });
+  if (failed_) {
+    throw std::runtime_error("Could not write to " + path_);
+  }
+  queue_.push_back(std::move(chunk_));
+  chunk_ = Chunk();
+  changed_.notify_all();
+}
+
+void EventLog::close() {
+  if (closed_) {
+    return;
+  }
+  closed_ = true;
+  {
+    std::lock_guard lock(mutex_);
+    if (!chunk_.time.empty()) {
+      queue_.push_back(std::move(chunk_));
+    }
+    closing_ = true;
+  }
+  changed_.notify_all();
+  writer_.join();
+  file_.close();
+  if (failed_ || !file_) {
+    throw std::runtime_error("Could not write to " + path_);
+  }
+}
+
+// Compress one column into the file, preceded by its compressed size.
+template <class T>
+static bool write_column(std::ofstream& file, const std::vector<T>& column,
+                         const int level, std::vector<Bytef>& compressed) {
+  const auto bytes = column.size() * sizeof(T);
+  auto size = compressBound(bytes);
+  compressed.resize(size);
+  if (compress2(compressed.data(), &size,
+                reinterpret_cast<const Bytef*>(column.data()), bytes,
+                level) != Z_OK) {
+    return false;
+  }
+  put(file, static_cast<std::uint64_t>(size));
+  file.write(reinterpret_cast<const char*>(compressed.data()), size);
+  return static_cast<bool>(file);
+}
+
+void EventLog::write_chunks() {
+  std::vector<Bytef> compressed;
+  while (true) {
+    Chunk chunk;
+    {
+      std::unique_lock lock(mutex_);
+      changed_.wait(lock, [this] { return closing_ || !queue_.empty(); });
+      if (queue_.empty()) {
+        return;
+      }
+      chunk = std::move(queue_.front());
+      queue_.pop_front();
+    }
+
+    put(file_, static_cast<std::uint64_t>(chunk.time.size()));
+    const auto written =
+        write_column(file_, chunk.time, level_, compressed) &&
+        write_column(file_, chunk.individual, level_, compressed) &&
+        write_column(file_, chunk.event, level_, compressed) &&
+        write_column(file_, chunk.from, level_, compressed) &&
+        write_column(file_, chunk.to, level_, compressed);
+
+    std::lock_guard lock(mutex_);
+    failed_ = failed_ || !written;
+    changed_.notify_all();
+  }
+}
+
+// Read one column of records values, as written by write_column.
+template <class T>
+static void read_column(std::ifstream& file, const std::string& path,
+                        const std::uint64_t records, std::vector<T>& column,
+                        std::vector<Bytef>& compressed) {
+  compressed.resize(get<std::uint64_t>(file));
+  file.read(reinterpret_cast<char*>(compressed.data()), compressed.size());
+  const auto start = column.size();
+  column.resize(start + records);
+  uLongf bytes = records * sizeof(T);
+  const auto status =
+      uncompress(reinterpret_cast<Bytef*>(column.data() + start), &bytes,
+                 compressed.data(), compressed.size());
+  if (!file || status != Z_OK || bytes != records * sizeof(T)) {
+    throw std::runtime_error(path + " has a damaged chunk");
+  }
+}
+
+EventTable read_event_log(const std::string& path) {
+  std::ifstream file(path, std::ios::binary);
+  char header[sizeof(magic)];
+  file.read(header, sizeof(header));
+  if (!file || std::memcmp(header, magic, sizeof(magic)) != 0 ||
+      get<std::uint32_t>(file) != version ||
+      get<std::uint32_t>(file) != n_columns) {
+    throw std::runtime_error(path + " is not a PlasX event log");
+  }
+
+  EventTable table;
+  std::vector<Bytef> compressed;
+  std::vector<std::uint8_t> event, from, to;
+  while (true) {
+    const auto records = get<std::uint64_t>(file);
+    if (!file) {
+      break;
+    }
+    read_column(file, path, records, table.time, compressed);
+    read_column(file, path, records, table.individual, compressed);
+    read_column(file, path, records, event, compressed);
+    read_column(file, path, records, from, compressed);
+    read_column(file, path, records, to, compressed);
+  }
+  for (std::size_t i = 0; i < event.size(); ++i) {
+    table.event.push_back(static_cast<Event>(event[i]));
+    table.from.push_back(static_cast<Status>(from[i]));
+    table.to.push_back(static_cast<Status>(to[i]));
+  }
+  return table;
+}
+
+}  // namespace griffin
+}  // namespace falciparum
+}  // namespace plasx
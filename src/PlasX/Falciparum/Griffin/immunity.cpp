@@ -0,0 +1,94 @@
+#include "PlasX/Falciparum/Griffin/immunity.hpp"
+
+#include <cmath>
+#include <vector>
+
+#include "PlasX/Falciparum/Griffin/population.hpp"
+#include "PlasX/vector_math.hpp"
+
+namespace plasx {
+namespace falciparum {
+namespace griffin {
+
+ImmunityDecay immunity_decay(const Parameters& params, const double elapsed) {
+  return {std::exp(-elapsed / params.d_C), std::exp(-elapsed / params.d_M),
+          std::exp(-elapsed / params.d_A), std::exp(-elapsed / params.d_B)};
+}
+
+void decay_immunity(Population& population, const std::size_t begin,
+                    const std::size_t end, const ImmunityDecay& decay,
+                    const double t) noexcept {
+  auto* __restrict I_CA = population.I_CA_.data();
+  auto* __restrict I_CM = population.I_CM_.data();
+  auto* __restrict I_A = population.I_A_.data();
+  auto* __restrict I_B = population.I_B_.data();
+  auto* __restrict time = population.updated_.data();
+  for (auto i = begin; i < end; ++i) {
+    I_CA[i] *= decay.I_CA;
+    I_CM[i] *= decay.I_CM;
+    I_A[i] *= decay.I_A;
+    I_B[i] *= decay.I_B;
+    time[i] = t;
+  }
+}
+
+// Multiply column[i] by exp(rate * elapsed[i]), using factor as scratch space.
+static void decay_column(StateType* column, const double* elapsed,
+                         const double rate, StateType* factor,
+                         const std::size_t m) noexcept {
+  for (std::size_t i = 0; i < m; ++i) {
+    factor[i] = rate * elapsed[i];
+  }
+  batch_exp(factor, factor, m);
+  for (std::size_t i = 0; i < m; ++i) {
+    column[i] *= factor[i];
+  }
+}
+
+void catch_up_immunity(Population& population, const std::size_t begin,
+                       const std::size_t end, const Parameters& params,
+                       const double t) {
+  if (begin >= end) {
+    return;
+  }
+  const auto m = end - begin;
+  auto* time = population.updated_.data() + begin;
+  for (std::size_t i = 0; i < m; ++i) {
+    if (std::isnan(time[i])) {
+      time[i] = t;
+    }
+  }
+
+  // In the common case everyone was last updated together, and four
+  // exponentials do for the whole range.
+  auto same_time = true;
+  for (std::size_t i = 1; i < m && same_time; ++i) {
+    same_time = time[i] == time[0];
+  }
+  if (same_time) {
+    decay_immunity(population, begin, end,
+                   immunity_decay(params, t - time[0]), t);
+    return;
+  }
+
+  thread_local std::vector<double> elapsed;
+  thread_local std::vector<StateType> factor;
+  elapsed.resize(m);
+  factor.resize(m);
+  for (std::size_t i = 0; i < m; ++i) {
+    elapsed[i] = t - time[i];
+    time[i] = t;
+  }
+  decay_column(population.I_CA_.data() + begin, elapsed.data(),
+               -1.0 / params.d_C, factor.data(), m);
+  decay_column(population.I_CM_.data() + begin, elapsed.data(),
+               -1.0 / params.d_M, factor.data(), m);
+  decay_column(population.I_A_.data() + begin, elapsed.data(),
+               -1.0 / params.d_A, factor.data(), m);
+  decay_column(population.I_B_.data() + begin, elapsed.data(),
+               -1.0 / params.d_B, factor.data(), m);
+}
+
+}  // namespace griffin
+}  // namespace falciparum
+}  // namespace plasx
@@ -0,0 +1,87 @@
+#include "PlasX/Falciparum/Griffin/immunity_functions.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace plasx {
+namespace falciparum {
+namespace griffin {
+
+// Tables stop growing at this many knots, whatever the tolerance.
+static constexpr std::size_t max_knots = std::size_t(1) << 20;
+
+Tabulated::Tabulated(const std::function<double(double)>& f,
+                     const double limit, const double scale,
+                     const double tolerance)
+    : scale_(scale) {
+  // Value of the tabulated function at position u of the table.
+  auto at = [&](const double u) {
+    return u < 1.0 ? f(scale * u / (1.0 - u)) : limit;
+  };
+
+  for (std::size_t knots = 257;; knots = 2 * knots - 1) {
+    values_.resize(knots);
+    for (std::size_t i = 0; i < knots; ++i) {
+      values_[i] = at(static_cast<double>(i) / (knots - 1));
+    }
+
+    auto largest = 0.0;
+    error_ = 0.0;
+    for (std::size_t i = 0; i + 1 < knots; ++i) {
+      const auto midpoint = at((i + 0.5) / (knots - 1));
+      const auto interpolated = 0.5 * (values_[i] + values_[i + 1]);
+      error_ = std::max(error_, std::abs(midpoint - interpolated));
+      largest = std::max(largest, std::abs(values_[i]));
+    }
+    converged_ = error_ <= tolerance * largest;
+    if (converged_ || 2 * knots - 1 > max_knots) {
+      return;
+    }
+  }
+}
+
+ImmunityFunctions::ImmunityFunctions(const Parameters& params)
+    : params_(params), exact_(params.exact_functions) {
+  if (exact_) {
+    return;
+  }
+  const auto tol = params.function_tolerance;
+  b_ = Tabulated([this](double x) { return exact_b(x); }, params.b_min,
+                 params.I_B0, tol);
+  phi_ = Tabulated([this](double x) { return exact_phi(x); }, 0.0,
+                   params.I_C0, tol);
+  r_A_ = Tabulated([this](double x) { return exact_r_A(x); },
+                   params.r_A0 * params.w_A, params.I_A0, tol);
+  psi_ = Tabulated([this](double x) { return exact_psi(x); }, 1.0,
+                   params.age_0, tol);
+  // A table that could not meet the tolerance would be silently less
+  // accurate than asked for.
+  exact_ = !(b_.converged() && phi_.converged() && r_A_.converged() &&
+             psi_.converged());
+}
+
+double ImmunityFunctions::exact_b(const double I_B) const noexcept {
+  const auto bdiff = params_.b_max - params_.b_min;
+  return params_.b_min +
+         bdiff / (1.0 + pow(I_B / params_.I_B0, params_.kappa_B));
+}
+
+double ImmunityFunctions::exact_phi(const double I_C) const noexcept {
+  return 1.0 / (1.0 + pow(I_C / params_.I_C0, params_.kappa_C));
+}
+
+double ImmunityFunctions::exact_r_A(const double I_A) const noexcept {
+  // Reformulate to be more stable. If the top and bottom got too large youd
+  // be in trouble.
+  const auto IA_ratio_power_inverse = pow(I_A / params_.I_A0, -params_.kappa_A);
+  return params_.r_A0 *
+         (1.0 + (params_.w_A - 1.0) / (1.0 + IA_ratio_power_inverse));
+}
+
+double ImmunityFunctions::exact_psi(const double age) const noexcept {
+  return 1.0 - params_.rho * std::exp(-age / params_.age_0);
+}
+
+}  // namespace griffin
+}  // namespace falciparum
+}  // namespace plasx
@@ -0,0 +1,119 @@
+#include "PlasX/Falciparum/Griffin/infection_pool.hpp"
+
+namespace plasx {
+namespace falciparum {
+namespace griffin {
+
+InfectionPool::InfectionPool(const InfectionPool& other) {
+  std::lock_guard<std::mutex> lock(other.mutex_);
+  nodes_ = other.nodes_;
+  free_ = other.free_;
+  in_use_ = other.in_use_;
+}
+
+InfectionPool& InfectionPool::operator=(const InfectionPool& other) {
+  if (this == &other) {
+    return *this;
+  }
+  std::scoped_lock lock(mutex_, other.mutex_);
+  nodes_ = other.nodes_;
+  free_ = other.free_;
+  in_use_ = other.in_use_;
+  return *this;
+}
+
+InfectionPool::Handle InfectionPool::allocate(const double t,
+                                              const Handle next) {
+  ++in_use_;
+  if (free_ != none) {
+    const auto node = free_;
+    free_ = nodes_[node].next;
+    nodes_[node] = {t, next};
+    return node;
+  }
+  nodes_.push_back({t, next});
+  return static_cast<Handle>(nodes_.size() - 1);
+}
+
+void InfectionPool::insert(Handle& head, const double t) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  // Infections are normally scheduled in time order, so this walk is short.
+  auto previous = none;
+  auto next = head;
+  while (next != none && nodes_[next].time <= t) {
+    previous = next;
+    next = nodes_[next].next;
+  }
+  const auto node = allocate(t, next);
+  if (previous == none) {
+    head = node;
+  } else {
+    nodes_[previous].next = node;
+  }
+}
+
+double InfectionPool::pop_until(Handle& head, const double t) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  while (head != none && nodes_[head].time <= t) {
+    const auto next = nodes_[head].next;
+    nodes_[head].next = free_;
+    free_ = head;
+    --in_use_;
+    head = next;
+  }
+  return head == none ? std::numeric_limits<double>::infinity()
+                      : nodes_[head].time;
+}
+
+void InfectionPool::release(Handle& head) noexcept {
+  std::lock_guard<std::mutex> lock(mutex_);
+  while (head != none) {
+    const auto next = nodes_[head].next;
+    nodes_[head].next = free_;
+    free_ = head;
+    --in_use_;
+    head = next;
+  }
+}
+
+InfectionPool::Handle InfectionPool::copy(const Handle head) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto copy_head = none;
+  auto tail = none;
+  for (auto node = head; node != none; node = nodes_[node].next) {
+    const auto created = allocate(nodes_[node].time, none);
+    if (tail == none) {
+      copy_head = created;
+    } else {
+      nodes_[tail].next = created;
+    }
+    tail = created;
+  }
+  return copy_head;
+}
+
+void InfectionPool::collect(const Handle head,
+                            std::vector<double>& times) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto node = head; node != none; node = nodes_[node].next) {
+    times.push_back(nodes_[node].time);
+  }
+}
+
+std::size_t InfectionPool::length(const Handle head) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::size_t length = 0;
+  for (auto node = head; node != none; node = nodes_[node].next) {
+    ++length;
+  }
+  return length;
+}
+
+InfectionPool& InfectionPool::shared() {
+  static InfectionPool pool;
+  return pool;
+}
+
+}  // namespace griffin
+}  // namespace falciparum
+}  // namespace plasx
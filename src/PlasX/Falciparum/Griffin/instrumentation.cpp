@@ -0,0 +1,116 @@
+#include "PlasX/Falciparum/Griffin/instrumentation.hpp"
+
+#include <ostream>
+
+namespace plasx {
+namespace falciparum {
+namespace griffin {
+
+void StepCounters::merge(const StepCounters& other) noexcept {
+  for (std::size_t s = 0; s < n_status; ++s) {
+    visits[s] += other.visits[s];
+    seconds[s] += other.seconds[s];
+    draws[s] += other.draws[s];
+    deaths[s] += other.deaths[s];
+    for (std::size_t to = 0; to < n_status; ++to) {
+      transitions[s][to] += other.transitions[s][to];
+    }
+  }
+  for (std::size_t q = 0; q < queue_bins; ++q) {
+    queue_lengths[q] += other.queue_lengths[q];
+  }
+}
+
+Instrumentation& Instrumentation::global() {
+  static Instrumentation instrumentation;
+  return instrumentation;
+}
+
+void Instrumentation::add_step(const double seconds,
+                               const StepCounters& counters,
+                               const PerfCounters::Reading& hardware) {
+  std::lock_guard lock(mutex_);
+  ++steps_;
+  step_seconds_ += seconds;
+  counters_.merge(counters);
+  hardware_ += hardware;
+}
+
+bool Instrumentation::sample_hardware() {
+  std::lock_guard lock(mutex_);
+  perf_ = std::make_unique<PerfCounters>();
+  if (!perf_->available()) {
+    perf_.reset();
+    return false;
+  }
+  return true;
+}
+
+PerfCounters::Reading Instrumentation::hardware_now() const noexcept {
+  std::lock_guard lock(mutex_);
+  return perf_ ? perf_->read() : PerfCounters::Reading();
+}
+
+std::uint64_t Instrumentation::steps() const {
+  std::lock_guard lock(mutex_);
+  return steps_;
+}
+
+double Instrumentation::step_seconds() const {
+  std::lock_guard lock(mutex_);
+  return step_seconds_;
+}
+
+StepCounters Instrumentation::counters() const {
+  std::lock_guard lock(mutex_);
+  return counters_;
+}
+
+PerfCounters::Reading Instrumentation::hardware() const {
+  std::lock_guard lock(mutex_);
+  return hardware_;
+}
+
+void Instrumentation::reset() {
+  std::lock_guard lock(mutex_);
+  steps_ = 0;
+  step_seconds_ = 0.0;
+  counters_ = StepCounters();
+  hardware_ = PerfCounters::Reading();
+}
+
+void Instrumentation::report(std::ostream& out) const {
+  static constexpr const char* names[n_status] = {"S", "A", "U",
+                                                  "D", "T", "P"};
+  std::lock_guard lock(mutex_);
+  out << "steps,seconds\n" << steps_ << ',' << step_seconds_ << "\n\n";
+
+  out << "compartment,visits,seconds,draws,deaths";
+  for (const auto name : names) {
+    out << ",to_" << name;
+  }
+  out << '\n';
+  for (std::size_t s = 0; s < n_status; ++s) {
+    out << names[s] << ',' << counters_.visits[s] << ','
+        << counters_.seconds[s] << ',' << counters_.draws[s] << ','
+        << counters_.deaths[s];
+    for (const auto count : counters_.transitions[s]) {
+      out << ',' << count;
+    }
+    out << '\n';
+  }
+
+  out << "\npending_infections,individuals\n";
+  for (std::size_t q = 0; q < queue_bins; ++q) {
+    out << q << (q + 1 == queue_bins ? "+" : "") << ','
+        << counters_.queue_lengths[q] << '\n';
+  }
+
+  out << "\ncycles,instructions,cache_misses,branch_misses\n"
+      << hardware_.cycles << ',' << hardware_.instructions << ','
+      << hardware_.cache_misses << ',' << hardware_.branch_misses << '\n';
+}
+
+}  // namespace griffin
+}  // namespace falciparum
+}  // namespace plasx
@@ -0,0 +1,197 @@
+#include "PlasX/Falciparum/Griffin/interventions.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+#include "PlasX/Falciparum/Griffin/biting.hpp"
+#include "PlasX/Falciparum/Griffin/event_log.hpp"
+#include "PlasX/Falciparum/Griffin/population.hpp"
+#include "PlasX/Falciparum/Griffin/recorder.hpp"
+
+namespace plasx {
+namespace falciparum {
+namespace griffin {
+
+static void check_share(const double value, const char* what) {
+  if (!(value >= 0.0 && value <= 1.0)) {
+    throw std::invalid_argument(std::string(what) + " must be in [0, 1]");
+  }
+}
+
+// Anything added for a time that has already gone is applied in the next
+// step.
+template <class T>
+void Schedule::Timeline<T>::add(const double time, const T& item) {
+  const auto after = std::upper_bound(
+      items.begin() + next, items.end(), time,
+      [](const double t, const auto& entry) { return t < entry.first; });
+  items.emplace(after, time, item);
+}
+
+void Schedule::add(const double time, const MassDrugAdministration& mda) {
+  check_share(mda.coverage, "coverage");
+  if (!(mda.min_age <= mda.max_age)) {
+    throw std::invalid_argument("min_age must not be above max_age");
+  }
+  mda_.add(time, mda);
+}
+
+void Schedule::add(const double time, const BednetCampaign& nets) {
+  check_share(nets.coverage, "coverage");
+  if (!(nets.efficacy >= 0.0 && nets.efficacy < 1.0)) {
+    throw std::invalid_argument("efficacy must be in [0, 1)");
+  }
+  if (!(nets.duration > 0.0)) {
+    throw std::invalid_argument("duration must be positive");
+  }
+  nets_.add(time, nets);
+}
+
+void Schedule::add(const double time, const CaseManagement& case_management) {
+  check_share(case_management.f_T, "f_T");
+  case_management_.add(time, case_management);
+}
+
+bool Schedule::apply(const double t, const double dt, Population& population) {
+  const auto before = t + dt;
+  auto applied = false;
+  treated_.clear();
+  treated_from_.clear();
+  zeta_changed_ = false;
+  mda_.due(before, [&](const auto& mda) {
+    administer(mda, population);
+    applied = true;
+  });
+  nets_.due(before, [&](const auto& nets) {
+    distribute(t, nets, population);
+    applied = zeta_changed_ = true;
+  });
+  case_management_.due(before, [&](const auto& c) {
+    f_T_ = c.f_T;
+    applied = true;
+  });
+  ends_.due(before, [&](const auto campaign) {
+    withdraw(t, dt, campaigns_[campaign], population);
+    applied = zeta_changed_ = true;
+  });
+  return applied;
+}
+
+void Schedule::update(const double, const Population& population,
+                      Recorder& recorder) const {
+  if (!treated_.empty()) {
+    recorder.count(population);
+  }
+}
+
+void Schedule::update(const double, const Population& population,
+                      BitingTable& table) const {
+  if (zeta_changed_) {
+    table.rebuild(population);
+  }
+}
+
+void Schedule::update(const double t, const Population&,
+                      EventLog& log) const {
+  if (treated_.empty()) {
+    return;
+  }
+  log.start_step(1);
+  auto& buffer = log.buffer(0);
+  for (std::size_t k = 0; k < treated_.size(); ++k) {
+    buffer.add(treated_[k], Event::transition, treated_from_[k], Status::T);
+  }
+  log.end_step(t);
+}
+
+const Parameters& Schedule::parameters(const Parameters& params) {
+  if (!f_T_) {
+    return params;
+  }
+  params_ = params;
+  params_.f_T = *f_T_;
+  return params_;
+}
+
+std::size_t Schedule::pending() const noexcept {
+  return mda_.size() + nets_.size() + case_management_.size() + ends_.size();
+}
+
+void Schedule::administer(const MassDrugAdministration& mda,
+                          Population& population) {
+  const auto n = population.size();
+  draws_.resize(n);
+  covered_.resize(n);
+  before_.resize(n);
+  rng_.fill_uniform(draws_.data(), n);
+  const auto* age = population.age_.data();
+  auto* status = population.current_.data();
+  auto* next_infection = population.next_infection_.data();
+  const auto* overflow = population.overflow_.data();
+  constexpr auto never = std::numeric_limits<double>::infinity();
+
+  std::size_t more_pending = 0;
+  for (std::size_t i = 0; i < n; ++i) {
+    const bool treated = draws_[i] < mda.coverage && age[i] >= mda.min_age &&
+                         age[i] < mda.max_age && status[i] != Status::T &&
+                         status[i] != Status::P;
+    covered_[i] = treated;
+    before_[i] = status[i];
+    status[i] = treated ? Status::T : status[i];
+    next_infection[i] = treated ? never : next_infection[i];
+    more_pending += treated & (overflow[i] != InfectionPool::none);
+  }
+  // Only those with more than one pending infection have any in the pool.
+  for (std::size_t i = 0; more_pending > 0 && i < n; ++i) {
+    if (covered_[i] && overflow[i] != InfectionPool::none) {
+      population[i].clearInfectionQueue();
+      --more_pending;
+    }
+  }
+  for (std::size_t i = 0; i < n; ++i) {
+    if (covered_[i]) {
+      treated_.push_back(i);
+      treated_from_.push_back(before_[i]);
+    }
+  }
+}
+
+void Schedule::distribute(const double t, const BednetCampaign& nets,
+                          Population& population) {
+  const auto n = population.size();
+  draws_.resize(n);
+  rng_.fill_uniform(draws_.data(), n);
+  const auto factor = 1.0 - nets.efficacy;
+  auto* zeta = population.zeta_.data();
+  for (std::size_t i = 0; i < n; ++i) {
+    zeta[i] *= draws_[i] < nets.coverage ? factor : 1.0;
+  }
+
+  auto& campaign = campaigns_.emplace_back(Nets{t, factor, {}});
+  for (std::size_t i = 0; i < n; ++i) {
+    if (draws_[i] < nets.coverage) {
+      campaign.covered.push_back(i);
+    }
+  }
+  ends_.add(t + nets.duration, campaigns_.size() - 1);
+}
+
+// Take back the nets of those still alive. Anyone born since the campaign
+// started is younger than it, by at least a step.
+void Schedule::withdraw(const double t, const double dt, Nets& nets,
+                        Population& population) {
+  const auto min_age = t - nets.start - 0.5 * dt;
+  const auto* age = population.age_.data();
+  auto* zeta = population.zeta_.data();
+  for (const auto i : nets.covered) {
+    if (i < population.size() && age[i] >= min_age) {
+      zeta[i] /= nets.factor;
+    }
+  }
+  nets.covered = std::vector<std::size_t>();
+}
+
+}  // namespace griffin
+}  // namespace falciparum
+}  // namespace plasx
@@ -0,0 +1,151 @@
+#include "PlasX/Falciparum/Griffin/metapopulation.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+
+#include "PlasX/Falciparum/griffin.hpp"
+
+namespace plasx {
+namespace falciparum {
+namespace griffin {
+
+Metapopulation::Metapopulation(std::vector<Patch> patches,
+                               std::vector<double> migration,
+                               const std::uint64_t seed)
+    : patches_(std::move(patches)),
+      migration_(std::move(migration)),
+      migration_streams_(RandomStreams(seed).key(1, 0)),
+      leaving_(patches_.size()),
+      departed_(patches_.size()) {
+  const auto n = patches_.size();
+  if (migration_.size() != n * n) {
+    throw std::invalid_argument(
+        "The migration matrix must have one row and column per patch.");
+  }
+  const RandomStreams root(seed);
+  for (std::size_t p = 0; p < n; ++p) {
+    streams_.emplace_back(root.key(0, p));
+  }
+}
+
+std::size_t Metapopulation::size() const noexcept {
+  std::size_t total = 0;
+  for (const auto& patch : patches_) {
+    total += patch.population.size();
+  }
+  return total;
+}
+
+void Metapopulation::step(const double t, const double dt,
+                          const Parameters& params, ThreadPool& pool) {
+  std::vector<std::size_t> order(patches_.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](auto a, auto b) {
+    return patches_[a].population.size() > patches_[b].population.size();
+  });
+  pool.parallel_for(order.size(), [&](std::size_t task) {
+    const auto p = order[task];
+    auto& patch = patches_[p];
+    if (patch.mosquitoes) {
+      one_step(t, dt, patch.population, params, *patch.mosquitoes,
+               streams_[p]);
+    } else {
+      one_step(t, dt, patch.population, params, patch.eir, streams_[p]);
+    }
+  });
+  exchange(dt, pool);
+}
+
+void Metapopulation::exchange(const double dt, ThreadPool& pool) {
+  const auto n = patches_.size();
+  const auto epoch = migration_streams_.next_epoch();
+
+  // The people leaving each patch. The gaps between leavers are geometric, so
+  // only the leavers themselves cost a draw.
+  pool.parallel_for(n, [&](std::size_t p) {
+    auto& leaving = leaving_[p];
+    leaving.clear();
+    const auto* rates = migration_.data() + p * n;
+    auto total = 0.0;
+    for (std::size_t q = 0; q < n; ++q) {
+      total += q == p ? 0.0 : rates[q];
+    }
+    const auto size = patches_[p].population.size();
+    if (total <= 0.0 || size == 0) {
+      return;
+    }
+    const auto log_stay = -dt * total;
+    auto rng = migration_streams_.stream(epoch, p);
+    auto uniform = [&rng] { return 1.0 - rng.uniform(); };
+    for (auto i = std::floor(std::log(uniform()) / log_stay);
+         i < static_cast<double>(size);
+         i += 1.0 + std::floor(std::log(uniform()) / log_stay)) {
+      // Pick the destination in proportion to its rate.
+      auto r = rng.uniform() * total;
+      std::size_t destination = 0;
+      for (std::size_t q = 0; q < n; ++q) {
+        if (q == p) {
+          continue;
+        }
+        destination = q;
+        r -= rates[q];
+        if (r < 0.0) {
+          break;
+        }
+      }
+      leaving.push_back({static_cast<std::size_t>(i), destination});
+    }
+  });
+
+  // Each patch copies out its own leavers, so that no patch reads another
+  // while it is taking in arrivals.
+  pool.parallel_for(n, [&](std::size_t p) {
+    auto& departed = departed_[p];
+    departed.truncate(0);
+    for (const auto& migrant : leaving_[p]) {
+      departed.append(patches_[p].population, migrant.index);
+    }
+  });
+
+  // Arrivals are taken in order of patch and then index.
+  pool.parallel_for(n, [&](std::size_t q) {
+    auto& population = patches_[q].population;
+    for (std::size_t p = 0; p < n; ++p) {
+      const auto& leaving = leaving_[p];
+      for (std::size_t k = 0; k < leaving.size(); ++k) {
+        if (leaving[k].destination == q) {
+          population.append(departed_[p], k);
+        }
+      }
+    }
+  });
+
+  // Going from the back, the last individual is never someone still to leave.
+  pool.parallel_for(n, [&](std::size_t p) {
+    auto& population = patches_[p].population;
+    const auto& leaving = leaving_[p];
+    for (auto m = leaving.rbegin(); m != leaving.rend(); ++m) {
+      const auto last = population.size() - 1;
+      if (m->index != last) {
+        population.relocate(last, m->index);
+      }
+      population.truncate(last);
+    }
+  });
+  for (const auto& leaving : leaving_) {
+    migrants_ += leaving.size();
+  }
+}
+
+double OneStep::operator()(const double t, const double dt,
+                           Metapopulation& metapopulation,
+                           const Parameters& params, ThreadPool& pool) const {
+  metapopulation.step(t, dt, params, pool);
+  return t + dt;
+}
+
+}  // namespace griffin
+}  // namespace falciparum
+}  // namespace plasx
@@ -0,0 +1,110 @@
+#include "PlasX/Falciparum/Griffin/mosquito.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include "PlasX/udl.hpp"
+
+namespace plasx {
+namespace falciparum {
+namespace griffin {
+
+MosquitoParameters::MosquitoParameters() {
+  // Anthropophagy over the length of the gonotrophic cycle.
+  a = 0.92 / 3.0_days;
+  mu_m = 0.132;
+  tau_m = 10.0_days;
+
+  c_D = 0.068;
+  c_U = 0.0062;
+  c_T = 0.32 * c_D;
+  // c_U + (c_D - c_U) q^1.82 at a probability of detection q of one half.
+  c_A = c_U + (c_D - c_U) * std::pow(0.5, 1.82);
+}
+
+double Infectiousness::kappa(const MosquitoParameters& params) const noexcept {
+  auto total = 0.0;
+  for (const auto weight : weight_) {
+    total += weight;
+  }
+  if (total <= 0.0) {
+    return 0.0;
+  }
+  // Nobody in S or P is infectious.
+  const auto infectious = params.c_A * weight(Status::A) +
+                          params.c_U * weight(Status::U) +
+                          params.c_D * weight(Status::D) +
+                          params.c_T * weight(Status::T);
+  return infectious / total;
+}
+
+Mosquitoes::Mosquitoes(const MosquitoParameters& params, const double m,
+                       const double kappa)
+    : params_(params), m_(m), foi_(params.a * kappa) {
+  const auto mu = params.mu_m;
+  S_ = mu * m / (foi_ + mu);
+  // Mosquitoes are infected at a constant rate foi_ * S_, so the number that
+  // were infected s days ago and are still alive is proportional to
+  // exp(-mu s). The incubating are split into cohorts of at most a day.
+  const auto infected = foi_ * S_;
+  I_ = infected * std::exp(-mu * params.tau_m) / mu;
+  const auto n = std::max(1.0, std::ceil(params.tau_m));
+  const auto width = params.tau_m / n;
+  for (auto j = 0; j < static_cast<int>(n); ++j) {
+    const auto size = infected * std::exp(-mu * j * width) *
+                      (1.0 - std::exp(-mu * width)) / mu;
+    cohorts_.push_back({params.tau_m - (j + 0.5) * width, size});
+  }
+  std::reverse(cohorts_.begin(), cohorts_.end());
+}
+
+Mosquitoes::Mosquitoes(const MosquitoParameters& params, const double m,
+                       const double S, const double I, const double foi,
+                       std::deque<Cohort> cohorts)
+    : params_(params),
+      m_(m),
+      S_(S),
+      I_(I),
+      foi_(foi),
+      cohorts_(std::move(cohorts)) {}
+
+void Mosquitoes::step(const double dt, const Infectiousness& humans) {
+  const auto mu = params_.mu_m;
+  const auto survival = std::exp(-mu * dt);
+  foi_ = params_.a * humans.kappa(params_);
+
+  // Susceptibles relax towards mu m / (foi + mu), and everyone else only dies.
+  const auto rate = foi_ + mu;
+  const auto S_eq = mu * m_ / rate;
+  S_ = S_eq + (S_ - S_eq) * std::exp(-rate * dt);
+  I_ *= survival;
+  for (auto& cohort : cohorts_) {
+    cohort.size *= survival;
+    cohort.incubating -= dt;
+  }
+  while (!cohorts_.empty() && cohorts_.front().incubating <= 0.0) {
+    I_ += cohorts_.front().size;
+    cohorts_.pop_front();
+  }
+
+  // The total stays at m, so whatever is left over was infected this step and
+  // survived to its end. They are taken to have been infected half way
+  // through.
+  if (foi_ > 0.0) {
+    const auto infected = std::max(0.0, m_ - S_ - I_ - E());
+    cohorts_.push_back({params_.tau_m - 0.5 * dt, infected});
+  }
+}
+
+double Mosquitoes::E() const noexcept {
+  auto incubating = 0.0;
+  for (const auto& cohort : cohorts_) {
+    incubating += cohort.size;
+  }
+  return incubating;
+}
+
+}  // namespace griffin
+}  // namespace falciparum
+}  // namespace plasx
@@ -0,0 +1,255 @@
+#include "PlasX/Falciparum/Griffin/parameter_file.hpp"
+
+#include <charconv>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string_view>
+
+#include "PlasX/udl.hpp"
+
+namespace plasx {
+namespace falciparum {
+namespace griffin {
+
+// What a parameter measures, which decides the units it is given in and the
+// values it can take.
+enum class Dimension { duration, rate, probability, positive, number };
+
+template <class Owner>
+struct Field {
+  const char* name;
+  Dimension dimension;
+  double Owner::*value;
+};
+
+static constexpr Field<Parameters> human_fields[] = {
+    {"mu_d", Dimension::rate, &Parameters::mu_d},
+    {"sigma", Dimension::number, &Parameters::sigma},
+    {"age_0", Dimension::duration, &Parameters::age_0},
+    {"rho", Dimension::probability, &Parameters::rho},
+    {"r_T", Dimension::rate, &Parameters::r_T},
+    {"r_D", Dimension::rate, &Parameters::r_D},
+    {"r_U", Dimension::rate, &Parameters::r_U},
+    {"r_A0", Dimension::rate, &Parameters::r_A0},
+    {"r_P", Dimension::rate, &Parameters::r_P},
+    {"f_T", Dimension::probability, &Parameters::f_T},
+    {"b_min", Dimension::probability, &Parameters::b_min},
+    {"b_max", Dimension::probability, &Parameters::b_max},
+    {"d_A", Dimension::duration, &Parameters::d_A},
+    {"d_B", Dimension::duration, &Parameters::d_B},
+    {"d_C", Dimension::duration, &Parameters::d_C},
+    {"d_M", Dimension::duration, &Parameters::d_M},
+    {"P_M", Dimension::probability, &Parameters::P_M},
+    {"kappa_A", Dimension::positive, &Parameters::kappa_A},
+    {"kappa_B", Dimension::positive, &Parameters::kappa_B},
+    {"kappa_C", Dimension::positive, &Parameters::kappa_C},
+    {"I_A0", Dimension::positive, &Parameters::I_A0},
+    {"I_B0", Dimension::positive, &Parameters::I_B0},
+    {"I_C0", Dimension::positive, &Parameters::I_C0},
+    {"w_A", Dimension::positive, &Parameters::w_A},
+    {"function_tolerance", Dimension::positive,
+     &Parameters::function_tolerance},
+};
+
+static constexpr Field<MosquitoParameters> mosquito_fields[] = {
+    {"a", Dimension::rate, &MosquitoParameters::a},
+    {"mu_m", Dimension::rate, &MosquitoParameters::mu_m},
+    {"tau_m", Dimension::duration, &MosquitoParameters::tau_m},
+    {"c_D", Dimension::probability, &MosquitoParameters::c_D},
+    {"c_A", Dimension::probability, &MosquitoParameters::c_A},
+    {"c_U", Dimension::probability, &MosquitoParameters::c_U},
+    {"c_T", Dimension::probability, &MosquitoParameters::c_T},
+};
+
+static constexpr std::string_view whitespace = " \t\r";
+
+static std::string_view trim(std::string_view text) {
+  const auto first = text.find_first_not_of(whitespace);
+  if (first == std::string_view::npos) {
+    return {};
+  }
+  const auto last = text.find_last_not_of(whitespace);
+  return text.substr(first, last - first + 1);
+}
+
+// Reads one line at a time and reports errors against it.
+class Reader {
+ public:
+  Reader(const std::string& name) : name_(name){};
+
+  [[noreturn]] void fail(const std::string& what) const {
+    throw std::invalid_argument(name_ + ":" + std::to_string(line_) + ": " +
+                                what);
+  };
+
+  void next_line() { ++line_; };
+
+  // The value of name, in days, from "number unit".
+  double value(const std::string& name, const Dimension dimension,
+               const std::string_view text) const {
+    const auto space = text.find_first_of(whitespace);
+    const auto number = text.substr(0, space);
+    const auto unit = space == std::string_view::npos
+                          ? std::string_view()
+                          : trim(text.substr(space));
+    double x;
+    const auto [end, error] =
+        std::from_chars(number.data(), number.data() + number.size(), x);
+    if (error != std::errc() || end != number.data() + number.size() ||
+        !std::isfinite(x)) {
+      fail("value of " + name + " is not a number");
+    }
+
+    switch (dimension) {
+      case Dimension::duration:
+        if (unit == "days") {
+          x *= 1.0_days;
+        } else if (unit == "yrs") {
+          x *= 1.0_yrs;
+        } else {
+          fail(name + " is a duration, its unit must be days or yrs");
+        }
+        if (!(x > 0.0)) {
+          fail(name + " must be positive");
+        }
+        break;
+      case Dimension::rate:
+        if (unit == "/days") {
+          x /= 1.0_days;
+        } else if (unit == "/yrs") {
+          x /= 1.0_yrs;
+        } else {
+          fail(name + " is a rate, its unit must be /days or /yrs");
+        }
+        if (x < 0.0) {
+          fail(name + " can not be negative");
+        }
+        break;
+      default:
+        if (!unit.empty()) {
+          fail(name + " has no unit");
+        }
+        if (dimension == Dimension::probability && (x < 0.0 || x > 1.0)) {
+          fail(name + " is a probability, it must be in [0, 1]");
+        }
+        if (dimension == Dimension::positive && !(x > 0.0)) {
+          fail(name + " must be positive");
+        }
+    }
+    return x;
+  };
+
+ private:
+  const std::string& name_;
+  std::size_t line_ = 0;
+};
+
+// Set the field called name, if owner has one.
+template <class Owner, std::size_t N>
+static bool assign(const Field<Owner> (&fields)[N], Owner& owner,
+                   const std::string& name, const std::string_view text,
+                   const Reader& reader) {
+  for (const auto& field : fields) {
+    if (name == field.name) {
+      owner.*field.value = reader.value(name, field.dimension, text);
+      return true;
+    }
+  }
+  return false;
+}
+
+ParameterSet read_parameters(std::istream& in, const std::string& name) {
+  ParameterSet parameters;
+  Reader reader(name);
+  auto mosquito = false;
+  std::set<std::string> seen;
+  std::string line;
+  while (std::getline(in, line)) {
+    reader.next_line();
+    const auto text = trim(std::string_view(line).substr(0, line.find('#')));
+    if (text.empty()) {
+      continue;
+    }
+    if (text.front() == '[') {
+      if (text == "[human]") {
+        mosquito = false;
+      } else if (text == "[mosquito]") {
+        mosquito = true;
+      } else {
+        reader.fail("unknown section " + std::string(text));
+      }
+      continue;
+    }
+
+    const auto equals = text.find('=');
+    if (equals == std::string_view::npos) {
+      reader.fail("expected name = value");
+    }
+    const auto key = std::string(trim(text.substr(0, equals)));
+    const auto value = trim(text.substr(equals + 1));
+    if (!seen.insert((mosquito ? "mosquito." : "") + key).second) {
+      reader.fail(key + " is given twice");
+    }
+
+    if (mosquito) {
+      if (!assign(mosquito_fields, parameters.mosquito, key, value, reader)) {
+        reader.fail("unknown mosquito parameter " + key);
+      }
+    } else if (key == "exact_functions") {
+      if (value != "true" && value != "false") {
+        reader.fail("exact_functions must be true or false");
+      }
+      parameters.human.exact_functions = value == "true";
+    } else if (!assign(human_fields, parameters.human, key, value, reader)) {
+      reader.fail("unknown parameter " + key);
+    }
+  }
+
+  if (parameters.human.b_min > parameters.human.b_max) {
+    reader.fail("b_min is larger than b_max");
+  }
+  return parameters;
+}
+
+ParameterSet load_parameters(const std::string& path) {
+  std::ifstream in(path);
+  if (!in) {
+    throw std::runtime_error("could not open " + path);
+  }
+  return read_parameters(in, path);
+}
+
+template <class Owner, std::size_t N>
+static void write(std::ostream& out, const Field<Owner> (&fields)[N],
+                  const Owner& owner) {
+  for (const auto& field : fields) {
+    out << field.name << " = " << owner.*field.value;
+    if (field.dimension == Dimension::duration) {
+      out << " days";
+    } else if (field.dimension == Dimension::rate) {
+      out << " /days";
+    }
+    out << '\n';
+  }
+}
+
+void write_parameters(std::ostream& out, const ParameterSet& parameters) {
+  const auto flags = out.flags();
+  const auto precision = out.precision(17);
+  out << "[human]\n";
+  write(out, human_fields, parameters.human);
+  out << "exact_functions = " << std::boolalpha
+      << parameters.human.exact_functions << '\n';
+  out << "\n[mosquito]\n";
+  write(out, mosquito_fields, parameters.mosquito);
+  out.flags(flags);
+  out.precision(precision);
+}
+
+}  // namespace griffin
+}  // namespace falciparum
+}  // namespace plasx
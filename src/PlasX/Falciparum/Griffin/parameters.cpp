@@ -47,6 +47,10 @@ Parameters::Parameters() {
 
   // This one.
   w_A = 1.0;
+
+  // Tabulate the immunity functions.
+  exact_functions = false;
+  function_tolerance = 1e-6;
 }
 
 }  // namespace griffin
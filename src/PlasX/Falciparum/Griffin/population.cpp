@@ -0,0 +1,171 @@
+#include "PlasX/Falciparum/Griffin/population.hpp"
+
+#include <limits>
+
+namespace plasx {
+namespace falciparum {
+namespace griffin {
+
+void Population::reserve(const std::size_t n) {
+  age_.reserve(n);
+  current_.reserve(n);
+  I_CA_.reserve(n);
+  I_CM_.reserve(n);
+  I_A_.reserve(n);
+  I_B_.reserve(n);
+  zeta_.reserve(n);
+  next_infection_.reserve(n);
+  updated_.reserve(n);
+  overflow_.reserve(n);
+}
+
+void Population::emplace_back(double age, const Status& status, double ICA,
+                              double ICM, double IA) {
+  // Same initial values as the constructors of Individual<PFalc> and PFalc.
+  age_.push_back(age);
+  current_.push_back(status);
+  I_CA_.push_back(ICA);
+  I_CM_.push_back(ICM);
+  I_A_.push_back(IA);
+  I_B_.push_back(0.0);
+  zeta_.push_back(1.0);
+  next_infection_.push_back(std::numeric_limits<double>::infinity());
+  updated_.push_back(std::numeric_limits<double>::quiet_NaN());
+  overflow_.push_back(InfectionPool::none);
+}
+
+void Population::append(const Population& other, const std::size_t index) {
+  age_.push_back(other.age_[index]);
+  current_.push_back(other.current_[index]);
+  I_CA_.push_back(other.I_CA_[index]);
+  I_CM_.push_back(other.I_CM_[index]);
+  I_A_.push_back(other.I_A_[index]);
+  I_B_.push_back(other.I_B_[index]);
+  zeta_.push_back(other.zeta_[index]);
+  next_infection_.push_back(other.next_infection_[index]);
+  updated_.push_back(other.updated_[index]);
+  overflow_.push_back(InfectionPool::none);
+  // The pending infections live in other's pool, so they are copied over one
+  // at a time.
+  if (other.overflow_[index] != InfectionPool::none) {
+    thread_local std::vector<double> times;
+    times.clear();
+    other.pool_.collect(other.overflow_[index], times);
+    for (const auto t : times) {
+      pool_.insert(overflow_.back(), t);
+    }
+  }
+}
+
+void Population::assign(const std::size_t index, double age,
+                        const Status& status, double ICA, double ICM,
+                        double IA, double zeta) noexcept {
+  age_[index] = age;
+  current_[index] = status;
+  I_CA_[index] = ICA;
+  I_CM_[index] = ICM;
+  I_A_[index] = IA;
+  I_B_[index] = 0.0;
+  zeta_[index] = zeta;
+  next_infection_[index] = std::numeric_limits<double>::infinity();
+  updated_[index] = std::numeric_limits<double>::quiet_NaN();
+  if (overflow_[index] != InfectionPool::none) {
+    pool_.release(overflow_[index]);
+  }
+}
+
+void Population::relocate(const std::size_t from,
+                          const std::size_t to) noexcept {
+  age_[to] = age_[from];
+  current_[to] = current_[from];
+  I_CA_[to] = I_CA_[from];
+  I_CM_[to] = I_CM_[from];
+  I_A_[to] = I_A_[from];
+  I_B_[to] = I_B_[from];
+  zeta_[to] = zeta_[from];
+  next_infection_[to] = next_infection_[from];
+  updated_[to] = updated_[from];
+  if (overflow_[to] != InfectionPool::none) {
+    pool_.release(overflow_[to]);
+  }
+  overflow_[to] = overflow_[from];
+  overflow_[from] = InfectionPool::none;
+}
+
+void Population::truncate(const std::size_t n) {
+  for (auto i = n; i < overflow_.size(); ++i) {
+    if (overflow_[i] != InfectionPool::none) {
+      pool_.release(overflow_[i]);
+    }
+  }
+  age_.resize(n);
+  current_.resize(n);
+  I_CA_.resize(n);
+  I_CM_.resize(n);
+  I_A_.resize(n);
+  I_B_.resize(n);
+  zeta_.resize(n);
+  next_infection_.resize(n);
+  updated_.resize(n);
+  overflow_.resize(n);
+}
+
+void Population::resize(const std::size_t n) {
+  if (n < size()) {
+    truncate(n);
+    return;
+  }
+  age_.resize(n, 0.0);
+  current_.resize(n, Status::S);
+  I_CA_.resize(n, 0.0);
+  I_CM_.resize(n, 0.0);
+  I_A_.resize(n, 0.0);
+  I_B_.resize(n, 0.0);
+  zeta_.resize(n, 1.0);
+  next_infection_.resize(n, std::numeric_limits<double>::infinity());
+  updated_.resize(n, std::numeric_limits<double>::quiet_NaN());
+  overflow_.resize(n, InfectionPool::none);
+}
+
+void Population::Agent::clearInfectionQueue() noexcept {
+  population_.next_infection_[index_] = std::numeric_limits<double>::infinity();
+  auto& overflow = population_.overflow_[index_];
+  if (overflow != InfectionPool::none) {
+    population_.pool_.release(overflow);
+  }
+}
+
+void Population::Agent::scheduleInfection(const double t) {
+  // Keep the earliest infection inline and push the other into the pool.
+  auto& next = population_.next_infection_[index_];
+  auto& overflow = population_.overflow_[index_];
+  if (t < next) {
+    if (next != std::numeric_limits<double>::infinity()) {
+      population_.pool_.insert(overflow, next);
+    }
+    next = t;
+    return;
+  }
+  population_.pool_.insert(overflow, t);
+}
+
+bool Population::Agent::updateInfection(const double t) {
+  auto& next = population_.next_infection_[index_];
+  auto activate_infection = t >= next;
+  if (!activate_infection) {
+    return false;
+  }
+
+  // Discard every infection that has already occured and pull the next one
+  // forward.
+  next = std::numeric_limits<double>::infinity();
+  auto& overflow = population_.overflow_[index_];
+  if (overflow != InfectionPool::none) {
+    next = population_.pool_.pop_until(overflow, t);
+  }
+  return true;
+}
+
+}  // namespace griffin
+}  // namespace falciparum
+}  // namespace plasx
@@ -0,0 +1,132 @@
+#include "PlasX/Falciparum/Griffin/recorder.hpp"
+
+#include <algorithm>
+
+#include "PlasX/Falciparum/Griffin/cohorts.hpp"
+#include "PlasX/Falciparum/Griffin/population.hpp"
+
+namespace plasx {
+namespace falciparum {
+namespace griffin {
+
+void Tally::reset(const std::size_t bands) {
+  change_.assign(bands * n_status, 0);
+  infections_.assign(bands, 0);
+  clinical_.assign(bands, 0);
+  deaths_.assign(bands, 0);
+}
+
+void Tally::merge(const Tally& other) {
+  for (std::size_t i = 0; i < change_.size(); ++i) {
+    change_[i] += other.change_[i];
+  }
+  for (std::size_t b = 0; b < infections_.size(); ++b) {
+    infections_[b] += other.infections_[b];
+    clinical_[b] += other.clinical_[b];
+    deaths_[b] += other.deaths_[b];
+  }
+}
+
+Recorder::Recorder(std::vector<double> band_edges, const std::string& path,
+                   std::size_t chunk_rows)
+    : edges_(std::move(band_edges)),
+      counts_(edges_.size() * n_status, 0),
+      last_(edges_.size()) {
+  if (path.empty()) {
+    return;
+  }
+  auto names = column_names(edges_.size());
+  row_.resize(names.size());
+  writer_ = std::make_unique<ColumnWriter>(path, std::move(names), chunk_rows);
+}
+
+std::vector<std::string> Recorder::column_names(const std::size_t bands) {
+  constexpr const char* status_names[n_status] = {"S", "A", "U",
+                                                  "D", "T", "P"};
+  std::vector<std::string> names = {"t"};
+  for (std::size_t b = 0; b < bands; ++b) {
+    const auto suffix = '[' + std::to_string(b) + ']';
+    for (const auto* status : status_names) {
+      names.push_back(std::string(status) + suffix);
+    }
+    names.push_back("infections" + suffix);
+    names.push_back("clinical" + suffix);
+    names.push_back("deaths" + suffix);
+  }
+  return names;
+}
+
+std::size_t Recorder::band(const double age) const noexcept {
+  // There are only ever a handful of bands.
+  std::size_t b = 0;
+  while (b + 1 < edges_.size() && age >= edges_[b + 1]) {
+    ++b;
+  }
+  return b;
+}
+
+void Recorder::count(const Population& population) {
+  std::fill(counts_.begin(), counts_.end(), 0);
+  for (std::size_t i = 0; i < population.size(); ++i) {
+    const auto status = static_cast<std::size_t>(population.current_[i]);
+    ++counts_[band(population.age_[i]) * n_status + status];
+  }
+  counted_ = true;
+}
+
+void Recorder::count(const std::vector<Individual<PFalc>>& population) {
+  std::fill(counts_.begin(), counts_.end(), 0);
+  for (const auto& person : population) {
+    const auto status = static_cast<std::size_t>(person.status_.current_);
+    ++counts_[band(person.age_) * n_status + status];
+  }
+  counted_ = true;
+}
+
+void Recorder::count(const HybridPopulation& population) {
+  count(population.agents);
+  for (const auto& cohort : population.cohorts.cohorts()) {
+    counts_[band(cohort.age) * n_status] += cohort.count;
+  }
+}
+
+void Recorder::end_step(const double t, const Tally& tally) {
+  for (std::size_t i = 0; i < counts_.size(); ++i) {
+    counts_[i] += tally.change_[i];
+  }
+  last_ = tally;
+  if (writer_) {
+    fill_row(t, row_.data());
+    writer_->write_row(row_.data());
+  }
+}
+
+void Recorder::fill_row(const double t, double* row) const {
+  *row++ = t;
+  for (std::size_t b = 0; b < edges_.size(); ++b) {
+    for (std::size_t s = 0; s < n_status; ++s) {
+      *row++ = counts_[b * n_status + s];
+    }
+    *row++ = last_.infections_[b];
+    *row++ = last_.clinical_[b];
+    *row++ = last_.deaths_[b];
+  }
+}
+
+std::uint64_t Recorder::total(const Status status) const {
+  std::uint64_t sum = 0;
+  for (std::size_t b = 0; b < edges_.size(); ++b) {
+    sum += count(b, status);
+  }
+  return sum;
+}
+
+void Recorder::flush() {
+  if (writer_) {
+    writer_->flush();
+  }
+}
+
+}  // namespace griffin
+}  // namespace falciparum
+}  // namespace plasx
@@ -0,0 +1,507 @@
+#include "PlasX/Falciparum/Griffin/snapshot.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <array>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "PlasX/Falciparum/Griffin/population.hpp"
+
+namespace plasx {
+namespace falciparum {
+namespace griffin {
+
+static_assert(std::is_trivially_copyable_v<Parameters>,
+              "Parameters are stored as raw bytes in a snapshot");
+static_assert(std::is_trivially_copyable_v<MosquitoParameters>,
+              "MosquitoParameters are stored as raw bytes in a snapshot");
+
+static constexpr char magic[8] = {'P', 'L', 'A', 'S', 'X', 'S', 'N', 'P'};
+static constexpr std::uint32_t version = 3;
+static constexpr std::size_t alignment = 64;
+
+// Every array in the file. The pending infections of individual i are
+// pending_times[pending_offsets[i], pending_offsets[i + 1]), not including
+// next_infection. mosquitoes is empty, or holds m, S, I and foi followed by
+// the incubating and size of each cohort, oldest first.
+struct Section {
+  enum : std::size_t {
+    age,
+    I_CA,
+    I_CM,
+    I_A,
+    I_B,
+    zeta,
+    next_infection,
+    updated,
+    status,
+    pending_offsets,
+    pending_times,
+    engine,
+    mosquitoes,
+    count
+  };
+};
+
+struct Header {
+  char magic[8];
+  std::uint32_t version;
+  // Catches snapshots written with a different Parameters.
+  std::uint32_t parameters_bytes;
+  std::uint64_t size;
+  double t;
+  std::uint64_t has_streams;
+  std::uint64_t seed;
+  std::uint64_t epoch;
+  std::array<std::uint64_t, Section::count> offset;
+  std::array<std::uint64_t, Section::count> bytes;
+  unsigned char params[sizeof(Parameters)];
+  std::uint64_t has_mosquitoes;
+  unsigned char mosquito_params[sizeof(MosquitoParameters)];
+};
+
+// Number of values in the mosquitoes section before the cohorts.
+static constexpr std::size_t mosquito_values = 4;
+
+// The arrays of one population, ready to be written.
+struct Sections {
+  std::array<const void*, Section::count> data;
+  std::array<std::uint64_t, Section::count> bytes;
+};
+
+// Everything in PFalc that is not reachable through its public interface.
+struct SnapshotAccess {
+  static void read(const PFalc& person, double& ICA, double& ICM, double& IA,
+                   double& IB, double& z, double& next,
+                   std::vector<double>& pending) {
+    ICA = person.I_CA_;
+    ICM = person.I_CM_;
+    IA = person.I_A_;
+    IB = person.I_B_;
+    z = person.zeta_;
+    next = person.next_infection_;
+    InfectionPool::shared().collect(person.overflow_, pending);
+  }
+
+  static void write(PFalc& person, const double IB, const double z) {
+    person.I_B_ = IB;
+    person.zeta_ = z;
+  }
+};
+
+static std::uint64_t aligned(const std::uint64_t offset) {
+  return (offset + alignment - 1) / alignment * alignment;
+}
+
+template <class T>
+static std::uint64_t bytes_of(const std::vector<T>& v) {
+  return v.size() * sizeof(T);
+}
+
+// Snapshots always hold doubles. A column of StateType is either used as it is
+// or, in a single precision build, widened into storage.
+template <class T>
+static const std::vector<double>& as_doubles(const std::vector<T>& column,
+                                             std::vector<double>& storage) {
+  if constexpr (std::is_same_v<T, double>) {
+    return column;
+  } else {
+    storage.assign(column.begin(), column.end());
+    return storage;
+  }
+}
+
+static void write(const std::string& path, const double t,
+                  const std::uint64_t size, const Parameters& params,
+                  const RandomStreams* streams, const Mosquitoes* mosquitoes,
+                  Sections sections) {
+  std::vector<double> state;
+  if (mosquitoes) {
+    state = {mosquitoes->m(), mosquitoes->S(), mosquitoes->I(),
+             mosquitoes->foi()};
+    for (const auto& cohort : mosquitoes->cohorts()) {
+      state.push_back(cohort.incubating);
+      state.push_back(cohort.size);
+    }
+  }
+  sections.data[Section::mosquitoes] = state.data();
+  sections.bytes[Section::mosquitoes] = bytes_of(state);
+
+  Header header{};
+  std::memcpy(header.magic, magic, sizeof(magic));
+  header.version = version;
+  header.parameters_bytes = sizeof(Parameters);
+  header.size = size;
+  header.t = t;
+  header.has_streams = streams != nullptr;
+  header.seed = streams ? streams->seed() : 0;
+  header.epoch = streams ? streams->epoch() : 0;
+  std::memcpy(header.params, &params, sizeof(Parameters));
+  header.has_mosquitoes = mosquitoes != nullptr;
+  if (mosquitoes) {
+    std::memcpy(header.mosquito_params, &mosquitoes->parameters(),
+                sizeof(MosquitoParameters));
+  }
+  auto offset = aligned(sizeof(Header));
+  for (std::size_t s = 0; s < Section::count; ++s) {
+    header.offset[s] = offset;
+    header.bytes[s] = sections.bytes[s];
+    offset = aligned(offset + sections.bytes[s]);
+  }
+
+  std::ofstream file(path, std::ios::binary);
+  if (!file) {
+    throw std::runtime_error("Could not open " + path + " for writing");
+  }
+  const char padding[alignment] = {};
+  file.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+  auto written = static_cast<std::uint64_t>(sizeof(Header));
+  for (std::size_t s = 0; s < Section::count; ++s) {
+    file.write(padding, header.offset[s] - written);
+    file.write(static_cast<const char*>(sections.data[s]), sections.bytes[s]);
+    written = header.offset[s] + sections.bytes[s];
+  }
+  if (!file) {
+    throw std::runtime_error("Could not write the snapshot " + path);
+  }
+}
+
+static std::string engine_state() {
+  std::ostringstream state;
+  state << generator;
+  return state.str();
+}
+
+void save_snapshot(const std::string& path, const double t,
+                   const Population& population, const Parameters& params,
+                   const RandomStreams* streams,
+                   const Mosquitoes* mosquitoes) {
+  const auto n = population.size();
+  std::vector<std::uint8_t> status(n);
+  std::vector<std::uint64_t> offsets(n + 1, 0);
+  std::vector<double> pending;
+  for (std::size_t i = 0; i < n; ++i) {
+    status[i] = static_cast<std::uint8_t>(population.current_[i]);
+    population.pool().collect(population.overflow_[i], pending);
+    offsets[i + 1] = pending.size();
+  }
+  const auto state = engine_state();
+  std::array<std::vector<double>, 6> storage;
+  const auto& age = as_doubles(population.age_, storage[0]);
+  const auto& I_CA = as_doubles(population.I_CA_, storage[1]);
+  const auto& I_CM = as_doubles(population.I_CM_, storage[2]);
+  const auto& I_A = as_doubles(population.I_A_, storage[3]);
+  const auto& I_B = as_doubles(population.I_B_, storage[4]);
+  const auto& zeta = as_doubles(population.zeta_, storage[5]);
+
+  Sections sections;
+  sections.data = {age.data(),
+                   I_CA.data(),
+                   I_CM.data(),
+                   I_A.data(),
+                   I_B.data(),
+                   zeta.data(),
+                   population.next_infection_.data(),
+                   population.updated_.data(),
+                   status.data(),
+                   offsets.data(),
+                   pending.data(),
+                   state.data()};
+  sections.bytes = {bytes_of(age),
+                    bytes_of(I_CA),
+                    bytes_of(I_CM),
+                    bytes_of(I_A),
+                    bytes_of(I_B),
+                    bytes_of(zeta),
+                    bytes_of(population.next_infection_),
+                    bytes_of(population.updated_),
+                    bytes_of(status),
+                    bytes_of(offsets),
+                    bytes_of(pending),
+                    state.size()};
+  write(path, t, n, params, streams, mosquitoes, sections);
+}
+
+void save_snapshot(const std::string& path, const double t,
+                   const std::vector<Individual<PFalc>>& population,
+                   const Parameters& params, const RandomStreams* streams,
+                   const Mosquitoes* mosquitoes) {
+  const auto n = population.size();
+  std::vector<double> ages(n), ICA(n), ICM(n), IA(n), IB(n), z(n), next(n);
+  // The age and immunity of individuals stepped by OneStep are always up to
+  // date.
+  std::vector<double> updated(n, t);
+  std::vector<std::uint8_t> status(n);
+  std::vector<std::uint64_t> offsets(n + 1, 0);
+  std::vector<double> pending;
+  for (std::size_t i = 0; i < n; ++i) {
+    const auto& person = population[i];
+    ages[i] = person.age_;
+    status[i] = static_cast<std::uint8_t>(person.status_.current_);
+    SnapshotAccess::read(person.status_, ICA[i], ICM[i], IA[i], IB[i], z[i],
+                         next[i], pending);
+    offsets[i + 1] = pending.size();
+  }
+  const auto state = engine_state();
+
+  Sections sections;
+  sections.data = {ages.data(),    ICA.data(),
+                   ICM.data(),     IA.data(),
+                   IB.data(),      z.data(),
+                   next.data(),    updated.data(),
+                   status.data(),  offsets.data(),
+                   pending.data(), state.data()};
+  sections.bytes = {bytes_of(ages),    bytes_of(ICA),
+                    bytes_of(ICM),     bytes_of(IA),
+                    bytes_of(IB),      bytes_of(z),
+                    bytes_of(next),    bytes_of(updated),
+                    bytes_of(status),  bytes_of(offsets),
+                    bytes_of(pending), state.size()};
+  write(path, t, n, params, streams, mosquitoes, sections);
+}
+
+// Whether the sections of a snapshot, already known to lie inside its bytes,
+// hold what restore reads: one value per individual in every column, pending
+// offsets that never decrease and stay within the pending times, and a valid
+// Status for everyone.
+static bool consistent(const Header& header, const unsigned char* data) {
+  // The status section lies inside the file, so n is no larger than the file
+  // and none of the sizes below overflow.
+  const auto n = header.size;
+  if (header.bytes[Section::status] != n) {
+    return false;
+  }
+  auto holds = [&header](const std::size_t s, const std::uint64_t bytes) {
+    return header.offset[s] % alignment == 0 && header.bytes[s] == bytes;
+  };
+  for (const auto s :
+       {Section::age, Section::I_CA, Section::I_CM, Section::I_A, Section::I_B,
+        Section::zeta, Section::next_infection, Section::updated}) {
+    if (!holds(s, n * sizeof(double))) {
+      return false;
+    }
+  }
+  const auto pending = header.bytes[Section::pending_times] / sizeof(double);
+  if (!holds(Section::pending_offsets, (n + 1) * sizeof(std::uint64_t)) ||
+      !holds(Section::pending_times, pending * sizeof(double))) {
+    return false;
+  }
+
+  const auto mosquitoes = header.bytes[Section::mosquitoes] / sizeof(double);
+  if (!holds(Section::mosquitoes, mosquitoes * sizeof(double)) ||
+      (header.has_mosquitoes ? mosquitoes < mosquito_values ||
+                                   (mosquitoes - mosquito_values) % 2 != 0
+                             : mosquitoes != 0)) {
+    return false;
+  }
+
+  const auto* status = data + header.offset[Section::status];
+  for (std::uint64_t i = 0; i < n; ++i) {
+    if (status[i] >= n_status) {
+      return false;
+    }
+  }
+  const auto* offsets = reinterpret_cast<const std::uint64_t*>(
+      data + header.offset[Section::pending_offsets]);
+  if (offsets[0] != 0 || offsets[n] > pending) {
+    return false;
+  }
+  for (std::uint64_t i = 0; i < n; ++i) {
+    if (offsets[i + 1] < offsets[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+Snapshot::Snapshot(const std::string& path) {
+  const auto fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw std::runtime_error("Could not open the snapshot " + path);
+  }
+  struct stat info;
+  if (::fstat(fd, &info) != 0 ||
+      static_cast<std::size_t>(info.st_size) < sizeof(Header)) {
+    ::close(fd);
+    throw std::runtime_error(path + " is not a snapshot");
+  }
+  bytes_ = info.st_size;
+  auto* mapped = ::mmap(nullptr, bytes_, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (mapped == MAP_FAILED) {
+    throw std::runtime_error("Could not map the snapshot " + path);
+  }
+  data_ = static_cast<const unsigned char*>(mapped);
+
+  const auto& header = *reinterpret_cast<const Header*>(data_);
+  auto valid = std::memcmp(header.magic, magic, sizeof(magic)) == 0 &&
+               header.version == version &&
+               header.parameters_bytes == sizeof(Parameters);
+  for (std::size_t s = 0; valid && s < Section::count; ++s) {
+    valid = header.offset[s] <= bytes_ &&
+            header.bytes[s] <= bytes_ - header.offset[s];
+  }
+  valid = valid && consistent(header, data_);
+  if (!valid) {
+    ::munmap(const_cast<unsigned char*>(data_), bytes_);
+    data_ = nullptr;
+    throw std::runtime_error(path + " is not a compatible snapshot");
+  }
+}
+
+Snapshot::Snapshot(Snapshot&& other) noexcept
+    : data_(std::exchange(other.data_, nullptr)),
+      bytes_(std::exchange(other.bytes_, 0)) {}
+
+Snapshot& Snapshot::operator=(Snapshot&& other) noexcept {
+  if (this != &other) {
+    this->~Snapshot();
+    data_ = std::exchange(other.data_, nullptr);
+    bytes_ = std::exchange(other.bytes_, 0);
+  }
+  return *this;
+}
+
+Snapshot::~Snapshot() {
+  if (data_) {
+    ::munmap(const_cast<unsigned char*>(data_), bytes_);
+  }
+}
+
+template <class T>
+const T* Snapshot::section(const std::size_t index) const noexcept {
+  const auto& header = *reinterpret_cast<const Header*>(data_);
+  return reinterpret_cast<const T*>(data_ + header.offset[index]);
+}
+
+double Snapshot::time() const noexcept {
+  return reinterpret_cast<const Header*>(data_)->t;
+}
+
+std::size_t Snapshot::size() const noexcept {
+  return reinterpret_cast<const Header*>(data_)->size;
+}
+
+Parameters Snapshot::parameters() const {
+  Parameters params;
+  std::memcpy(&params, reinterpret_cast<const Header*>(data_)->params,
+              sizeof(Parameters));
+  return params;
+}
+
+std::optional<RandomStreams> Snapshot::streams() const {
+  const auto& header = *reinterpret_cast<const Header*>(data_);
+  if (!header.has_streams) {
+    return std::nullopt;
+  }
+  return RandomStreams(header.seed, header.epoch);
+}
+
+std::optional<Mosquitoes> Snapshot::mosquitoes() const {
+  const auto& header = *reinterpret_cast<const Header*>(data_);
+  if (!header.has_mosquitoes) {
+    return std::nullopt;
+  }
+  MosquitoParameters params;
+  std::memcpy(&params, header.mosquito_params, sizeof(MosquitoParameters));
+  const auto* state = section<double>(Section::mosquitoes);
+  const auto n = header.bytes[Section::mosquitoes] / sizeof(double);
+  std::deque<Mosquitoes::Cohort> cohorts;
+  for (auto k = mosquito_values; k < n; k += 2) {
+    cohorts.push_back({state[k], state[k + 1]});
+  }
+  return Mosquitoes(params, state[0], state[1], state[2], state[3],
+                    std::move(cohorts));
+}
+
+void Snapshot::restore(Population& population) const {
+  restore(population, 0, size());
+}
+
+void Snapshot::restore(Population& population, const std::size_t begin,
+                       const std::size_t end) const {
+  if (begin > end || end > size()) {
+    throw std::out_of_range("Individuals outside of the snapshot");
+  }
+  const auto n = end - begin;
+  const auto* status = section<std::uint8_t>(Section::status) + begin;
+  const auto* offsets =
+      section<std::uint64_t>(Section::pending_offsets) + begin;
+  const auto* pending = section<double>(Section::pending_times);
+  auto copy = [n, begin](auto& column, const double* data) {
+    column.assign(data + begin, data + begin + n);
+  };
+
+  population.truncate(0);
+  population.reserve(n);
+  copy(population.age_, section<double>(Section::age));
+  copy(population.I_CA_, section<double>(Section::I_CA));
+  copy(population.I_CM_, section<double>(Section::I_CM));
+  copy(population.I_A_, section<double>(Section::I_A));
+  copy(population.I_B_, section<double>(Section::I_B));
+  copy(population.zeta_, section<double>(Section::zeta));
+  copy(population.next_infection_, section<double>(Section::next_infection));
+  copy(population.updated_, section<double>(Section::updated));
+  population.current_.resize(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    population.current_[i] = static_cast<Status>(status[i]);
+  }
+  population.overflow_.assign(n, InfectionPool::none);
+  // The saved infections all come after next_infection_, so they go straight
+  // to the pool.
+  for (std::size_t i = 0; i < n; ++i) {
+    for (auto k = offsets[i]; k < offsets[i + 1]; ++k) {
+      population[i].scheduleInfection(pending[k]);
+    }
+  }
+}
+
+void Snapshot::restore(std::vector<Individual<PFalc>>& population) const {
+  const auto n = size();
+  const auto* ages = section<double>(Section::age);
+  const auto* ICA = section<double>(Section::I_CA);
+  const auto* ICM = section<double>(Section::I_CM);
+  const auto* IA = section<double>(Section::I_A);
+  const auto* IB = section<double>(Section::I_B);
+  const auto* z = section<double>(Section::zeta);
+  const auto* next = section<double>(Section::next_infection);
+  const auto* status = section<std::uint8_t>(Section::status);
+  const auto* offsets = section<std::uint64_t>(Section::pending_offsets);
+  const auto* pending = section<double>(Section::pending_times);
+
+  population.clear();
+  population.reserve(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    auto& person = population.emplace_back(
+        ages[i], static_cast<Status>(status[i]), ICA[i], ICM[i], IA[i]);
+    SnapshotAccess::write(person.status_, IB[i], z[i]);
+    if (next[i] != std::numeric_limits<double>::infinity()) {
+      person.status_.scheduleInfection(next[i]);
+    }
+    for (auto k = offsets[i]; k < offsets[i + 1]; ++k) {
+      person.status_.scheduleInfection(pending[k]);
+    }
+  }
+}
+
+void Snapshot::restore_generator(std::default_random_engine& engine) const {
+  const auto& header = *reinterpret_cast<const Header*>(data_);
+  const auto* text = section<char>(Section::engine);
+  std::istringstream state(
+      std::string(text, text + header.bytes[Section::engine]));
+  state >> engine;
+}
+
+}  // namespace griffin
+}  // namespace falciparum
+}  // namespace plasx
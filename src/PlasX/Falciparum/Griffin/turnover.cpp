@@ -0,0 +1,31 @@
+#include "PlasX/Falciparum/Griffin/turnover.hpp"
+
+#include <cmath>
+
+#include "PlasX/Falciparum/Griffin/immunity.hpp"
+#include "PlasX/Falciparum/Griffin/population.hpp"
+
+namespace plasx {
+namespace falciparum {
+namespace griffin {
+
+void give_birth(Population& population, const std::size_t index,
+                const double ICM, const double t, const double zeta) noexcept {
+  population.assign(index, 0.0, Status::S, 0.0, ICM, 0.0, zeta);
+  population.updated_[index] = t;
+}
+
+void catch_up(Population& population, const std::size_t begin,
+              const std::size_t end, const Parameters& params,
+              const double t) {
+  // Age first, catch_up_immunity moves updated_ on to t.
+  for (auto i = begin; i < end; ++i) {
+    const auto updated = population.updated_[i];
+    population.age_[i] += std::isnan(updated) ? 0.0 : t - updated;
+  }
+  catch_up_immunity(population, begin, end, params, t);
+}
+
+}  // namespace griffin
+}  // namespace falciparum
+}  // namespace plasx
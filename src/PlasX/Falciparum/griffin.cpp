@@ -1,353 +1,877 @@
 #include "PlasX/Falciparum/griffin.hpp"
 
-#include <iostream>
-
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+
+#include "PlasX/Falciparum/Griffin/biting.hpp"
+#include "PlasX/Falciparum/Griffin/cohorts.hpp"
+#include "PlasX/Falciparum/Griffin/domain.hpp"
+#include "PlasX/Falciparum/Griffin/event_log.hpp"
+#include "PlasX/Falciparum/Griffin/immunity_functions.hpp"
+#include "PlasX/Falciparum/Griffin/instrumentation.hpp"
+#include "PlasX/Falciparum/Griffin/mosquito.hpp"
+#include "PlasX/Falciparum/Griffin/population.hpp"
+#include "PlasX/Falciparum/Griffin/recorder.hpp"
+#include "PlasX/Falciparum/Griffin/turnover.hpp"
+#include "PlasX/Falciparum/Griffin/update.hpp"
 #include "PlasX/random.hpp"
+#include "PlasX/vector_math.hpp"
 
 namespace plasx {
 namespace falciparum {
 namespace griffin {
 
-// Delay between bite and infection.
-auto delay = 0.0;
+// The immunity functions are only rebuilt when the parameters change. There is
+// one cache per thread so that independent simulations can run side by side.
+static const ImmunityFunctions& immunity_functions(const Parameters& params) {
+  thread_local std::optional<Parameters> cached_params;
+  thread_local std::optional<ImmunityFunctions> cached;
+  if (!cached || !(*cached_params == params)) {
+    cached.emplace(params);
+    cached_params = params;
+  }
+  return *cached;
+}
 
-static bool determine_event(double lambda, double dt) {
-  // Determine if someone is infected.
-  auto r = genunf_std(generator);
-  if (exp(-dt * lambda) < r) {
-    return true;  // You were infected.
+// Number of infections pending for the individual at index.
+[[maybe_unused]] static std::size_t queue_length(
+    const Population& population, const std::size_t index) {
+  if (population.next_infection_[index] ==
+      std::numeric_limits<double>::infinity()) {
+    return 0;
   }
-  return false;  // You were not infected.
+  return 1 + population.pool().length(population.overflow_[index]);
 }
 
-static void SAU_infection(PFalc& state, const Parameters& params,
-                          const double t) {
-  // This function determines what happens with an infection in the S A or U
-  // compartment. It is assumed that Treatment wipes all infections that could
-  // occur
-
-  // You only come into this function if you are in S A or U, we do not need to
-  // consider the case of D going to D.
-  const auto r1 = genunf_std(generator), r2 = genunf_std(generator);
-
-  // Get parameters
-  const auto f_T = params.f_T;  // Is this a constant?
-  const auto I_C0 = params.I_C0;
-  const auto kappa_C = params.kappa_C;
-  // Do not have this in the individual as we do not want accidentally forget
-  // to update it.
-  const auto I_C = state.getIC();
-  // Get parameters for phi (immunity dependent)
-  const auto IC_ratio = I_C / I_C0;
-  const auto phi = 1.0 / (1.0 + pow(IC_ratio, kappa_C));
-
-  // Which compartment does the new infection go to.
-  auto clinical_infection = r1 <= phi;
-  if (!clinical_infection) {
-    state.current_ = Status::A;
-    return;
+// Update population[begin, end) in four passes. First the block is indexed by
+// compartment, keeping the order within each. Then every probability the block
+// needs is computed with the array kernels in vector_math.hpp, the chance of
+// being bitten only for S, A, U and D and of leaving A only for A. Then all
+// the uniform draws are generated in one go, and only then are the
+// individuals visited, one compartment at a time so that every loop calls a
+// single update rule. Each individual owns three consecutive draws, which is
+// the most any compartment uses in a step, so the order they are visited in
+// does not change the result. Last, the biting weights are added to humans in
+// the order of the block, the newborn_weight of a newborn in place of each of
+// the dead. events_for(age, index) gives the Events for the individual at
+// index in the population. If bitten is not null, the bites were allocated
+// before the step (see BitingTable) and bitten[begin + i] says who was bitten,
+// so b is not needed. Only the Enabled features are compiled in, and without
+// mortality dead is not touched. What the block did is added to counters if
+// the step is instrumented, and it is not touched otherwise.
+template <class Enabled, class EventsFor>
+static void update_block(Population& population, const std::size_t begin,
+                         const std::size_t end, const StepConstants& constants,
+                         const ImmunityFunctions& functions, const double eir,
+                         const char* bitten, const double t, Xoshiro256x4& rng,
+                         char* dead, Infectiousness& humans,
+                         const double newborn_weight, EventsFor events_for,
+                         [[maybe_unused]] StepCounters* counters) {
+  constexpr std::size_t draws_per_individual = 3;
+  constexpr auto index = [](const Status s) {
+    return static_cast<std::size_t>(s);
+  };
+  const auto m = end - begin;
+  const auto* age = population.age_.data() + begin;
+  const auto* I_A = population.I_A_.data() + begin;
+  const auto* I_B = population.I_B_.data() + begin;
+  const auto* zeta = population.zeta_.data() + begin;
+  const auto* status = population.current_.data() + begin;
+  const auto mu_d = constants.mu_d, dt = constants.dt;
+
+  thread_local std::vector<std::uint32_t> order;
+  // In a single precision build these are float too, as are the kernels.
+  thread_local std::vector<StateType> bite, psi, a_survival, a_death_share;
+  thread_local std::vector<double> draws;
+
+  // order[first[s], first[s + 1]) are the individuals in compartment s.
+  std::array<std::size_t, n_status + 1> first{};
+  for (std::size_t i = 0; i < m; ++i) {
+    ++first[index(status[i]) + 1];
+  }
+  for (std::size_t s = 0; s < n_status; ++s) {
+    first[s + 1] += first[s];
+  }
+  order.resize(m);
+  auto next = first;
+  for (std::size_t i = 0; i < m; ++i) {
+    order[next[index(status[i])]++] = i;
+  }
+  // T and P come last, and are never bitten.
+  const auto n_bitten = first[index(Status::T)];
+  const auto draw_bites = bitten == nullptr;
+  const auto* in_A = order.data() + first[index(Status::A)];
+  const auto n_A = first[index(Status::U)] - first[index(Status::A)];
+
+  bite.resize(n_bitten);
+  psi.resize(m);
+  a_survival.resize(n_A);
+  a_death_share.resize(n_A);
+  draws.resize(draws_per_individual * m);
+
+  // Fill psi with psi, in the order of the block, bite with b, in the order
+  // of order, and a_survival with r_A of those in A.
+  if (functions.exact()) {
+    const auto& c = constants;
+    for (std::size_t i = 0; i < m; ++i) {
+      psi[i] = -age[i] * c.inv_age_0;
+    }
+    for (std::size_t k = 0; draw_bites && k < n_bitten; ++k) {
+      bite[k] = I_B[order[k]] * c.inv_I_B0;
+    }
+    for (std::size_t k = 0; k < n_A; ++k) {
+      a_survival[k] = I_A[in_A[k]] * c.inv_I_A0;
+    }
+    batch_exp(psi.data(), psi.data(), m);
+    if (draw_bites) {
+      batch_pow(bite.data(), c.kappa_B, bite.data(), n_bitten);
+    }
+    batch_pow(a_survival.data(), -c.kappa_A, a_survival.data(), n_A);
+    for (std::size_t i = 0; i < m; ++i) {
+      psi[i] = 1.0 - c.rho * psi[i];
+    }
+    for (std::size_t k = 0; draw_bites && k < n_bitten; ++k) {
+      bite[k] = c.b_min + c.bdiff / (1.0 + bite[k]);
+    }
+    for (std::size_t k = 0; k < n_A; ++k) {
+      a_survival[k] = c.r_A0 + c.r_A0_w / (1.0 + a_survival[k]);
+    }
+  } else {
+    for (std::size_t i = 0; i < m; ++i) {
+      psi[i] = functions.psi(age[i]);
+    }
+    for (std::size_t k = 0; draw_bites && k < n_bitten; ++k) {
+      bite[k] = functions.b(I_B[order[k]]);
+    }
+    for (std::size_t k = 0; k < n_A; ++k) {
+      a_survival[k] = functions.r_A(I_A[in_A[k]]);
+    }
   }
 
-  // Clinical infections - treated or untreated.
-  auto is_treated = r2 <= f_T;
-  if (is_treated) {
-    state.clearInfectionQueue();
-    state.current_ = Status::T;
+  // Probability of not being bitten, exp(-dt * eir * psi * b * zeta), or 0
+  // or 1 if the bites were allocated, and of staying in A, as in A_exit.
+  if (draw_bites) {
+    for (std::size_t k = 0; k < n_bitten; ++k) {
+      const auto i = order[k];
+      const auto lambda = eir * psi[i] * bite[k] * zeta[i];
+      bite[k] = -dt * lambda;
+    }
+  }
+  for (std::size_t k = 0; k < n_A; ++k) {
+    if constexpr (Enabled::mortality) {
+      const auto prob_event = a_survival[k] + mu_d;
+      a_death_share[k] = mu_d / prob_event;
+      a_survival[k] = -dt * prob_event;
+    } else {
+      a_survival[k] *= -dt;
+    }
+  }
+  if (draw_bites) {
+    batch_exp(bite.data(), bite.data(), n_bitten);
   } else {
-    // You have an untreated clinical disease
-    state.current_ = Status::D;
+    for (std::size_t k = 0; k < n_bitten; ++k) {
+      bite[k] = bitten[begin + order[k]] ? 0.0 : 1.0;
+    }
+  }
+  batch_exp(a_survival.data(), a_survival.data(), n_A);
+
+  rng.fill_uniform(draws.data(), draws.size());
+
+  // Update everyone in compartment s with update(state, k, uniform, events),
+  // where order[k] is their place in the block.
+  auto visit = [&](const Status s, auto update) {
+    [[maybe_unused]] std::chrono::steady_clock::time_point started;
+    if constexpr (instrumented) {
+      started = std::chrono::steady_clock::now();
+    }
+    for (auto k = first[index(s)]; k < first[index(s) + 1]; ++k) {
+      const auto i = order[k];
+      auto state = population[begin + i];
+      const auto* next_draw = draws.data() + draws_per_individual * i;
+      auto uniform = [&next_draw] { return *next_draw++; };
+      auto events = events_for(age[i], begin + i);
+      if constexpr (instrumented) {
+        const auto pending = queue_length(population, begin + i);
+        ++counters->queue_lengths[std::min(pending, queue_bins - 1)];
+      }
+      const auto death = update(state, k, uniform, events);
+      events.update(s, state.current_, death);
+      if constexpr (Enabled::mortality) {
+        dead[begin + i] = death;
+      }
+      if constexpr (instrumented) {
+        counters->draws[index(s)] +=
+            next_draw - (draws.data() + draws_per_individual * i);
+        ++(death ? counters->deaths[index(s)]
+                 : counters->transitions[index(s)][index(state.current_)]);
+      }
+    }
+    if constexpr (instrumented) {
+      const std::chrono::duration<double> elapsed =
+          std::chrono::steady_clock::now() - started;
+      counters->seconds[index(s)] += elapsed.count();
+      counters->visits[index(s)] += first[index(s) + 1] - first[index(s)];
+    }
+  };
+  const auto& exits = constants.exits;
+  visit(Status::S, [&](auto& state, auto k, auto& uniform, auto& events) {
+    return S_update<Enabled>(state, constants, functions, bite[k],
+                             exits[index(Status::S)], t, uniform, events);
+  });
+  visit(Status::A, [&](auto& state, auto k, auto& uniform, auto& events) {
+    const auto a = k - first[index(Status::A)];
+    return A_update<Enabled>(state, constants, functions, bite[k],
+                             Exit{a_survival[a], a_death_share[a]}, t,
+                             uniform, events);
+  });
+  visit(Status::U, [&](auto& state, auto k, auto& uniform, auto& events) {
+    return U_update<Enabled>(state, constants, functions, bite[k],
+                             exits[index(Status::U)], t, uniform, events);
+  });
+  visit(Status::D, [&](auto& state, auto k, auto& uniform, auto& events) {
+    return D_update<Enabled>(state, constants, functions, bite[k],
+                             exits[index(Status::D)], t, uniform, events);
+  });
+  visit(Status::T, [&](auto& state, auto, auto& uniform, auto& events) {
+    return T_update<Enabled>(state, constants, functions, 1.0,
+                             exits[index(Status::T)], t, uniform, events);
+  });
+  visit(Status::P, [&](auto& state, auto, auto& uniform, auto& events) {
+    return P_update<Enabled>(state, constants, functions, 1.0,
+                             exits[index(Status::P)], t, uniform, events);
+  });
+
+  for (std::size_t i = 0; i < m; ++i) {
+    const auto died = Enabled::mortality && dead[begin + i];
+    humans.add(died ? newborn_weight : psi[i] * zeta[i],
+               died ? Status::S : status[i]);
   }
-  return;
 }
 
-// Update the state of individuals.
-static bool S_update(PFalc& state, const Parameters& params,
-                     const double lambda, const double t, const double dt) {
-  // Check to see if a bite occurs this time step.
-  auto successful_bite = determine_event(lambda, dt);
-  if (successful_bite) {
-    // Add this infection to the schedule with the appropriate delay.
-    state.scheduleInfection(t + delay);
+// Decay the immunity of population[begin, end) and age everyone by dt, at the
+// end of a step. The dead are skipped, their slots are about to be taken by
+// newborns, but the living are counted towards the mothers. Without mortality
+// there are neither.
+template <class Enabled, class EventsFor>
+static void advance(Population& population, const std::size_t begin,
+                    const std::size_t end, const char* dead,
+                    const ImmunityDecay& decay, const double t,
+                    const double dt, Mothers& mothers, EventsFor events_for) {
+  if constexpr (Enabled::immunity) {
+    decay_immunity(population, begin, end, decay, t + dt);
   }
-
-  // Check if a prior bite becomes an active infection this timestep.
-  auto infection_active = state.updateInfection(t);
-  if (!infection_active) {
-    auto death = determine_event(params.mu_d, dt);
-    return death;
+  auto* age = population.age_.data();
+  const auto* I_CA = population.I_CA_.data();
+  const auto* status = population.current_.data();
+  for (auto i = begin; i < end; ++i) {
+    if constexpr (Enabled::mortality) {
+      if (dead[i]) {
+        continue;
+      }
+    }
+    events_for(age[i], i).aged(age[i] + dt, status[i]);
+    age[i] += dt;
+    if constexpr (Enabled::mortality) {
+      mothers.add(age[i], I_CA[i]);
+    }
   }
-
-  // There was an infection activated, determine what happened.
-  SAU_infection(state, params, t);
-  return false;
 }
 
-static bool A_update(PFalc& state, const Parameters& params,
-                     const double lambda, const double t,
-                     const double dt) noexcept {
-  // Construct the rate that the individual will leave A .
-  const auto r_A0 = params.r_A0, kappa_A = params.kappa_A, I_A0 = params.I_A0,
-             w_A = params.w_A, mu_d = params.mu_d;
-  const auto IA_ratio_power_inverse = pow(state.getIA() / I_A0, -kappa_A);
-  // Reformulate to be more stable. If the top and bottom got too large youd
-  // be in trouble.
-  const auto r_A = r_A0 * (1.0 + (w_A - 1.0) / (1.0 + IA_ratio_power_inverse));
-
-  // Either something will happen, or nothing will happen.
-  const auto prob_event = r_A + mu_d;
-
-  // Check to see if a bite occurs this time step.
-  auto successful_bite = determine_event(lambda, dt);
-  if (successful_bite) {
-    // Add this infection to the schedule with the appropriate delay.
-    state.scheduleInfection(t + delay);
-  }
-
-  // Check and update the infection Queue - this function changes the update
-  // function.
-  auto infection_active = state.updateInfection(t);
-  if (infection_active) {
-    SAU_infection(state, params, t);
-    return false;
-  }
+// The three step functions below take events_for(age, index), which gives the
+// Events for the individual at index. The public overloads either record
+// nothing, tally into a Recorder or write to an EventLog. Every individual who
+// dies is replaced in place by a newborn once the step is done, when the
+// maternal immunity they are born with is known. The infectiousness of the
+// population at the end of the step, which drives the mosquitoes, is summed
+// into humans along the way.
+template <class EventsFor>
+static void step(const double t, const double dt,
+                 std::vector<Individual<PFalc>>& population,
+                 const Parameters& params, double eir, Infectiousness& humans,
+                 EventsFor events_for) {
+  const auto& functions = immunity_functions(params);
+  const StepConstants constants(params, dt);
+  const auto decay = immunity_decay(params, dt);
+  auto uniform = [] { return genunf_std(generator); };
+
+  const auto newborn_weight = functions.psi(0.0);
 
-  // Does a non-infection event occur.
-  const auto event_occurs = determine_event(prob_event, dt);
-  if (!event_occurs) {
-    return false;
+  // Loop over individuals
+  thread_local std::vector<std::size_t> dead;
+  dead.clear();
+  Mothers mothers;
+  for (std::size_t i = 0; i < population.size(); ++i) {
+    auto& person = population[i];
+    auto events = events_for(person.age_, i);
+    const auto weight = biting_weight(person.status_, person.age_, functions);
+    const auto death = update_individual(person.status_, weight, constants,
+                                         functions, eir, t, uniform, events);
+    if (death) {
+      dead.push_back(i);
+      humans.add(newborn_weight, Status::S);
+      continue;
+    }
+    humans.add(weight, person.status_.current_);
+    person.status_.decayImmunity(decay);
+    events.aged(person.age_ + dt, person.status_.current_);
+    person.age_ += dt;
+    mothers.add(person.age_, person.status_.getICA());
   }
 
-  // What event occurs.
-  const auto r = genunf_std(generator);
-  const auto death = r < mu_d / prob_event;
-  if (!death) {
-    // Move from A to U.
-    state.current_ = Status::U;
+  const auto ICM = mothers.newborn_ICM(params);
+  for (const auto i : dead) {
+    population[i] = Individual<PFalc>(0.0, Status::S, 0.0, ICM, 0.0);
+    population[i].status_.setZeta(draw_zeta(params, generator));
+    events_for(0.0, i).birth();
   }
-  return death;
 }
 
-static bool U_update(PFalc& state, const Parameters& params,
-                     const double lambda, const double t,
-                     const double dt) noexcept {
-  // In this compartment you can be infected or move to susceptible.
-  const auto mu_d = params.mu_d;
-  const auto prob_event = params.r_U + mu_d;
-  // Check to see if a bite occurs this time step.
-  auto successful_bite = determine_event(lambda, dt);
-  if (successful_bite) {
-    // Add this infection to the schedule with the appropriate delay.
-    state.scheduleInfection(t + delay);
-  }
-
-  // Check and update the infection Queue - this function changes the update
-  // function.
-  auto infection_active = state.updateInfection(t);
-  if (infection_active) {
-    SAU_infection(state, params, t);
-    return false;
+template <class EventsFor>
+static void step(const double t, const double dt, Population& population,
+                 const Parameters& params, double eir, Infectiousness& humans,
+                 EventsFor events_for) {
+  // Same as above, but the immunity and age columns are advanced in one pass
+  // at the end.
+  const auto& functions = immunity_functions(params);
+  const StepConstants constants(params, dt);
+  auto uniform = [] { return genunf_std(generator); };
+  const auto n = population.size();
+  const auto newborn_weight = functions.psi(0.0);
+  thread_local std::vector<char> dead;
+  dead.assign(n, 0);
+  for (std::size_t i = 0; i < n; ++i) {
+    auto state = population[i];
+    const auto age = population.age_[i];
+    const auto weight = biting_weight(state, age, functions);
+    const auto death = update_individual(state, weight, constants, functions,
+                                         eir, t, uniform, events_for(age, i));
+    dead[i] = death;
+    humans.add(death ? newborn_weight : weight,
+               death ? Status::S : state.current_);
   }
 
-  // Does a non-infection event occur.
-  const auto event_occurs = determine_event(prob_event, dt);
-  if (!event_occurs) {
-    return false;
+  Mothers mothers;
+  advance<AllFeatures>(population, 0, n, dead.data(),
+                       immunity_decay(params, dt), t, dt, mothers, events_for);
+  const auto ICM = mothers.newborn_ICM(params);
+  for (std::size_t i = 0; i < n; ++i) {
+    if (dead[i]) {
+      give_birth(population, i, ICM, t + dt, draw_zeta(params, generator));
+      events_for(0.0, i).birth();
+    }
   }
+}
 
-  // Hey something is going to happen, but what! Lets find out.
-  const auto r = genunf_std(generator);  // random number
-  const auto death = r < mu_d / prob_event;
-  if (!death) {
-    // Move to S
-    state.current_ = Status::S;
+// The policies of the blocked step. Each is picked once per step, by whether
+// its option was given to OneStep, so they are left to run time.
+
+// The blocks are stepped across pool, or in order on this thread without one.
+// Neither changes the result.
+struct Blocks {
+  template <class Block>
+  void operator()(const std::size_t n_blocks, const Block& block) const {
+    if (pool) {
+      pool->parallel_for(n_blocks, block);
+      return;
+    }
+    for (std::size_t i = 0; i < n_blocks; ++i) {
+      block(i);
+    }
   }
-  return death;
-}
 
-static bool D_update(PFalc& state, const Parameters& params,
-                     const double lambda, const double t,
-                     const double dt) noexcept {
-  // This checks to see if the time you are in D is enough to transition.
-  const auto mu_d = params.mu_d;
-  const auto prob_event = params.r_D + mu_d;
-
-  // Check to see if a bite occurs this time step.
-  auto successful_bite = determine_event(lambda, dt);
-  if (successful_bite) {
-    // Add this infection to the schedule with the appropriate delay.
-    state.scheduleInfection(t + delay);
-  }
-
-  // Check and update the infection Queue - this function changes the update
-  // function. Throw away result.
-
-  // Do we want to skip the function if this is the case?
-  // We need to keep checking the queue, but we throw out any that activate as
-  // we will stay in D. Hilariously, this is equivalent to just being infected
-  // and going to D again thanks to the wonders of the exponential
-  // distribution.
-  auto infection_active = state.updateInfection(t);
-  if (infection_active) {
-    // They go to D... so do not remove them from D and continue to do nothing
-    // else.
-    return false;
+  ThreadPool* pool;
+};
+
+// The population is this process's shard of domain, or without one the whole
+// population is stepped on this process and nothing is shared.
+struct Shard {
+  std::size_t first_block() const noexcept {
+    return domain ? domain->first_block() : 0;
+  };
+  void share(std::vector<Mothers>& mothers,
+             std::vector<Infectiousness>& humans) const {
+    if (domain) {
+      domain->share(mothers, humans);
+    }
+  };
+
+  Domain* domain;
+};
+
+// The bites of the step are allocated by table before the sweep, from the
+// streams of epoch, and the table is told of the zeta of each newborn. Without
+// one, whether each individual is bitten is decided in update_block.
+struct Bites {
+  const char* allocate(const Population& population, const Parameters& params,
+                       const ImmunityFunctions& functions, double eir,
+                       double dt, std::size_t first_block) {
+    return table ? table->allocate(population, params, functions, eir, dt,
+                                   *streams, epoch, first_block)
+                 : nullptr;
+  };
+  void born(const Population& population, std::size_t i) {
+    if (table) {
+      table->born(population, i);
+    }
+  };
+
+  BitingTable* table;
+  const RandomStreams* streams;
+  std::uint64_t epoch;
+};
+
+// blocks_for, an observer such as Unobserved, gives events_for for each block
+// when called with n_blocks. Each block is handed its own events so that
+// nothing is shared between threads. The population is blocks
+// [first_block, ...) of the shard's whole population, and the shard shares
+// the counts of each block with the rest of it. Only the Enabled features are
+// compiled in.
+template <class Enabled, class BlocksFor>
+static void specialised_step(const double t, const double dt,
+                             Population& population, const Parameters& params,
+                             double eir, Infectiousness& humans,
+                             const Blocks& for_blocks, RandomStreams& streams,
+                             const Shard& shard, BlocksFor& blocks_for,
+                             Bites& biting) {
+  const auto n = population.size();
+  const auto n_blocks = (n + OneStep::block_size - 1) / OneStep::block_size;
+  const auto first_block = shard.first_block();
+  const auto epoch = streams.next_epoch();
+  const auto& functions = immunity_functions(params);
+  auto step_params = params;
+  if constexpr (!Enabled::mortality) {
+    step_params.mu_d = 0.0;
+  }
+  const StepConstants constants(step_params, dt);
+  const auto decay = immunity_decay(params, dt);
+  const auto newborn_weight = functions.psi(0.0);
+  auto events_for = blocks_for(n_blocks);
+  const auto* bitten =
+      biting.allocate(population, params, functions, eir, dt, first_block);
+
+  // Deaths are only flagged during the parallel sweep. The newborns that
+  // replace them are added in order afterwards, once every block has counted
+  // its mothers.
+  // The buffers are kept between steps. Worker threads have their own
+  // thread_local variables, so they are handed references to this thread's.
+  thread_local std::vector<char> dead_buffer;
+  thread_local std::vector<Mothers> mothers_buffer;
+  thread_local std::vector<Infectiousness> humans_buffer;
+  thread_local std::vector<StepCounters> counters_buffer;
+  auto& dead = dead_buffer;
+  auto& mothers = mothers_buffer;
+  auto& block_humans = humans_buffer;
+  auto& counters = counters_buffer;
+  if constexpr (Enabled::mortality) {
+    dead.assign(n, 0);
+  }
+  mothers.assign(n_blocks, Mothers());
+  block_humans.assign(n_blocks, Infectiousness());
+  [[maybe_unused]] std::chrono::steady_clock::time_point started;
+  [[maybe_unused]] PerfCounters::Reading hardware;
+  if constexpr (instrumented) {
+    counters.assign(n_blocks, StepCounters());
+    hardware = Instrumentation::global().hardware_now();
+    started = std::chrono::steady_clock::now();
+  }
+  for_blocks(n_blocks, [&](std::size_t block) {
+    Xoshiro256x4 rng(streams.key(epoch, first_block + block));
+    const auto begin = block * OneStep::block_size;
+    const auto end = std::min(n, begin + OneStep::block_size);
+    update_block<Enabled>(population, begin, end, constants, functions, eir,
+                          bitten, t, rng, dead.data(), block_humans[block],
+                          newborn_weight, events_for(block),
+                          instrumented ? &counters[block] : nullptr);
+    advance<Enabled>(population, begin, end, dead.data(), decay, t, dt,
+                     mothers[block], events_for(block));
+  });
+
+  // Merged in block order, so the sums do not depend on the threads.
+  shard.share(mothers, block_humans);
+  Mothers all;
+  for (const auto& block : mothers) {
+    all.merge(block);
+  }
+  for (const auto& block : block_humans) {
+    humans.merge(block);
+  }
+  if constexpr (Enabled::mortality) {
+    // Newborns draw their zeta from a stream of their block's own, indexed
+    // from the top so that it is never one of the sweep's.
+    const auto ICM = all.newborn_ICM(params);
+    for (std::size_t block = 0; block < n_blocks; ++block) {
+      auto rng = streams.stream(epoch, ~(first_block + block));
+      const auto begin = block * OneStep::block_size;
+      const auto end = std::min(n, begin + OneStep::block_size);
+      for (auto i = begin; i < end; ++i) {
+        if (dead[i]) {
+          give_birth(population, i, ICM, t + dt, draw_zeta(params, rng));
+          biting.born(population, i);
+          events_for(block)(0.0, i).birth();
+        }
+      }
+    }
   }
 
-  // Does a non-infection event occur.
-  const auto event_occurs = determine_event(prob_event, dt);
-  if (!event_occurs) {
-    return event_occurs;
+  if constexpr (instrumented) {
+    const std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - started;
+    StepCounters step;
+    for (const auto& block : counters) {
+      step.merge(block);
+    }
+    auto& instrumentation = Instrumentation::global();
+    instrumentation.add_step(elapsed.count(), step,
+                             instrumentation.hardware_now() - hardware);
   }
+}
 
-  const auto r = genunf_std(generator);  // random number
-  const auto death = r < mu_d / prob_event;
-  if (!death) {
-    // You've been here long enough, move from D to A.
-    state.current_ = Status::A;
+// Leave out every feature that the parameters switch off. The result is
+// exactly the same, as every individual keeps their own uniform draws.
+template <class BlocksFor>
+static void step(const double t, const double dt, Population& population,
+                 const Parameters& params, double eir, Infectiousness& humans,
+                 const Blocks& for_blocks, RandomStreams& streams,
+                 const Shard& shard, BlocksFor& blocks_for, Bites& biting) {
+  auto step_with = [&](auto enabled) {
+    specialised_step<decltype(enabled)>(t, dt, population, params, eir,
+                                        humans, for_blocks, streams, shard,
+                                        blocks_for, biting);
+  };
+  const auto mortality = params.mu_d != 0.0, delayed = delay != 0.0;
+  if (mortality && delayed) {
+    step_with(AllFeatures{});
+  } else if (mortality) {
+    step_with(Features<true, false, true>{});
+  } else if (delayed) {
+    step_with(Features<false, true, true>{});
+  } else {
+    step_with(Features<false, false, true>{});
   }
-  return death;
 }
 
-static bool T_update(PFalc& state, const Parameters& params,
-                     const double lambda, const double t, const double dt) {
-  // This checks to see if the time you are in T is enough to transition.
-  const auto mu_d = params.mu_d;
-  const auto prob_event = params.r_T + mu_d;
-  const auto event_occurs = determine_event(prob_event, dt);
+static auto no_events(double, std::size_t) { return NoEvents{}; }
 
-  if (!event_occurs) {
-    return event_occurs;
-  }
+// The observers of the blocked step. Each is called once per step, before the
+// sweep, with the number of blocks, and gives events_for for each block (see
+// specialised_step). They decide what is done for every individual, so they
+// are compiled in.
 
-  const auto r = genunf_std(generator);
-  const auto death = r < mu_d / prob_event;
-  if (!death) {
-    state.current_ = Status::P;
-  }
-  return death;
-}
+// Nothing is recorded.
+struct Unobserved {
+  auto operator()(std::size_t) const {
+    return [](std::size_t) { return no_events; };
+  };
+};
+
+// One tally per block, by the age bands of recorder, merged in block order
+// once the sweep is done.
+struct Tallied {
+  explicit Tallied(const Recorder& recorder) : recorder(recorder){};
+
+  auto operator()(std::size_t n_blocks) {
+    tallies.assign(n_blocks, Tally(recorder.bands()));
+    return [this](std::size_t block) {
+      return [&tally = tallies[block], this](double age, std::size_t) {
+        return TallyEvents{tally, recorder, recorder.band(age)};
+      };
+    };
+  };
+
+  Tally merged() const {
+    Tally tally(recorder.bands());
+    for (const auto& block : tallies) {
+      tally.merge(block);
+    }
+    return tally;
+  };
+
+  const Recorder& recorder;
+  std::vector<Tally> tallies;
+};
+
+// Every event of the step is logged, in block order.
+struct Logged {
+  auto operator()(std::size_t n_blocks) {
+    log.start_step(n_blocks);
+    return [this](std::size_t block) {
+      return [&buffer = log.buffer(block)](double, std::size_t i) {
+        return LogEvents{buffer, i};
+      };
+    };
+  };
+
+  EventLog& log;
+};
 
-static bool P_update(PFalc& state, const Parameters& params,
-                     const double lambda, const double t, double dt) {
-  // This checks to see if the time you are in P is enough to transition.
-  const auto mu_d = params.mu_d;
-  const auto prob_event = params.r_P + mu_d;
-  const auto event_occurs = determine_event(prob_event, dt);
+// The blocked step, with the policies picked by options and the events of
+// every individual handed to observer.
+template <class Observer>
+static void blocked_step(const double t, const double dt,
+                         Population& population, const Parameters& params,
+                         double eir, Infectiousness& humans,
+                         const StepOptions& options, Observer& observer) {
+  auto& streams = *options.streams;
+  // The streams of the table come from an epoch of their own, taken before
+  // the one of the step.
+  Bites biting{options.table, &streams,
+               options.table ? streams.next_epoch() : 0};
+  step(t, dt, population, params, eir, humans, Blocks{options.pool}, streams,
+       Shard{options.domain}, observer, biting);
+}
 
-  if (!event_occurs) {
-    return event_occurs;
+// The step without blocks, which draws from the global generator.
+template <class Layout>
+static void unblocked_step(const double t, const double dt,
+                           Layout& population, const Parameters& params,
+                           double eir, Infectiousness& humans,
+                           Recorder* recorder) {
+  if (!recorder) {
+    step(t, dt, population, params, eir, humans, no_events);
+    return;
   }
+  if (!recorder->counted()) {
+    recorder->count(population);
+  }
+  Tally tally(recorder->bands());
+  step(t, dt, population, params, eir, humans,
+       [&](double age, std::size_t) {
+         return TallyEvents{tally, *recorder, recorder->band(age)};
+       });
+  recorder->end_step(t + dt, tally);
+}
 
-  const auto r = genunf_std(generator);
-  const auto death = r < mu_d / prob_event;
-  if (!death) {
-    state.current_ = Status::S;
+// step(eir, humans) runs the human step. With mosquitoes the humans see their
+// EIR at the start of the step, and the mosquitoes are then stepped with the
+// infectiousness of the humans at its end. With a fixed EIR the
+// infectiousness of the humans is not needed and is thrown away.
+template <class Step>
+static double coupled(const double t, const double dt,
+                      const StepOptions& options, Step step) {
+  Infectiousness humans;
+  if (!options.mosquitoes) {
+    step(options.eir, humans);
+    return t + dt;
   }
-  return death;
+  step(options.mosquitoes->eir(), humans);
+  options.mosquitoes->step(dt, humans);
+  return t + dt;
 }
 
-RealType one_step(const double t, const double dt,
-                         std::vector<Individual<PFalc>>& population,
-                         const Parameters& params, double eir) {
-  // Get biting parameters to calculate Lambda
-  const auto b_min = params.b_min, b_max = params.b_max, I_B0 = params.I_B0,
-             kappa_B = params.kappa_B, rho = params.rho, age_0 = params.age_0,
-             bdiff = b_max - b_min;
+double OneStep::step(const double t, const double dt,
+                     std::vector<Individual<PFalc>>& population,
+                     const Parameters& params,
+                     const StepOptions& options) const {
+  return coupled(t, dt, options, [&](double eir, Infectiousness& humans) {
+    unblocked_step(t, dt, population, params, eir, humans, options.recorder);
+  });
+}
 
-  // Force of infection from people to mosquito - must be calculated and passed
-  // on.
-  // auto foi_mosquito = 0.0;
+double OneStep::step(const double t, const double dt, Population& population,
+                     const Parameters& params,
+                     const StepOptions& options) const {
+  return coupled(t, dt, options, [&](double eir, Infectiousness& humans) {
+    if (!options.streams) {
+      unblocked_step(t, dt, population, params, eir, humans, options.recorder);
+    } else if (options.recorder) {
+      auto& recorder = *options.recorder;
+      if (!recorder.counted()) {
+        recorder.count(population);
+      }
+      Tallied tallied(recorder);
+      blocked_step(t, dt, population, params, eir, humans, options, tallied);
+      recorder.end_step(t + dt, tallied.merged());
+    } else if (options.log) {
+      Logged logged{*options.log};
+      blocked_step(t, dt, population, params, eir, humans, options, logged);
+      options.log->end_step(t);
+    } else {
+      Unobserved unobserved;
+      blocked_step(t, dt, population, params, eir, humans, options,
+                   unobserved);
+    }
+  });
+}
 
-  // Loop over individuals
-  auto erase_it = std::remove_if(
-      population.begin(), population.end(),
-      [&](Individual<PFalc>& person) -> bool {
-        auto& state = person.status_;
-        auto& age = person.age_;
-        // Construct Lambda(t) for each individual.
-        auto b = b_min + bdiff / (1.0 + pow(state.getIB() / I_B0, kappa_B));
-        auto psi = 1.0 - rho * std::exp(-age / age_0);
-        auto zeta = state.getZeta();
-        // It is plausible to add this to the individual for use when it
-        // comes to calculating the normalization constant etc in the
-        // mosquito model.
-        auto lambda = eir * psi * b * zeta;
-
-        switch (state.current_) {
-          case Status::S:
-            return S_update(state, params, lambda, t, dt);
-            break;
-          case Status::A:
-            return A_update(state, params, lambda, t, dt);
-            break;
-          case Status::U:
-            return U_update(state, params, lambda, t, dt);
-            break;
-          case Status::D:
-            return D_update(state, params, lambda, t, dt);
-            break;
-          case Status::T:
-            return T_update(state, params, lambda, t, dt);
-            break;
-          case Status::P:
-            return P_update(state, params, lambda, t, dt);
-            break;
-          default:
-            throw std::logic_error("You messed up");
-        }
-      });
-  population.erase(erase_it, population.end());
+double OneStep::step(const double t, const double dt,
+                     HybridPopulation& population, const Parameters& params,
+                     const StepOptions& options) const {
+  return coupled(t, dt, options, [&](double eir, Infectiousness& humans) {
+    auto& streams = *options.streams;
+    auto& agents = population.agents;
+    auto rng = streams.stream(streams.next_epoch(), 0);
+    population.cohorts.step(t, dt, params, eir, agents, rng, humans);
+    if (!options.recorder) {
+      Unobserved unobserved;
+      blocked_step(t, dt, agents, params, eir, humans, options, unobserved);
+      population.cohorts.absorb(agents);
+      return;
+    }
+    // The bins only keep the mean age of everyone in them, so rather than
+    // being kept up to date by the events of the step, the recorder is
+    // counted again at the end of it.
+    auto& recorder = *options.recorder;
+    Tallied tallied(recorder);
+    blocked_step(t, dt, agents, params, eir, humans, options, tallied);
+    population.cohorts.absorb(agents);
+    auto tally = tallied.merged();
+    for (const auto& dead : population.cohorts.died()) {
+      tally.deaths_[recorder.band(dead.age)] += dead.count;
+    }
+    std::fill(tally.change_.begin(), tally.change_.end(), 0);
+    recorder.count(population);
+    recorder.end_step(t + dt, tally);
+  });
+}
+
+template <class Enabled>
+double FeatureStep<Enabled>::operator()(const double t, const double dt,
+                                        Population& population,
+                                        const Parameters& params, double eir,
+                                        ThreadPool& pool,
+                                        RandomStreams& streams) const {
+  Infectiousness humans;
+  Unobserved unobserved;
+  Bites biting{nullptr, nullptr, 0};
+  specialised_step<Enabled>(t, dt, population, params, eir, humans,
+                            Blocks{&pool}, streams, Shard{nullptr}, unobserved,
+                            biting);
+  return t + dt;
+}
 
-  std::cout << "Pop size: " << population.size() << std::endl;
+template <class Enabled>
+double FeatureStep<Enabled>::operator()(const double t, const double dt,
+                                        Population& population,
+                                        const Parameters& params, double eir,
+                                        RandomStreams& streams) const {
+  Infectiousness humans;
+  Unobserved unobserved;
+  Bites biting{nullptr, nullptr, 0};
+  specialised_step<Enabled>(t, dt, population, params, eir, humans,
+                            Blocks{nullptr}, streams, Shard{nullptr},
+                            unobserved, biting);
   return t + dt;
 }
 
+template struct FeatureStep<Features<false, false, false>>;
+template struct FeatureStep<Features<false, false, true>>;
+template struct FeatureStep<Features<false, true, false>>;
+template struct FeatureStep<Features<false, true, true>>;
+template struct FeatureStep<Features<true, false, false>>;
+template struct FeatureStep<Features<true, false, true>>;
+template struct FeatureStep<Features<true, true, false>>;
+template struct FeatureStep<Features<true, true, true>>;
+
 // Construct the object that will store the information in the Griffin
 // simulation.
 PFalc::PFalc(const Status& status, double ICA, double ICM, double IA)
     : current_(status),
+      overflow_(InfectionPool::none),
       I_CA_(ICA),
       I_CM_(ICM),
       I_A_(IA),
       zeta_(1.0),
-      I_B_(0.0) {
-  auto infty = std::numeric_limits<double>::infinity();
-  infection_queue_ =
-      std::priority_queue<double, std::vector<double>, std::greater<double>>();
-  infection_queue_.push(infty);
-};
+      I_B_(0.0),
+      next_infection_(std::numeric_limits<double>::infinity()){};
+
+PFalc::PFalc(const PFalc& other)
+    : current_(other.current_),
+      overflow_(InfectionPool::none),
+      I_CA_(other.I_CA_),
+      I_CM_(other.I_CM_),
+      I_A_(other.I_A_),
+      zeta_(other.zeta_),
+      I_B_(other.I_B_),
+      next_infection_(other.next_infection_) {
+  if (other.overflow_ != InfectionPool::none) {
+    overflow_ = InfectionPool::shared().copy(other.overflow_);
+  }
+}
+
+PFalc::PFalc(PFalc&& other) noexcept
+    : current_(other.current_),
+      overflow_(other.overflow_),
+      I_CA_(other.I_CA_),
+      I_CM_(other.I_CM_),
+      I_A_(other.I_A_),
+      zeta_(other.zeta_),
+      I_B_(other.I_B_),
+      next_infection_(other.next_infection_) {
+  other.overflow_ = InfectionPool::none;
+}
+
+PFalc& PFalc::operator=(const PFalc& other) {
+  if (this != &other) {
+    *this = PFalc(other);
+  }
+  return *this;
+}
+
+PFalc& PFalc::operator=(PFalc&& other) noexcept {
+  if (this == &other) {
+    return *this;
+  }
+  if (overflow_ != InfectionPool::none) {
+    InfectionPool::shared().release(overflow_);
+  }
+  current_ = other.current_;
+  overflow_ = other.overflow_;
+  I_CA_ = other.I_CA_;
+  I_CM_ = other.I_CM_;
+  I_A_ = other.I_A_;
+  zeta_ = other.zeta_;
+  I_B_ = other.I_B_;
+  next_infection_ = other.next_infection_;
+  other.overflow_ = InfectionPool::none;
+  return *this;
+}
+
+PFalc::~PFalc() {
+  if (overflow_ != InfectionPool::none) {
+    InfectionPool::shared().release(overflow_);
+  }
+}
 
 double PFalc::getIC() noexcept { return I_CA_ + I_CM_; }
 
 double PFalc::getIA() noexcept { return I_A_; }
 
 void PFalc::clearInfectionQueue() noexcept {
-  // Replace with a queue consisting only of an infection at infinity.
-  while (infection_queue_.size() != 1) {
-    infection_queue_.pop();
+  next_infection_ = std::numeric_limits<double>::infinity();
+  if (overflow_ != InfectionPool::none) {
+    InfectionPool::shared().release(overflow_);
   }
 }
 
-void PFalc::scheduleInfection(const double t) { infection_queue_.push(t); };
+void PFalc::scheduleInfection(const double t) {
+  // The earliest infection is always the one cached in the individual.
+  if (t < next_infection_) {
+    if (next_infection_ != std::numeric_limits<double>::infinity()) {
+      InfectionPool::shared().insert(overflow_, next_infection_);
+    }
+    next_infection_ = t;
+    return;
+  }
+  InfectionPool::shared().insert(overflow_, t);
+}
 
 bool PFalc::updateInfection(const double t) {
-  // Technically, by using a priority queue there is an indirection to the
-  // stack as all data is held in a vector. We could consider caching the top
-  // value in the individual structure and only go away once that value is
-  // outdated. If the infectionQueue is empty, the next infection could be at
-  // time infinity. We would have to make sure that we update things
-  // appropriately for that however. This may not be the best, at a new
-  // infection we would have to check against cache value. If cahced value is
-  // larger, we need to move it bak into the queue. But this might just be fine.
-  // It is an interesting thing to look for.
-
-  auto activate_infection = t >= infection_queue_.top();
+  // The next infection is cached, so the common case never leaves the
+  // individual. The pool is only visited when more infections are pending.
+  auto activate_infection = t >= next_infection_;
   if (!activate_infection) {
     return false;
   }
 
-  while (t >= infection_queue_.top()) {
-    infection_queue_.pop();
+  next_infection_ = std::numeric_limits<double>::infinity();
+  if (overflow_ != InfectionPool::none) {
+    next_infection_ = InfectionPool::shared().pop_until(overflow_, t);
   }
   return true;
 }
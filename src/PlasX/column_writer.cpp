@@ -0,0 +1,108 @@
+#include "PlasX/column_writer.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace plasx {
+static constexpr char magic[8] = {'P', 'L', 'A', 'S', 'X', 'C', 'O', 'L'};
+static constexpr std::uint32_t version = 1;
+
+template <class T>
+static void put(std::ofstream& file, const T& value) {
+  file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <class T>
+static T get(std::ifstream& file) {
+  T value;
+  file.read(reinterpret_cast<char*>(&value), sizeof(T));
+  return value;
+}
+
+ColumnWriter::ColumnWriter(const std::string& path,
+                           std::vector<std::string> names,
+                           std::size_t chunk_rows)
+    : file_(path, std::ios::binary),
+      names_(std::move(names)),
+      chunk_rows_(std::max<std::size_t>(chunk_rows, 1)),
+      buffer_(names_.size() * chunk_rows_) {
+  if (!file_) {
+    throw std::runtime_error("Could not open " + path + " for writing");
+  }
+  file_.write(magic, sizeof(magic));
+  put(file_, version);
+  put(file_, static_cast<std::uint32_t>(names_.size()));
+  for (const auto& name : names_) {
+    put(file_, static_cast<std::uint32_t>(name.size()));
+    file_.write(name.data(), name.size());
+  }
+}
+
+ColumnWriter::~ColumnWriter() { flush(); }
+
+void ColumnWriter::write_row(const double* values) {
+  for (std::size_t c = 0; c < names_.size(); ++c) {
+    buffer_[c * chunk_rows_ + rows_] = values[c];
+  }
+  if (++rows_ == chunk_rows_) {
+    flush();
+  }
+}
+
+void ColumnWriter::flush() {
+  if (rows_ == 0) {
+    return;
+  }
+  put(file_, static_cast<std::uint64_t>(rows_));
+  for (std::size_t c = 0; c < names_.size(); ++c) {
+    file_.write(reinterpret_cast<const char*>(&buffer_[c * chunk_rows_]),
+                rows_ * sizeof(double));
+  }
+  file_.flush();
+  rows_ = 0;
+}
+
+const std::vector<double>& ColumnTable::operator[](
+    const std::string& name) const {
+  const auto it = std::find(names.begin(), names.end(), name);
+  if (it == names.end()) {
+    throw std::out_of_range("No column named " + name);
+  }
+  return columns[it - names.begin()];
+}
+
+ColumnTable read_columns(const std::string& path) {
+  std::ifstream file(path, std::ios::binary);
+  char header[sizeof(magic)];
+  file.read(header, sizeof(header));
+  if (!file || std::memcmp(header, magic, sizeof(magic)) != 0 ||
+      get<std::uint32_t>(file) != version) {
+    throw std::runtime_error(path + " is not a PlasX column file");
+  }
+
+  ColumnTable table;
+  table.names.resize(get<std::uint32_t>(file));
+  for (auto& name : table.names) {
+    name.resize(get<std::uint32_t>(file));
+    file.read(name.data(), name.size());
+  }
+  table.columns.resize(table.names.size());
+  while (true) {
+    const auto rows = get<std::uint64_t>(file);
+    if (!file) {
+      break;
+    }
+    for (auto& column : table.columns) {
+      const auto start = column.size();
+      column.resize(start + rows);
+      file.read(reinterpret_cast<char*>(column.data() + start),
+                rows * sizeof(double));
+    }
+    if (!file) {
+      throw std::runtime_error(path + " ends part way through a chunk");
+    }
+  }
+  return table;
+}
+}  // namespace plasx
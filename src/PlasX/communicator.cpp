@@ -0,0 +1,151 @@
+#include "PlasX/communicator.hpp"
+
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <new>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace plasx {
+// Lives at the start of the shared mapping, followed by one slot of
+// slot_size doubles per process. The atomics are lock free, so they work
+// across processes.
+struct SharedMemoryCommunicator::Region {
+  Region(const std::size_t size, const std::size_t slot_size)
+      : size(size), slot_size(slot_size){};
+
+  double* slot(const std::size_t rank) noexcept {
+    return reinterpret_cast<double*>(this + 1) + rank * slot_size;
+  };
+
+  static std::size_t bytes(const std::size_t size,
+                           const std::size_t slot_size) noexcept {
+    return sizeof(Region) + size * slot_size * sizeof(double);
+  };
+
+  const std::size_t size;
+  const std::size_t slot_size;
+  std::atomic<std::uint64_t> arrived{0};
+  std::atomic<std::uint64_t> generation{0};
+  std::atomic<bool> failed{false};
+};
+
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free);
+static_assert(sizeof(SharedMemoryCommunicator::Region) % alignof(double) == 0);
+
+SharedMemoryCommunicator::SharedMemoryCommunicator(Region& region,
+                                                   const std::size_t rank)
+    : region_(region), rank_(rank) {}
+
+std::size_t SharedMemoryCommunicator::size() const noexcept {
+  return region_.size;
+}
+
+void SharedMemoryCommunicator::barrier() {
+  const auto generation = region_.generation.load(std::memory_order_acquire);
+  if (region_.arrived.fetch_add(1, std::memory_order_acq_rel) + 1 ==
+      region_.size) {
+    region_.arrived.store(0, std::memory_order_relaxed);
+    region_.generation.fetch_add(1, std::memory_order_release);
+    return;
+  }
+  while (region_.generation.load(std::memory_order_acquire) == generation) {
+    if (region_.failed.load(std::memory_order_relaxed)) {
+      throw std::runtime_error("Another process of the run failed.");
+    }
+    std::this_thread::yield();
+  }
+}
+
+void SharedMemoryCommunicator::all_reduce_sum(double* data,
+                                              const std::size_t n) {
+  const auto slot_size = region_.slot_size;
+  for (std::size_t begin = 0; begin < n; begin += slot_size) {
+    const auto m = std::min(slot_size, n - begin);
+    std::memcpy(region_.slot(rank_), data + begin, m * sizeof(double));
+    barrier();
+    std::fill(data + begin, data + begin + m, 0.0);
+    for (std::size_t r = 0; r < region_.size; ++r) {
+      const auto* slot = region_.slot(r);
+      for (std::size_t i = 0; i < m; ++i) {
+        data[begin + i] += slot[i];
+      }
+    }
+    // Nobody may overwrite their slot until everyone has read it.
+    barrier();
+  }
+}
+
+void SharedMemoryCommunicator::abort() noexcept {
+  region_.failed.store(true, std::memory_order_relaxed);
+}
+
+void run_local(const std::size_t n_processes,
+               const std::function<void(Communicator&)>& task,
+               const std::size_t slot_size) {
+  using Region = SharedMemoryCommunicator::Region;
+  const auto bytes = Region::bytes(n_processes, slot_size);
+  auto* memory = mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  if (memory == MAP_FAILED) {
+    throw std::runtime_error("Could not map memory for the communicator.");
+  }
+  auto* region = new (memory) Region(n_processes, slot_size);
+
+  std::vector<pid_t> children;
+  for (std::size_t rank = 1; rank < n_processes; ++rank) {
+    const auto pid = fork();
+    if (pid == 0) {
+      // The child never returns into the caller.
+      SharedMemoryCommunicator communicator(*region, rank);
+      auto status = EXIT_SUCCESS;
+      try {
+        task(communicator);
+      } catch (...) {
+        communicator.abort();
+        status = EXIT_FAILURE;
+      }
+      _exit(status);
+    }
+    if (pid < 0) {
+      region->failed = true;
+      break;
+    }
+    children.push_back(pid);
+  }
+
+  SharedMemoryCommunicator communicator(*region, 0);
+  auto failed = children.size() + 1 != n_processes;
+  std::exception_ptr error;
+  if (!failed) {
+    try {
+      task(communicator);
+    } catch (...) {
+      communicator.abort();
+      error = std::current_exception();
+    }
+  }
+  for (const auto pid : children) {
+    int status = 0;
+    waitpid(pid, &status, 0);
+    failed |= !WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS;
+  }
+  region->~Region();
+  munmap(memory, bytes);
+  if (error) {
+    std::rethrow_exception(error);
+  }
+  if (failed) {
+    throw std::runtime_error("A process of the local run failed.");
+  }
+}
+}  // namespace plasx
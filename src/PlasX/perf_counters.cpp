@@ -0,0 +1,68 @@
+#include "PlasX/perf_counters.hpp"
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cstring>
+#endif
+
+namespace plasx {
+#if defined(__linux__)
+static int open_counter(const std::uint64_t config, const int group) {
+  perf_event_attr attr;
+  std::memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.config = config;
+  attr.read_format = PERF_FORMAT_GROUP;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  // This thread, on any CPU.
+  return static_cast<int>(
+      syscall(__NR_perf_event_open, &attr, 0, -1, group, 0));
+}
+
+PerfCounters::PerfCounters() noexcept {
+  fds_.fill(-1);
+  const std::array<std::uint64_t, 4> events = {
+      PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+      PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+  for (std::size_t e = 0; e < events.size(); ++e) {
+    fds_[e] = open_counter(events[e], e == 0 ? -1 : fds_[0]);
+    if (fds_[e] == -1) {
+      close();
+      return;
+    }
+  }
+}
+
+PerfCounters::~PerfCounters() { close(); }
+
+void PerfCounters::close() noexcept {
+  for (auto& fd : fds_) {
+    if (fd != -1) {
+      ::close(fd);
+      fd = -1;
+    }
+  }
+}
+
+PerfCounters::Reading PerfCounters::read() const noexcept {
+  // The number of counters, then their values in the order they were opened.
+  std::array<std::uint64_t, 5> values{};
+  if (!available() ||
+      ::read(fds_[0], values.data(), sizeof(values)) !=
+          static_cast<ssize_t>(sizeof(values))) {
+    return {};
+  }
+  return {values[1], values[2], values[3], values[4]};
+}
+#else
+PerfCounters::PerfCounters() noexcept { fds_.fill(-1); }
+PerfCounters::~PerfCounters() {}
+void PerfCounters::close() noexcept {}
+PerfCounters::Reading PerfCounters::read() const noexcept { return {}; }
+#endif
+}  // namespace plasx
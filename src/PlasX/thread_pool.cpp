@@ -0,0 +1,79 @@
+#include "PlasX/thread_pool.hpp"
+
+namespace plasx {
+ThreadPool::ThreadPool(std::size_t n_threads) {
+  for (std::size_t i = 1; i < n_threads; ++i) {
+    workers_.emplace_back([this] { work(); });
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  start_.notify_all();
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+}
+
+void ThreadPool::parallel_for(std::size_t n_tasks,
+                              const std::function<void(std::size_t)>& task) {
+  if (n_tasks == 0) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    task_ = &task;
+    n_tasks_ = n_tasks;
+    next_ = 0;
+    error_ = nullptr;
+    active_ = workers_.size();
+    ++generation_;
+  }
+  start_.notify_all();
+  run_tasks();
+
+  // Wait for the workers to drain the loop before task goes out of scope.
+  std::unique_lock<std::mutex> lock(mutex_);
+  finished_.wait(lock, [this] { return active_ == 0; });
+  task_ = nullptr;
+  if (error_) {
+    std::rethrow_exception(error_);
+  }
+}
+
+void ThreadPool::work() {
+  std::size_t seen = 0;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      start_.wait(lock, [&] { return stop_ || generation_ != seen; });
+      if (stop_) {
+        return;
+      }
+      seen = generation_;
+    }
+    run_tasks();
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      --active_;
+    }
+    finished_.notify_one();
+  }
+}
+
+void ThreadPool::run_tasks() {
+  for (auto i = next_++; i < n_tasks_; i = next_++) {
+    try {
+      (*task_)(i);
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!error_) {
+        error_ = std::current_exception();
+      }
+    }
+  }
+}
+}  // namespace plasx
@@ -0,0 +1,229 @@
+#include "PlasX/vector_math.hpp"
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+namespace plasx {
+// The kernels are written once against a generic type V, which is either a
+// plain double or a GCC vector of doubles. Everything below compiles to
+// straight line vector code, there are no branches on the data.
+// The float kernels are the same, on twice as many lanes.
+#if defined(__AVX512F__)
+typedef double VDouble __attribute__((vector_size(64)));
+typedef std::int64_t VInt __attribute__((vector_size(64)));
+typedef float VFloat __attribute__((vector_size(64)));
+typedef std::int32_t VIntF __attribute__((vector_size(64)));
+#elif defined(__AVX2__)
+typedef double VDouble __attribute__((vector_size(32)));
+typedef std::int64_t VInt __attribute__((vector_size(32)));
+typedef float VFloat __attribute__((vector_size(32)));
+typedef std::int32_t VIntF __attribute__((vector_size(32)));
+#else
+using VDouble = double;
+using VInt = std::int64_t;
+using VFloat = float;
+using VIntF = std::int32_t;
+#endif
+const std::size_t vector_lanes = sizeof(VDouble) / sizeof(double);
+const std::size_t float_vector_lanes = sizeof(VFloat) / sizeof(float);
+
+static inline std::int64_t as_int(double x) noexcept {
+  return std::bit_cast<std::int64_t>(x);
+}
+static inline double as_double(std::int64_t x) noexcept {
+  return std::bit_cast<double>(x);
+}
+static inline std::int32_t as_int(float x) noexcept {
+  return std::bit_cast<std::int32_t>(x);
+}
+static inline float as_float(std::int32_t x) noexcept {
+  return std::bit_cast<float>(x);
+}
+#if defined(__AVX512F__) || defined(__AVX2__)
+static inline VInt as_int(VDouble x) noexcept { return (VInt)x; }
+static inline VDouble as_double(VInt x) noexcept { return (VDouble)x; }
+static inline VIntF as_int(VFloat x) noexcept { return (VIntF)x; }
+static inline VFloat as_float(VIntF x) noexcept { return (VFloat)x; }
+#endif
+
+template <class V>
+static inline V exp_kernel(V x) noexcept {
+  // exp(x) = 2^n exp(r) with n = round(x / ln 2) and |r| <= ln(2) / 2.
+  constexpr double log2e = 1.4426950408889634;
+  constexpr double ln2_hi = 6.93145751953125e-1;
+  constexpr double ln2_lo = 1.42860682030941723212e-6;
+  // Adding this rounds to the nearest integer and leaves it in the low bits.
+  constexpr double shift = 0x1.8p52;
+
+  x = x < -708.0 ? -708.0 : x;
+  x = x > 709.0 ? 709.0 : x;
+  const V t = x * log2e + shift;
+  const V n = t - shift;
+  const V r = (x - n * ln2_hi) - n * ln2_lo;
+
+  // Taylor series to order 12, the truncation error is below 2e-16.
+  V p = V{} + 1.0 / 479001600.0;
+  p = p * r + 1.0 / 39916800.0;
+  p = p * r + 1.0 / 3628800.0;
+  p = p * r + 1.0 / 362880.0;
+  p = p * r + 1.0 / 40320.0;
+  p = p * r + 1.0 / 5040.0;
+  p = p * r + 1.0 / 720.0;
+  p = p * r + 1.0 / 120.0;
+  p = p * r + 1.0 / 24.0;
+  p = p * r + 1.0 / 6.0;
+  p = p * r + 0.5;
+  p = p * r + 1.0;
+  p = p * r + 1.0;
+
+  // Build 2^n directly from the exponent bits.
+  const auto n_int = as_int(t) - as_int(shift);
+  return p * as_double((n_int + 1023) << 52);
+}
+
+template <class V>
+static inline V log_kernel(V x) noexcept {
+  // Split x = m 2^e with m in [sqrt(1/2), sqrt(2)), then
+  // log(m) = 2 atanh(s) with s = (m - 1) / (m + 1), |s| < 0.172.
+  constexpr double ln2 = 0.6931471805599453;
+  constexpr double sqrt2 = 1.4142135623730951;
+  const auto bits = as_int(x);
+  const auto exponent = ((bits >> 52) & 0x7ff) - 1023;
+  V m = as_double((bits & 0x000fffffffffffff) | 0x3ff0000000000000);
+  V e;
+  if constexpr (std::is_same_v<V, double>) {
+    e = static_cast<double>(exponent);
+  } else {
+    e = __builtin_convertvector(exponent, V);
+  }
+  const auto large = m > sqrt2;
+  m = large ? m * 0.5 : m;
+  e = large ? e + 1.0 : e;
+
+  const V s = (m - 1.0) / (m + 1.0);
+  const V z = s * s;
+  V p = V{} + 1.0 / 21.0;
+  p = p * z + 1.0 / 19.0;
+  p = p * z + 1.0 / 17.0;
+  p = p * z + 1.0 / 15.0;
+  p = p * z + 1.0 / 13.0;
+  p = p * z + 1.0 / 11.0;
+  p = p * z + 1.0 / 9.0;
+  p = p * z + 1.0 / 7.0;
+  p = p * z + 1.0 / 5.0;
+  p = p * z + 1.0 / 3.0;
+  p = p * z + 1.0;
+  return 2.0 * s * p + e * ln2;
+}
+
+template <class V>
+static inline V pow_kernel(V x, const double k) noexcept {
+  const V result = exp_kernel(k * log_kernel(x));
+  constexpr auto infinity = std::numeric_limits<double>::infinity();
+  const double at_zero = k > 0.0 ? 0.0 : infinity;
+  return x < std::numeric_limits<double>::min() ? at_zero : result;
+}
+
+template <class V>
+static inline V expf_kernel(V x) noexcept {
+  // As exp_kernel, in single precision.
+  constexpr float log2e = 1.44269504f;
+  constexpr float ln2_hi = 6.93359375e-1f;
+  constexpr float ln2_lo = -2.12194440e-4f;
+  constexpr float shift = 0x1.8p23f;
+
+  x = x < -87.0f ? -87.0f : x;
+  x = x > 88.0f ? 88.0f : x;
+  const V t = x * log2e + shift;
+  const V n = t - shift;
+  const V r = (x - n * ln2_hi) - n * ln2_lo;
+
+  // Taylor series to order 7, the truncation error is below 2e-8.
+  V p = V{} + 1.0f / 5040.0f;
+  p = p * r + 1.0f / 720.0f;
+  p = p * r + 1.0f / 120.0f;
+  p = p * r + 1.0f / 24.0f;
+  p = p * r + 1.0f / 6.0f;
+  p = p * r + 0.5f;
+  p = p * r + 1.0f;
+  p = p * r + 1.0f;
+
+  const auto n_int = as_int(t) - as_int(shift);
+  return p * as_float((n_int + 127) << 23);
+}
+
+template <class V>
+static inline V logf_kernel(V x) noexcept {
+  // As log_kernel, in single precision.
+  constexpr float ln2 = 0.693147181f;
+  constexpr float sqrt2 = 1.41421356f;
+  const auto bits = as_int(x);
+  const auto exponent = ((bits >> 23) & 0xff) - 127;
+  V m = as_float((bits & 0x007fffff) | 0x3f800000);
+  V e;
+  if constexpr (std::is_same_v<V, float>) {
+    e = static_cast<float>(exponent);
+  } else {
+    e = __builtin_convertvector(exponent, V);
+  }
+  const auto large = m > sqrt2;
+  m = large ? m * 0.5f : m;
+  e = large ? e + 1.0f : e;
+
+  const V s = (m - 1.0f) / (m + 1.0f);
+  const V z = s * s;
+  V p = V{} + 1.0f / 9.0f;
+  p = p * z + 1.0f / 7.0f;
+  p = p * z + 1.0f / 5.0f;
+  p = p * z + 1.0f / 3.0f;
+  p = p * z + 1.0f;
+  return 2.0f * s * p + e * ln2;
+}
+
+template <class V>
+static inline V powf_kernel(V x, const float k) noexcept {
+  const V result = expf_kernel(k * logf_kernel(x));
+  constexpr auto infinity = std::numeric_limits<float>::infinity();
+  const float at_zero = k > 0.0f ? 0.0f : infinity;
+  return x < std::numeric_limits<float>::min() ? at_zero : result;
+}
+
+// Apply kernel over whole vectors of type V, then finish the remainder one at
+// a time.
+template <class V, class T, class Kernel>
+static inline void apply(const T* x, T* y, std::size_t n,
+                         Kernel kernel) noexcept {
+  std::size_t i = 0;
+  if constexpr (!std::is_same_v<V, T>) {
+    constexpr auto lanes = sizeof(V) / sizeof(T);
+    for (; i + lanes <= n; i += lanes) {
+      V v;
+      std::memcpy(&v, x + i, sizeof(v));
+      v = kernel(v);
+      std::memcpy(y + i, &v, sizeof(v));
+    }
+  }
+  for (; i < n; ++i) {
+    y[i] = kernel(x[i]);
+  }
+}
+
+void batch_exp(const double* x, double* y, std::size_t n) noexcept {
+  apply<VDouble>(x, y, n, [](auto v) { return exp_kernel(v); });
+}
+
+void batch_pow(const double* x, double k, double* y, std::size_t n) noexcept {
+  apply<VDouble>(x, y, n, [k](auto v) { return pow_kernel(v, k); });
+}
+
+void batch_exp(const float* x, float* y, std::size_t n) noexcept {
+  apply<VFloat>(x, y, n, [](auto v) { return expf_kernel(v); });
+}
+
+void batch_pow(const float* x, float k, float* y, std::size_t n) noexcept {
+  apply<VFloat>(x, y, n, [k](auto v) { return powf_kernel(v, k); });
+}
+}  // namespace plasx
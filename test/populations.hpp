@@ -0,0 +1,42 @@
+#ifndef PLASX_TEST_POPULATIONS_HPP
+#define PLASX_TEST_POPULATIONS_HPP
+// Populations shared by the tests.
+#include <cstddef>
+
+#include "PlasX/Falciparum/Griffin/population.hpp"
+#include "PlasX/udl.hpp"
+
+namespace plasx {
+namespace test {
+
+// Individuals of every Status in turn, aged 0 to 59 years in turn, all with
+// the same immunity.
+inline falciparum::griffin::Population mixed_population(
+    const std::size_t n, const double ICA = 1.0, const double ICM = 0.5,
+    const double IA = 2.0) {
+  falciparum::griffin::Population population;
+  population.reserve(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    population.emplace_back((i % 60) * 1.0_yrs,
+                            static_cast<falciparum::griffin::Status>(i % 6),
+                            ICA, ICM, IA);
+  }
+  return population;
+}
+
+// Susceptibles without immunity, individual i aged age(i).
+template <class Age>
+falciparum::griffin::Population susceptible_population(const std::size_t n,
+                                                       Age age) {
+  falciparum::griffin::Population population;
+  population.reserve(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    population.emplace_back(age(i), falciparum::griffin::Status::S, 0.0, 0.0,
+                            0.0);
+  }
+  return population;
+}
+
+}  // namespace test
+}  // namespace plasx
+#endif
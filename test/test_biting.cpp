@@ -0,0 +1,95 @@
+#include <cmath>
+#include <numeric>
+
+#include "PlasX/Falciparum/Griffin/biting.hpp"
+#include "PlasX/Falciparum/Griffin/population.hpp"
+#include "PlasX/Falciparum/griffin.hpp"
+#include "PlasX/random.hpp"
+#include "PlasX/simulation.hpp"
+#include "PlasX/thread_pool.hpp"
+#include "PlasX/udl.hpp"
+#include "gtest/gtest.h"
+
+using namespace plasx;
+namespace pfg = falciparum::griffin;
+
+TEST(Biting, BitesFollowZeta) {
+  // Adults with no immunity, half of them bitten three times as often.
+  pfg::Parameters params;
+  params.mu_d = 0.0;
+  const std::size_t n = 200000;
+  const auto eir = 0.02;
+  pfg::Population population;
+  for (std::size_t i = 0; i < n; ++i) {
+    population.emplace_back(20.0_yrs, pfg::Status::S, 0.0, 0.0, 0.0);
+    population.zeta_[i] = i % 2 ? 1.5 : 0.5;
+  }
+  pfg::BitingTable table;
+  RandomStreams streams(5);
+  pfg::one_step(0.0, 1.0_days, population, params, eir, streams, table);
+
+  // Every infection leaves S.
+  const pfg::ImmunityFunctions functions(params);
+  for (const auto zeta : {0.5, 1.5}) {
+    const auto p = 1.0 - std::exp(-eir * functions.psi(20.0_yrs) *
+                                  params.b_max * zeta);
+    std::size_t infected = 0;
+    for (std::size_t i = zeta < 1.0 ? 0 : 1; i < n; i += 2) {
+      infected += population.current_[i] != pfg::Status::S;
+    }
+    const auto expected = p * n / 2;
+    EXPECT_NEAR(infected, expected, 5.0 * std::sqrt(expected));
+  }
+  EXPECT_DOUBLE_EQ(table.total(), 1.0 * n);
+}
+
+TEST(Biting, NewbornsDrawTheirZeta) {
+  pfg::Parameters params;
+  params.mu_d = 1.0 / 1.0_yrs;
+  params.sigma = 1.0;
+  pfg::Population population;
+  for (std::size_t i = 0; i < 20000; ++i) {
+    population.emplace_back((i % 60) * 1.0_yrs, pfg::Status::S, 0.0, 0.0, 0.0);
+  }
+  pfg::BitingTable table;
+  RandomStreams streams(6);
+  plasx::simulation(0.0, 200.0_days, 1.0_days, pfg::one_step, population,
+                    params, 0.01, streams, table);
+
+  std::size_t newborns = 0;
+  auto sum = 0.0;
+  for (const auto zeta : population.zeta_) {
+    if (zeta != 1.0) {
+      ++newborns;
+      sum += zeta;
+    }
+  }
+  ASSERT_GT(newborns, 5000u);
+  // The mean of zeta is 1, and its standard deviation is sqrt(e - 1).
+  EXPECT_NEAR(sum / newborns, 1.0, 5.0 * std::sqrt((std::exp(1.0) - 1.0) /
+                                                   newborns));
+  const auto total = std::accumulate(population.zeta_.begin(),
+                                     population.zeta_.end(), 0.0);
+  EXPECT_NEAR(table.total(), total, 1e-9 * total);
+}
+
+TEST(Biting, DoesNotDependOnThreads) {
+  pfg::Parameters params;
+  params.mu_d = 1.0 / 2.0_yrs;
+  pfg::Population threaded;
+  for (std::size_t i = 0; i < 10000; ++i) {
+    threaded.emplace_back((i % 60) * 1.0_yrs, static_cast<pfg::Status>(i % 6),
+                          1.0, 0.5, 2.0);
+  }
+  auto serial = threaded;
+  pfg::BitingTable threaded_table, serial_table;
+  RandomStreams threaded_streams(7), serial_streams(7);
+  ThreadPool pool(3);
+  plasx::simulation(0.0, 30.0_days, 1.0_days, pfg::one_step, threaded, params,
+                    0.1, pool, threaded_streams, threaded_table);
+  plasx::simulation(0.0, 30.0_days, 1.0_days, pfg::one_step, serial, params,
+                    0.1, serial_streams, serial_table);
+  EXPECT_EQ(threaded.current_, serial.current_);
+  EXPECT_EQ(threaded.zeta_, serial.zeta_);
+  EXPECT_EQ(threaded.I_B_, serial.I_B_);
+}
@@ -0,0 +1,140 @@
+#include <array>
+#include <cmath>
+
+#include "PlasX/Falciparum/Griffin/cohorts.hpp"
+#include "PlasX/Falciparum/Griffin/mosquito.hpp"
+#include "PlasX/Falciparum/Griffin/population.hpp"
+#include "PlasX/Falciparum/griffin.hpp"
+#include "PlasX/random.hpp"
+#include "PlasX/simulation.hpp"
+#include "PlasX/udl.hpp"
+#include "gtest/gtest.h"
+
+using namespace plasx;
+namespace pfg = falciparum::griffin;
+
+static void fill(pfg::Population& population, const std::size_t n) {
+  for (std::size_t i = 0; i < n; ++i) {
+    population.emplace_back((i % 30) * 1.0_yrs + 0.5_yrs, pfg::Status::S, 0.0,
+                            0.0, 0.0);
+  }
+}
+
+// Number of people in each status, the binned all being in S.
+static std::array<double, pfg::n_status> statuses(
+    const pfg::HybridPopulation& population) {
+  std::array<double, pfg::n_status> counts{};
+  for (const auto status : population.agents.current_) {
+    ++counts[static_cast<std::size_t>(status)];
+  }
+  counts[0] += population.cohorts.count();
+  return counts;
+}
+
+TEST(Cohorts, AbsorbsSettledSusceptibles) {
+  pfg::HybridPopulation population;
+  fill(population.agents, 4);
+  population.agents.current_[1] = pfg::Status::A;
+  population.agents[2].scheduleInfection(3.0);
+  population.cohorts.absorb(population.agents);
+
+  ASSERT_EQ(population.agents.size(), 2u);
+  EXPECT_EQ(population.agents.current_[0], pfg::Status::A);
+  EXPECT_EQ(population.agents.next_infection_[1], 3.0);
+  EXPECT_EQ(population.cohorts.count(), 2u);
+  EXPECT_EQ(population.size(), 4u);
+}
+
+TEST(Cohorts, KeepsMeanZeta) {
+  pfg::Parameters params;
+  pfg::HybridPopulation population;
+  for (const auto zeta : {0.5, 1.5, 0.0}) {
+    population.agents.emplace_back(zeta > 0.0 ? 20.5_yrs : 40.5_yrs,
+                                   pfg::Status::S, 0.0, 0.0, 0.0);
+    population.agents.zeta_.back() = zeta;
+  }
+  population.cohorts.absorb(population.agents);
+  ASSERT_EQ(population.cohorts.count(), 3u);
+
+  // Everyone who can be bitten is infected, and takes the mean of their bin.
+  // Those with zeta = 0 are never bitten.
+  Xoshiro256 rng(3);
+  pfg::Infectiousness humans;
+  population.cohorts.step(0.0, 1.0_days, params, 1e6, population.agents, rng,
+                          humans);
+  ASSERT_EQ(population.agents.size(), 2u);
+  for (std::size_t i = 0; i < 2; ++i) {
+    EXPECT_EQ(population.agents.zeta_[i], 1.0);
+    EXPECT_EQ(population.agents.age_[i], 20.5_yrs);
+  }
+  EXPECT_EQ(population.cohorts.count(), 1u);
+}
+
+TEST(Cohorts, SizeIsStable) {
+  pfg::Parameters params;
+  params.mu_d = 1.0 / 2.0_yrs;
+  pfg::HybridPopulation population;
+  fill(population.agents, 10000);
+  population.cohorts.absorb(population.agents);
+  RandomStreams streams(4);
+  plasx::simulation(0.0_days, 200.0_days, 1.0_days, pfg::one_step, population,
+                    params, 0.05, streams);
+  EXPECT_EQ(population.size(), 10000u);
+  EXPECT_GT(population.agents.size(), 0u);
+  EXPECT_GT(population.cohorts.count(), 0u);
+}
+
+TEST(Cohorts, MatchesAgents) {
+  pfg::Parameters params;
+  params.mu_d = 1.0 / 20.0_yrs;
+  const std::size_t n = 40000;
+  const auto eir = 0.02;
+
+  pfg::Population agents;
+  fill(agents, n);
+  pfg::HybridPopulation hybrid;
+  fill(hybrid.agents, n);
+  hybrid.cohorts.absorb(hybrid.agents);
+
+  RandomStreams agent_streams(5), hybrid_streams(6);
+  plasx::simulation(0.0_days, 120.0_days, 1.0_days, pfg::one_step, agents,
+                    params, eir, agent_streams);
+  plasx::simulation(0.0_days, 120.0_days, 1.0_days, pfg::one_step, hybrid,
+                    params, eir, hybrid_streams);
+
+  std::array<double, pfg::n_status> expected{};
+  for (const auto status : agents.current_) {
+    ++expected[static_cast<std::size_t>(status)];
+  }
+  const auto counts = statuses(hybrid);
+  for (std::size_t s = 0; s < pfg::n_status; ++s) {
+    // Several standard deviations of a binomial count.
+    const auto tolerance = 5.0 * std::sqrt(expected[s] + 1.0) + 0.01 * n;
+    EXPECT_NEAR(counts[s], expected[s], tolerance) << "status " << s;
+  }
+  EXPECT_LT(expected[0], n);
+}
+
+TEST(Cohorts, DriveMosquitoes) {
+  pfg::Parameters params;
+  params.mu_d = 1.0 / 20.0_yrs;
+  const std::size_t n = 40000;
+  const pfg::Mosquitoes initial(pfg::MosquitoParameters(), 10.0, 0.01);
+
+  pfg::Population agents;
+  fill(agents, n);
+  pfg::HybridPopulation hybrid;
+  fill(hybrid.agents, n);
+  hybrid.cohorts.absorb(hybrid.agents);
+
+  // The binned are most of the humans the mosquitoes bite, so they must be
+  // counted in their infectiousness.
+  auto agent_mosquitoes = initial, hybrid_mosquitoes = initial;
+  RandomStreams agent_streams(7), hybrid_streams(8);
+  plasx::simulation(0.0_days, 120.0_days, 1.0_days, pfg::one_step, agents,
+                    params, agent_mosquitoes, agent_streams);
+  plasx::simulation(0.0_days, 120.0_days, 1.0_days, pfg::one_step, hybrid,
+                    params, hybrid_mosquitoes, hybrid_streams);
+  EXPECT_NEAR(hybrid_mosquitoes.eir() / agent_mosquitoes.eir(), 1.0, 0.05);
+  EXPECT_GT(agent_mosquitoes.eir(), 1.1 * initial.eir());
+}
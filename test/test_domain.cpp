@@ -0,0 +1,173 @@
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "PlasX/Falciparum/Griffin/biting.hpp"
+#include "PlasX/Falciparum/Griffin/domain.hpp"
+#include "PlasX/Falciparum/Griffin/mosquito.hpp"
+#include "PlasX/Falciparum/Griffin/population.hpp"
+#include "PlasX/Falciparum/Griffin/recorder.hpp"
+#include "PlasX/Falciparum/Griffin/snapshot.hpp"
+#include "PlasX/Falciparum/griffin.hpp"
+#include "PlasX/communicator.hpp"
+#include "PlasX/random.hpp"
+#include "PlasX/thread_pool.hpp"
+#include "PlasX/udl.hpp"
+#include "gtest/gtest.h"
+
+using namespace plasx;
+namespace pfg = falciparum::griffin;
+
+// Failures in the forked processes can only be reported by throwing.
+static void require(const bool condition, const char* what) {
+  if (!condition) {
+    throw std::runtime_error(what);
+  }
+}
+
+TEST(Communicator, AllReduceSumsInEveryProcess) {
+  EXPECT_NO_THROW(run_local(
+      3,
+      [](Communicator& communicator) {
+        const auto rank = communicator.rank();
+        require(communicator.size() == 3, "size");
+        // Larger than a slot, so it is reduced in pieces.
+        std::vector<double> data(21);
+        for (std::size_t i = 0; i < data.size(); ++i) {
+          data[i] = (rank + 1) * i;
+        }
+        communicator.all_reduce_sum(data.data(), data.size());
+        for (std::size_t i = 0; i < data.size(); ++i) {
+          require(data[i] == 6.0 * i, "sum");
+        }
+        communicator.barrier();
+      },
+      8));
+}
+
+TEST(Communicator, FailureStopsEveryProcess) {
+  EXPECT_THROW(run_local(2,
+                         [](Communicator& communicator) {
+                           if (communicator.rank() == 1) {
+                             throw std::runtime_error("failed");
+                           }
+                           communicator.barrier();
+                         }),
+               std::runtime_error);
+}
+
+TEST(Domain, MatchesWholePopulation) {
+  pfg::Parameters params;
+  params.mu_d = 1.0 / 5.0_yrs;
+  params.P_M = 0.5;
+  // Three full blocks and part of a fourth.
+  const std::size_t n = 3 * pfg::OneStep::block_size + 1000;
+  auto add = [](std::size_t i, pfg::Population& population) {
+    population.emplace_back((i % 40) * 1.0_yrs, pfg::Status::S, 2.0, 0.0, 1.0);
+  };
+  pfg::Population whole;
+  for (std::size_t i = 0; i < n; ++i) {
+    add(i, whole);
+  }
+  const std::string path = "domain_test.plasx";
+  pfg::save_snapshot(path, 0.0, whole, params);
+  const pfg::Snapshot snapshot(path);
+  std::remove(path.c_str());
+  const pfg::Mosquitoes initial(pfg::MosquitoParameters(), 10.0, 0.02);
+  const std::vector<double> edges = {0.0, 5.0_yrs, 15.0_yrs};
+
+  // The whole population on one process.
+  auto population = whole;
+  auto mosquitoes = initial;
+  RandomStreams streams(21);
+  pfg::Recorder recorder(edges);
+  auto t = 0.0;
+  for (auto step = 0; step < 30; ++step) {
+    t = pfg::one_step(t, 1.0_days, population, params, mosquitoes, streams,
+                      recorder);
+  }
+  std::vector<double> expected(pfg::Recorder::column_names(3).size());
+  recorder.fill_row(t, expected.data());
+  const auto eir = mosquitoes.eir();
+  ASSERT_GT(eir, 0.0);
+
+  // Each process builds, or loads, only its own shard. The loaded shards are
+  // stepped across a pool of threads.
+  for (const auto load : {false, true}) {
+    for (std::size_t processes : {1, 3}) {
+      EXPECT_NO_THROW(run_local(processes, [&](Communicator& communicator) {
+        pfg::Domain domain(communicator, n);
+        auto shard = load ? domain.shard(snapshot) : domain.shard(add);
+        require(shard.size() == domain.end() - domain.begin(), "shard");
+        auto mosquitoes = initial;
+        RandomStreams streams(21);
+        pfg::Recorder recorder(edges);
+        ThreadPool pool(2);
+        auto t = 0.0;
+        for (auto step = 0; step < 30; ++step) {
+          t = load ? pfg::one_step(t, 1.0_days, shard, params, mosquitoes,
+                                   streams, domain, recorder, pool)
+                   : pfg::one_step(t, 1.0_days, shard, params, mosquitoes,
+                                   streams, domain, recorder);
+        }
+        std::vector<double> row;
+        domain.gather(recorder, t, row);
+        require(row == expected, "recorder");
+        require(mosquitoes.eir() == eir, "mosquitoes");
+      }));
+    }
+  }
+}
+
+TEST(Domain, MatchesWholePopulationWithABitingTable) {
+  pfg::Parameters params;
+  params.mu_d = 1.0 / 5.0_yrs;
+  params.sigma = 1.0;
+  const std::size_t n = 3 * pfg::OneStep::block_size + 1000;
+  auto add = [](std::size_t i, pfg::Population& population) {
+    population.emplace_back((i % 40) * 1.0_yrs, pfg::Status::S, 2.0, 0.0, 1.0);
+    population.zeta_.back() = 0.5 + (i % 3) * 0.5;
+  };
+  const pfg::Mosquitoes initial(pfg::MosquitoParameters(), 10.0, 0.02);
+  const std::vector<double> edges = {0.0, 5.0_yrs, 15.0_yrs};
+
+  pfg::Population population;
+  for (std::size_t i = 0; i < n; ++i) {
+    add(i, population);
+  }
+  auto mosquitoes = initial;
+  RandomStreams streams(22);
+  pfg::BitingTable table;
+  pfg::Recorder recorder(edges);
+  auto t = 0.0;
+  for (auto step = 0; step < 30; ++step) {
+    t = pfg::one_step(t, 1.0_days, population, params, mosquitoes, streams,
+                      table, recorder);
+  }
+  std::vector<double> expected(pfg::Recorder::column_names(3).size());
+  recorder.fill_row(t, expected.data());
+  const auto eir = mosquitoes.eir();
+
+  // Every block draws its own candidates, so the shards do not draw the same.
+  for (std::size_t processes : {1, 3}) {
+    EXPECT_NO_THROW(run_local(processes, [&](Communicator& communicator) {
+      pfg::Domain domain(communicator, n);
+      auto shard = domain.shard(add);
+      auto mosquitoes = initial;
+      RandomStreams streams(22);
+      pfg::BitingTable table;
+      pfg::Recorder recorder(edges);
+      ThreadPool pool(2);
+      auto t = 0.0;
+      for (auto step = 0; step < 30; ++step) {
+        t = pfg::one_step(t, 1.0_days, shard, params, mosquitoes, streams,
+                          domain, table, recorder, pool);
+      }
+      std::vector<double> row;
+      domain.gather(recorder, t, row);
+      require(row == expected, "recorder");
+      require(mosquitoes.eir() == eir, "mosquitoes");
+    }));
+  }
+}
@@ -0,0 +1,97 @@
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "PlasX/Falciparum/Griffin/ensemble.hpp"
+#include "PlasX/Falciparum/Griffin/population.hpp"
+#include "PlasX/Falciparum/Griffin/recorder.hpp"
+#include "PlasX/Falciparum/griffin.hpp"
+#include "PlasX/column_writer.hpp"
+#include "PlasX/random.hpp"
+#include "PlasX/simulation.hpp"
+#include "PlasX/thread_pool.hpp"
+#include "PlasX/udl.hpp"
+#include "gtest/gtest.h"
+
+#include "populations.hpp"
+
+using namespace plasx;
+namespace pfg = falciparum::griffin;
+using test::susceptible_population;
+
+static std::vector<pfg::Scenario> make_scenarios() {
+  pfg::Parameters params;
+  params.mu_d = 1.0 / 1.0_yrs;
+  auto treated = params;
+  treated.f_T = 0.9;
+  return {{params, 0.01}, {params, 0.05}, {treated, 0.05}};
+}
+
+// Individual i is i days old.
+static double age(const std::size_t i) { return i * 1.0_days; }
+
+static ColumnTable run(const std::size_t n_threads, const std::string& path) {
+  ThreadPool pool(n_threads);
+  pfg::Ensemble ensemble(pool);
+  {
+    pfg::EnsembleOutput output(path, {0.0, 5.0_yrs});
+    ensemble.run(make_scenarios(), 4, susceptible_population(1500, age),
+                 0.0_days, 20.0_days, 1.0_days, output, 99);
+  }
+  EXPECT_LE(ensemble.buffers(), n_threads);
+  auto table = read_columns(path);
+  std::remove(path.c_str());
+  return table;
+}
+
+// Sum of a column over the rows of one replicate.
+static double replicate_sum(const ColumnTable& table, const std::string& name,
+                            double scenario, double replicate) {
+  double sum = 0.0;
+  for (std::size_t r = 0; r < table["t"].size(); ++r) {
+    if (table["scenario"][r] == scenario &&
+        table["replicate"][r] == replicate) {
+      sum += table[name][r];
+    }
+  }
+  return sum;
+}
+
+TEST(Ensemble, IndependentOfThreadCount) {
+  const auto one = run(1, "ensemble_one.plasx");
+  const auto three = run(3, "ensemble_three.plasx");
+  ASSERT_EQ(one["t"].size(), 3u * 4u * 20u);
+  ASSERT_EQ(three["t"].size(), one["t"].size());
+  // Row for row, in (scenario, replicate) order.
+  EXPECT_EQ(one.columns, three.columns);
+  for (std::size_t r = 0; r < one["t"].size(); ++r) {
+    EXPECT_EQ(one["scenario"][r] * 4 + one["replicate"][r], r / 20);
+  }
+  for (double s = 0; s < 3; ++s) {
+    for (double r = 0; r < 4; ++r) {
+      for (const auto& name : {"infections[0]", "A[1]", "deaths[1]"}) {
+        EXPECT_EQ(replicate_sum(one, name, s, r),
+                  replicate_sum(three, name, s, r));
+      }
+    }
+  }
+}
+
+TEST(Ensemble, MatchesSingleRun) {
+  const auto table = run(2, "ensemble_single.plasx");
+  const auto scenarios = make_scenarios();
+
+  // Replicate 2 of scenario 1 on its own.
+  auto population = susceptible_population(1500, age);
+  RandomStreams streams(RandomStreams(99).key(1, 2));
+  pfg::Recorder recorder({0.0, 5.0_yrs});
+  std::uint64_t infections = 0;
+  auto t = 0.0_days;
+  while (t < 20.0_days) {
+    t = pfg::one_step(t, 1.0_days, population, scenarios[1].params,
+                      scenarios[1].eir, streams, recorder);
+    infections += recorder.last_step().infections_[0];
+  }
+  EXPECT_EQ(replicate_sum(table, "infections[0]", 1, 2), infections);
+  EXPECT_GT(infections, 0u);
+}
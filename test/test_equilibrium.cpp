@@ -0,0 +1,118 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+
+#include "PlasX/Falciparum/Griffin/equilibrium.hpp"
+#include "PlasX/Falciparum/Griffin/population.hpp"
+#include "PlasX/Falciparum/griffin.hpp"
+#include "PlasX/random.hpp"
+#include "PlasX/simulation.hpp"
+#include "PlasX/thread_pool.hpp"
+#include "PlasX/udl.hpp"
+#include "gtest/gtest.h"
+
+using namespace plasx;
+namespace pfg = falciparum::griffin;
+
+static pfg::Parameters parameters() {
+  pfg::Parameters params;
+  params.mu_d = 1.0 / 20.0_yrs;
+  params.P_M = 0.5;
+  return params;
+}
+
+static double share(const pfg::Population& population, const pfg::Status s) {
+  const auto count = std::count(population.current_.begin(),
+                                population.current_.end(), s);
+  return static_cast<double>(count) / population.size();
+}
+
+TEST(Equilibrium, DoesNotDependOnThreads) {
+  const pfg::Equilibrium equilibrium(parameters(), 0.05);
+  pfg::Population threaded, serial;
+  ThreadPool pool(4);
+  RandomStreams threaded_streams(1), serial_streams(1);
+  equilibrium.fill(threaded, 20000, pool, threaded_streams);
+  equilibrium.fill(serial, 20000, serial_streams);
+  EXPECT_EQ(threaded.age_, serial.age_);
+  EXPECT_EQ(threaded.current_, serial.current_);
+  EXPECT_EQ(threaded.I_B_, serial.I_B_);
+  EXPECT_EQ(threaded.I_CM_, serial.I_CM_);
+  EXPECT_EQ(threaded.zeta_, serial.zeta_);
+}
+
+TEST(Equilibrium, DrawsZeta) {
+  auto params = parameters();
+  params.sigma = 0.5;
+  const pfg::Equilibrium equilibrium(params, 0.05);
+  pfg::Population population;
+  RandomStreams streams(3);
+  equilibrium.fill(population, 100000, streams);
+
+  const auto n = static_cast<double>(population.size());
+  const auto mean =
+      std::accumulate(population.zeta_.begin(), population.zeta_.end(), 0.0) /
+      n;
+  auto variance = 0.0;
+  for (const auto zeta : population.zeta_) {
+    variance += (zeta - mean) * (zeta - mean) / (n - 1.0);
+  }
+  // Log-normal with mean 1, and variance exp(sigma^2) - 1. Both to within five
+  // standard errors.
+  const auto expected = std::exp(params.sigma * params.sigma) - 1.0;
+  EXPECT_NEAR(mean, 1.0, 5.0 * std::sqrt(expected / n));
+  EXPECT_NEAR(variance, expected, 0.015);
+}
+
+TEST(Equilibrium, FollowsTheDemography) {
+  const auto params = parameters();
+  const pfg::Equilibrium equilibrium(params, 0.05);
+  pfg::Population population;
+  RandomStreams streams(2);
+  equilibrium.fill(population, 100000, streams);
+
+  const auto n = static_cast<double>(population.size());
+  const auto mean_age =
+      std::accumulate(population.age_.begin(), population.age_.end(), 0.0) /
+      n;
+  EXPECT_NEAR(mean_age, 20.0_yrs, 5.0 * 20.0_yrs / std::sqrt(n));
+  for (std::size_t s = 0; s < pfg::n_status; ++s) {
+    const auto status = static_cast<pfg::Status>(s);
+    const auto expected = equilibrium.share(status);
+    EXPECT_NEAR(share(population, status), expected,
+                5.0 * std::sqrt(expected * (1.0 - expected) / n));
+  }
+  // Immunity builds up with exposure, bar the maternal immunity, and those
+  // bitten more often are more often infected.
+  const auto S = static_cast<std::size_t>(pfg::Status::S);
+  EXPECT_GT(equilibrium.at(20.0_yrs).I_B[S], equilibrium.at(1.0_yrs).I_B[S]);
+  EXPECT_GT(equilibrium.at(20.0_yrs).I_A[S], equilibrium.at(1.0_yrs).I_A[S]);
+  EXPECT_GT(equilibrium.at(0.0).I_CM, equilibrium.at(1.0_yrs).I_CM);
+  EXPECT_GT(equilibrium.at(20.0_yrs, 0.2).share[S],
+            equilibrium.at(20.0_yrs, 5.0).share[S]);
+  EXPECT_THROW(pfg::Equilibrium(pfg::Parameters(), 0.05),
+               std::invalid_argument);
+}
+
+TEST(Equilibrium, StaysNearEquilibrium) {
+  const auto params = parameters();
+  // Without the spread of immunity within a compartment, the shares settle a
+  // little away, by less for S than for the smaller A and U.
+  const std::array<double, 3> tolerance = {0.05, 0.15, 0.15};
+  for (const auto eir : {0.05, 0.5}) {
+    const pfg::Equilibrium equilibrium(params, eir);
+    pfg::Population population;
+    RandomStreams streams(3);
+    equilibrium.fill(population, 50000, streams);
+    plasx::simulation(0.0, 1.0_yrs, 1.0_days, pfg::one_step, population,
+                      params, eir, streams);
+    for (std::size_t s = 0; s < tolerance.size(); ++s) {
+      const auto status = static_cast<pfg::Status>(s);
+      EXPECT_NEAR(share(population, status) / equilibrium.share(status), 1.0,
+                  tolerance[s])
+          << "compartment " << s << " at EIR " << eir;
+    }
+  }
+}
@@ -0,0 +1,99 @@
+#include <array>
+#include <cmath>
+
+#include "PlasX/Falciparum/Griffin/event_driven.hpp"
+#include "PlasX/Falciparum/Griffin/population.hpp"
+#include "PlasX/Falciparum/Griffin/turnover.hpp"
+#include "PlasX/Falciparum/griffin.hpp"
+#include "PlasX/random.hpp"
+#include "PlasX/simulation.hpp"
+#include "PlasX/udl.hpp"
+#include "gtest/gtest.h"
+
+#include "populations.hpp"
+
+using namespace plasx;
+namespace pfg = falciparum::griffin;
+using test::susceptible_population;
+
+static std::array<double, 6> fractions(const pfg::Population& population) {
+  std::array<double, 6> f{};
+  for (auto status : population.current_) {
+    f[static_cast<int>(status)] += 1.0 / population.size();
+  }
+  return f;
+}
+
+static double age(std::size_t) { return 10.0_yrs; }
+
+static double newborn(std::size_t) { return 0.0; }
+
+TEST(EventDriven, AgreesWithFixedStep) {
+  // Slow dynamics relative to dt, so the fixed step is close to the continuous
+  // time model. Starting from newborns, over 15 years the population comes to
+  // hold every age, and psi, b and r_A change between each individual's
+  // events.
+  pfg::Parameters params;
+  params.mu_d = 1.0 / 10.0_yrs;
+  params.r_T = 1.0 / 20.0_days;
+  params.r_D = 1.0 / 20.0_days;
+  const auto N = 20000;
+  const auto eir = 0.01;
+
+  auto fixed = susceptible_population(N, newborn);
+  ThreadPool pool(1);
+  RandomStreams streams(5);
+  plasx::simulation(0.0_days, 15.0_yrs, 0.5_days, pfg::one_step, fixed,
+                    params, eir, pool, streams);
+
+  auto event = susceptible_population(N, newborn);
+  pfg::EventDriven engine(5);
+  plasx::simulation(0.0_days, 15.0_yrs, 50.0_days, engine, event, params,
+                    eir);
+
+  EXPECT_NEAR(static_cast<double>(event.size()) / fixed.size(), 1.0, 0.01);
+  const auto f_fixed = fractions(fixed), f_event = fractions(event);
+  for (auto s = 0; s < 6; ++s) {
+    EXPECT_NEAR(f_fixed[s], f_event[s], 0.015) << "status " << s;
+  }
+}
+
+TEST(EventDriven, OnlyVisitsDueIndividuals) {
+  pfg::Parameters params;
+  auto population = susceptible_population(10000, age);
+  pfg::EventDriven engine(1);
+  plasx::simulation(0.0_days, 1.0_yrs, 1.0_days, engine, population, params,
+                    1e-5);
+  // About 25 infections are expected, each followed by at most four changes
+  // of compartment within the year. A daily stepper would have made 3.65
+  // million visits.
+  EXPECT_GT(engine.events(), 20u);
+  EXPECT_LT(engine.events(), 200u);
+}
+
+TEST(EventDriven, NewbornsTakeImmunityFromMothers) {
+  pfg::Parameters params;
+  params.mu_d = 1.0 / 1.0_yrs;
+  // Only the 20 year olds are mothers, the children and the elderly are not.
+  pfg::Population population;
+  for (auto i = 0; i < 3000; ++i) {
+    const auto age = std::array{5.0_yrs, 20.0_yrs, 50.0_yrs}[i % 3];
+    population.emplace_back(age, pfg::Status::S, i % 3 == 1 ? 2.0 : 10.0,
+                            0.0, 0.0);
+  }
+  pfg::EventDriven engine(3);
+  plasx::simulation(0.0_days, 30.0_days, 10.0_days, engine, population,
+                    params, 0.0);
+
+  pfg::catch_up(population, 0, population.size(), params, 30.0_days);
+  std::size_t newborns = 0;
+  for (std::size_t i = 0; i < population.size(); ++i) {
+    if (population.age_[i] < 30.0_days) {
+      ++newborns;
+      const auto ICM =
+          params.P_M * 2.0 * std::exp(-population.age_[i] / params.d_M);
+      EXPECT_NEAR(population.I_CM_[i], ICM, 1e-6 * ICM);
+    }
+  }
+  EXPECT_GT(newborns, 100u);
+}
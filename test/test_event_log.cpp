@@ -0,0 +1,121 @@
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "PlasX/Falciparum/Griffin/biting.hpp"
+#include "PlasX/Falciparum/Griffin/event_log.hpp"
+#include "PlasX/Falciparum/Griffin/population.hpp"
+#include "PlasX/Falciparum/griffin.hpp"
+#include "PlasX/random.hpp"
+#include "PlasX/simulation.hpp"
+#include "PlasX/thread_pool.hpp"
+#include "PlasX/udl.hpp"
+#include "gtest/gtest.h"
+
+#include "populations.hpp"
+
+using namespace plasx;
+namespace pfg = falciparum::griffin;
+using test::mixed_population;
+
+static pfg::Parameters parameters() {
+  pfg::Parameters params;
+  params.mu_d = 1.0 / 2.0_yrs;
+  return params;
+}
+
+TEST(EventLog, ReplaysToTheFinalState) {
+  const auto path = std::string(testing::TempDir()) + "events.plasx";
+  const auto params = parameters();
+  auto population = mixed_population(10000);
+  auto status = population.current_;
+  {
+    // Small chunks, so the file has many of them.
+    pfg::EventLog log(path, 1000);
+    RandomStreams streams(2);
+    ThreadPool pool(3);
+    plasx::simulation(0.0, 40.0_days, 1.0_days, pfg::one_step, population,
+                      params, 0.2, pool, streams, log);
+    log.close();
+    EXPECT_GT(log.records(), 1000u);
+  }
+
+  const auto events = pfg::read_event_log(path);
+  std::remove(path.c_str());
+  std::size_t infections = 0, deaths = 0, births = 0;
+  for (std::size_t e = 0; e < events.event.size(); ++e) {
+    auto& current = status[events.individual[e]];
+    switch (events.event[e]) {
+      case pfg::Event::birth:
+        ASSERT_EQ(current, pfg::Status::S);
+        ++births;
+        break;
+      case pfg::Event::death:
+        ASSERT_EQ(current, events.from[e]);
+        // The newborn starts in S.
+        current = pfg::Status::S;
+        ++deaths;
+        break;
+      case pfg::Event::infection:
+        ++infections;
+        [[fallthrough]];
+      case pfg::Event::transition:
+        ASSERT_EQ(current, events.from[e]);
+        current = events.to[e];
+        break;
+    }
+    if (e > 0) {
+      ASSERT_GE(events.time[e], events.time[e - 1]);
+    }
+  }
+  EXPECT_EQ(status, population.current_);
+  EXPECT_GT(infections, 0u);
+  EXPECT_GT(deaths, 0u);
+  EXPECT_EQ(births, deaths);
+}
+
+TEST(EventLog, DoesNotChangeTheResult) {
+  const auto path = std::string(testing::TempDir()) + "unchanged.plasx";
+  const auto params = parameters();
+  auto logged = mixed_population(5000);
+  auto expected = logged;
+  RandomStreams logged_streams(4), streams(4);
+  {
+    pfg::EventLog log(path);
+    plasx::simulation(0.0, 20.0_days, 1.0_days, pfg::one_step, logged, params,
+                      0.2, logged_streams, log);
+  }
+  std::remove(path.c_str());
+  plasx::simulation(0.0, 20.0_days, 1.0_days, pfg::one_step, expected, params,
+                    0.2, streams);
+  EXPECT_EQ(logged.current_, expected.current_);
+  EXPECT_EQ(logged.I_B_, expected.I_B_);
+}
+
+TEST(EventLog, DoesNotChangeTheResultWithABitingTable) {
+  const auto path = std::string(testing::TempDir()) + "table.plasx";
+  const auto params = parameters();
+  auto logged = mixed_population(5000);
+  auto expected = logged;
+  RandomStreams logged_streams(5), streams(5);
+  pfg::BitingTable logged_table, table;
+  {
+    pfg::EventLog log(path);
+    plasx::simulation(0.0, 20.0_days, 1.0_days, pfg::one_step, logged, params,
+                      0.2, logged_streams, logged_table, log);
+    log.close();
+    EXPECT_GT(log.records(), 0u);
+  }
+  std::remove(path.c_str());
+  plasx::simulation(0.0, 20.0_days, 1.0_days, pfg::one_step, expected, params,
+                    0.2, streams, table);
+  EXPECT_EQ(logged.current_, expected.current_);
+  EXPECT_EQ(logged.zeta_, expected.zeta_);
+}
+
+TEST(EventLog, RejectsBadFiles) {
+  EXPECT_THROW(pfg::EventLog("/nonexistent/events.plasx"), std::runtime_error);
+  EXPECT_THROW(pfg::read_event_log("/nonexistent/events.plasx"),
+               std::runtime_error);
+}
@@ -0,0 +1,66 @@
+#include "PlasX/Falciparum/Griffin/population.hpp"
+#include "PlasX/Falciparum/griffin.hpp"
+#include "PlasX/random.hpp"
+#include "PlasX/simulation.hpp"
+#include "PlasX/thread_pool.hpp"
+#include "PlasX/udl.hpp"
+#include "gtest/gtest.h"
+
+#include "populations.hpp"
+
+using namespace plasx;
+namespace pfg = falciparum::griffin;
+using test::mixed_population;
+
+TEST(Features, MatchesOneStepWhenSwitchedOff) {
+  // mu_d and delay are both 0, so OneStep leaves the same features out.
+  pfg::Parameters params;
+  auto expected = mixed_population(10000);
+  auto population = expected;
+  auto all = expected;
+  RandomStreams expected_streams(3), streams(3), all_streams(3);
+  ThreadPool pool(2);
+  plasx::simulation(0.0, 50.0_days, 1.0_days, pfg::one_step, expected, params,
+                    0.05, expected_streams);
+  plasx::simulation(0.0, 50.0_days, 1.0_days,
+                    pfg::FeatureStep<pfg::Features<false, false, true>>(),
+                    population, params, 0.05, pool, streams);
+  plasx::simulation(0.0, 50.0_days, 1.0_days,
+                    pfg::FeatureStep<pfg::AllFeatures>(), all, params, 0.05,
+                    all_streams);
+
+  EXPECT_EQ(population.current_, expected.current_);
+  EXPECT_EQ(population.I_B_, expected.I_B_);
+  EXPECT_EQ(population.I_CA_, expected.I_CA_);
+  EXPECT_EQ(all.current_, expected.current_);
+  EXPECT_EQ(all.next_infection_, expected.next_infection_);
+}
+
+TEST(Features, WithoutMortalityNoOneDies) {
+  pfg::Parameters params;
+  params.mu_d = 1.0 / 1.0_yrs;
+  auto population = mixed_population(5000);
+  const auto ages = population.age_;
+  RandomStreams streams(8);
+  plasx::simulation(0.0, 20.0_days, 1.0_days,
+                    pfg::FeatureStep<pfg::Features<false, true, true>>(),
+                    population, params, 0.05, streams);
+  for (std::size_t i = 0; i < ages.size(); ++i) {
+    EXPECT_DOUBLE_EQ(population.age_[i], ages[i] + 20.0_days);
+  }
+}
+
+TEST(Features, WithoutImmunityNothingChanges) {
+  pfg::Parameters params;
+  auto population = mixed_population(5000);
+  const auto before = population;
+  RandomStreams streams(9);
+  plasx::simulation(0.0, 30.0_days, 1.0_days,
+                    pfg::FeatureStep<pfg::Features<true, true, false>>(),
+                    population, params, 0.5, streams);
+  EXPECT_NE(population.current_, before.current_);
+  EXPECT_EQ(population.I_CA_, before.I_CA_);
+  EXPECT_EQ(population.I_CM_, before.I_CM_);
+  EXPECT_EQ(population.I_A_, before.I_A_);
+  EXPECT_EQ(population.I_B_, before.I_B_);
+}
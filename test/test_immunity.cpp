@@ -0,0 +1,96 @@
+#include <cmath>
+#include <type_traits>
+#include <vector>
+
+#include "PlasX/Falciparum/Griffin/immunity.hpp"
+#include "PlasX/Falciparum/Griffin/population.hpp"
+#include "PlasX/Falciparum/griffin.hpp"
+#include "PlasX/random.hpp"
+#include "PlasX/simulation.hpp"
+#include "PlasX/types.hpp"
+#include "PlasX/udl.hpp"
+#include "gtest/gtest.h"
+
+using namespace plasx;
+namespace pfg = falciparum::griffin;
+
+// Relative error allowed in the state, which is float in a single precision
+// build (see types.hpp).
+static constexpr double tolerance =
+    std::is_same_v<StateType, double> ? 1e-12 : 1e-5;
+
+TEST(Immunity, CatchUpMatchesStepwiseDecay) {
+  pfg::Parameters params;
+  pfg::Population stepped, lazy;
+  for (auto i = 0; i < 100; ++i) {
+    stepped.emplace_back(10.0, pfg::Status::S, 1.0 + i, 2.0, 3.0);
+    lazy.emplace_back(10.0, pfg::Status::S, 1.0 + i, 2.0, 3.0);
+  }
+  stepped.I_B_.assign(100, 4.0);
+  lazy.I_B_.assign(100, 4.0);
+
+  // Half of lazy is last touched at day 10, the rest at day 0.
+  pfg::catch_up_immunity(lazy, 0, 100, params, 0.0);
+  pfg::catch_up_immunity(lazy, 0, 50, params, 10.0_days);
+  pfg::catch_up_immunity(lazy, 0, 100, params, 40.0_days);
+
+  pfg::catch_up_immunity(stepped, 0, 100, params, 0.0);
+  const auto decay = pfg::immunity_decay(params, 1.0_days);
+  for (auto day = 1; day <= 40; ++day) {
+    pfg::decay_immunity(stepped, 0, 100, decay, day * 1.0_days);
+  }
+
+  for (std::size_t i = 0; i < 100; ++i) {
+    EXPECT_NEAR(lazy.I_CA_[i], stepped.I_CA_[i], tolerance * stepped.I_CA_[i]);
+    EXPECT_NEAR(lazy.I_CM_[i], stepped.I_CM_[i], tolerance * stepped.I_CM_[i]);
+    EXPECT_NEAR(lazy.I_A_[i], stepped.I_A_[i], tolerance * stepped.I_A_[i]);
+    EXPECT_NEAR(lazy.I_B_[i], stepped.I_B_[i], tolerance * stepped.I_B_[i]);
+    EXPECT_EQ(lazy.updated_[i], 40.0_days);
+  }
+  EXPECT_NEAR(lazy.I_CM_[0], 2.0 * std::exp(-40.0_days / params.d_M),
+              tolerance);
+}
+
+TEST(Immunity, DecaysWithoutTransmission) {
+  pfg::Parameters params;
+  pfg::Population population;
+  population.emplace_back(10.0, pfg::Status::S, 1.0, 1.0, 1.0);
+  plasx::simulation(0.0_days, 30.0_days, 1.0_days, pfg::one_step, population,
+                    params, 0.0);
+  EXPECT_NEAR(population.I_CA_[0], std::exp(-30.0_days / params.d_C),
+              tolerance);
+  EXPECT_NEAR(population.I_CM_[0], std::exp(-30.0_days / params.d_M),
+              tolerance);
+  EXPECT_NEAR(population.I_A_[0], std::exp(-30.0_days / params.d_A),
+              tolerance);
+}
+
+TEST(Immunity, BoostedByInfection) {
+  pfg::Parameters params;
+  const auto N = 500;
+  std::vector<Individual<pfg::PFalc>> aos;
+  pfg::Population soa;
+  for (auto i = 0; i < N; ++i) {
+    aos.emplace_back(10.0_yrs, pfg::Status::S, 0.0, 0.0, 0.0);
+    soa.emplace_back(10.0_yrs, pfg::Status::S, 0.0, 0.0, 0.0);
+  }
+  generator.seed(8);
+  plasx::simulation(0.0_days, 50.0_days, 1.0_days, pfg::one_step, aos, params,
+                    0.05);
+  generator.seed(8);
+  plasx::simulation(0.0_days, 50.0_days, 1.0_days, pfg::one_step, soa, params,
+                    0.05);
+
+  double total_IB = 0.0;
+  for (std::size_t i = 0; i < soa.size(); ++i) {
+    const auto IC = soa.I_CA_[i] + soa.I_CM_[i];
+    EXPECT_NEAR(aos[i].status_.getIB(), soa.I_B_[i], tolerance * soa.I_B_[i]);
+    EXPECT_NEAR(aos[i].status_.getIC(), IC, tolerance * IC);
+    if (soa.current_[i] != pfg::Status::S) {
+      EXPECT_GT(soa.I_B_[i], 0.0);
+      EXPECT_GT(soa.I_CA_[i], 0.0);
+    }
+    total_IB += soa.I_B_[i];
+  }
+  EXPECT_GT(total_IB, 0.0);
+}
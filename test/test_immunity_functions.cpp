@@ -0,0 +1,68 @@
+#include <cmath>
+
+#include "PlasX/Falciparum/Griffin/immunity_functions.hpp"
+#include "PlasX/Falciparum/Griffin/parameters.h"
+#include "PlasX/random.hpp"
+#include "gtest/gtest.h"
+
+using namespace plasx;
+namespace pfg = falciparum::griffin;
+
+// Check the tables against the exact functions at random points spread over
+// eight orders of magnitude around each function's scale.
+static void check_error_bound(const pfg::Parameters& params) {
+  const pfg::ImmunityFunctions functions(params);
+  ASSERT_FALSE(functions.exact());
+  const auto tol = params.function_tolerance;
+  // Interpolation error between knots is at most a little above the error at
+  // the midpoints, which is what the tables are built to.
+  const auto bound = 1.5 * tol;
+
+  Xoshiro256 rng(17);
+  for (auto k = 0; k < 20000; ++k) {
+    const auto scale = std::pow(10.0, -4.0 + 8.0 * rng.uniform());
+    const auto I_B = scale * params.I_B0, I_C = scale * params.I_C0,
+               I_A = scale * params.I_A0, age = scale * params.age_0;
+    EXPECT_LE(std::abs(functions.b(I_B) - functions.exact_b(I_B)),
+              bound * params.b_max);
+    EXPECT_LE(std::abs(functions.phi(I_C) - functions.exact_phi(I_C)), bound);
+    EXPECT_LE(std::abs(functions.r_A(I_A) - functions.exact_r_A(I_A)),
+              bound * params.r_A0 * std::max(1.0, params.w_A));
+    EXPECT_LE(std::abs(functions.psi(age) - functions.exact_psi(age)), bound);
+  }
+  EXPECT_EQ(functions.b(0.0), functions.exact_b(0.0));
+  EXPECT_EQ(functions.psi(0.0), functions.exact_psi(0.0));
+}
+
+TEST(ImmunityFunctions, TablesWithinTolerance) {
+  pfg::Parameters params;
+  check_error_bound(params);
+
+  params.function_tolerance = 1e-9;
+  params.w_A = 3.0;
+  check_error_bound(params);
+}
+
+TEST(ImmunityFunctions, ExactSwitch) {
+  pfg::Parameters params;
+  params.exact_functions = true;
+  const pfg::ImmunityFunctions functions(params);
+  EXPECT_TRUE(functions.exact());
+  EXPECT_EQ(functions.phi(2.0),
+            1.0 / (1.0 + std::pow(2.0 / params.I_C0, params.kappa_C)));
+  EXPECT_EQ(functions.psi(100.0),
+            1.0 - params.rho * std::exp(-100.0 / params.age_0));
+}
+
+TEST(ImmunityFunctions, ExactWhenTablesCannotConverge) {
+  pfg::Parameters params;
+  params.function_tolerance = 1e-18;
+  const pfg::ImmunityFunctions functions(params);
+  EXPECT_TRUE(functions.exact());
+  EXPECT_EQ(functions.b(3.0), functions.exact_b(3.0));
+
+  const pfg::Tabulated table([](double x) { return x / (1.0 + x); }, 1.0, 1.0,
+                             1e-18);
+  EXPECT_FALSE(table.converged());
+  EXPECT_GT(table.error(), 0.0);
+}
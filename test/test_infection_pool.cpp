@@ -0,0 +1,56 @@
+#include <limits>
+#include <utility>
+
+#include "PlasX/Falciparum/Griffin/infection_pool.hpp"
+#include "PlasX/Falciparum/griffin.hpp"
+#include "gtest/gtest.h"
+
+using namespace plasx;
+namespace pfg = falciparum::griffin;
+
+TEST(InfectionPool, KeepsListsSortedAndRecyclesNodes) {
+  pfg::InfectionPool pool;
+  auto head = pfg::InfectionPool::none;
+  pool.insert(head, 4.0);
+  pool.insert(head, 1.0);
+  pool.insert(head, 3.0);
+  EXPECT_EQ(pool.size(), 3u);
+
+  EXPECT_EQ(pool.pop_until(head, 2.0), 3.0);
+  EXPECT_EQ(pool.size(), 2u);
+
+  auto copy = pool.copy(head);
+  EXPECT_EQ(pool.size(), 4u);
+  pool.release(head);
+  EXPECT_EQ(head, pfg::InfectionPool::none);
+  EXPECT_EQ(pool.pop_until(copy, 3.5), 4.0);
+  EXPECT_EQ(pool.pop_until(copy, 4.0),
+            std::numeric_limits<double>::infinity());
+  EXPECT_EQ(pool.size(), 0u);
+}
+
+TEST(PFalc, PendingInfectionsFollowCopiesAndMoves) {
+  const auto in_use = pfg::InfectionPool::shared().size();
+  {
+    pfg::PFalc state(pfg::Status::S, 0.0, 0.0, 0.0);
+    state.scheduleInfection(3.0);
+    state.scheduleInfection(1.0);
+    state.scheduleInfection(2.0);
+
+    auto copy = state;
+    auto moved = std::move(state);
+    EXPECT_TRUE(moved.updateInfection(1.5));
+    EXPECT_FALSE(moved.updateInfection(1.5));
+    EXPECT_TRUE(moved.updateInfection(3.0));
+    EXPECT_FALSE(moved.updateInfection(10.0));
+
+    EXPECT_TRUE(copy.updateInfection(2.0));
+    EXPECT_FALSE(copy.updateInfection(2.5));
+    EXPECT_TRUE(copy.updateInfection(3.0));
+    copy.scheduleInfection(5.0);
+    copy.scheduleInfection(6.0);
+    copy.clearInfectionQueue();
+    EXPECT_FALSE(copy.updateInfection(10.0));
+  }
+  EXPECT_EQ(pfg::InfectionPool::shared().size(), in_use);
+}
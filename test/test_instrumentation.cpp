@@ -0,0 +1,95 @@
+#include <numeric>
+
+#include "PlasX/Falciparum/Griffin/instrumentation.hpp"
+#include "PlasX/Falciparum/Griffin/population.hpp"
+#include "PlasX/Falciparum/griffin.hpp"
+#include "PlasX/perf_counters.hpp"
+#include "PlasX/random.hpp"
+#include "PlasX/simulation.hpp"
+#include "PlasX/udl.hpp"
+#include "gtest/gtest.h"
+
+#include "populations.hpp"
+
+using namespace plasx;
+namespace pfg = falciparum::griffin;
+using test::mixed_population;
+
+TEST(Instrumentation, ObserverSeesEveryStepAndCanStop) {
+  pfg::Parameters params;
+  auto population = mixed_population(1000);
+  RandomStreams streams(1);
+  std::vector<double> seen;
+  auto t = plasx::observed_simulation(
+      0.0, 10.0_days, 1.0_days, pfg::one_step,
+      [&seen](double t) { seen.push_back(t); }, population, params, 0.1,
+      streams);
+  EXPECT_EQ(t, 10.0_days);
+  ASSERT_EQ(seen.size(), 10u);
+  EXPECT_EQ(seen.front(), 1.0_days);
+
+  // An observer that returns false stops the simulation, here after the third
+  // step.
+  auto steps = 0;
+  t = plasx::observed_simulation(
+      t, 1.0_yrs, 1.0_days, pfg::one_step,
+      [&](double) {
+        ++steps;
+        return steps < 3;
+      },
+      population, params, 0.1, streams);
+  EXPECT_EQ(steps, 3);
+  EXPECT_EQ(t, 13.0_days);
+}
+
+TEST(Instrumentation, CountsEveryAgentStep) {
+  pfg::Parameters params;
+  params.mu_d = 1.0 / 2.0_yrs;
+  auto& instrumentation = pfg::Instrumentation::global();
+  instrumentation.reset();
+  const std::size_t n = 5000, steps = 10;
+  auto population = mixed_population(n);
+  RandomStreams streams(2);
+  plasx::simulation(0.0, steps * 1.0_days, 1.0_days, pfg::one_step,
+                    population, params, 0.1, streams);
+
+  const auto counters = instrumentation.counters();
+  if constexpr (!pfg::instrumented) {
+    EXPECT_EQ(instrumentation.steps(), 0u);
+    EXPECT_EQ(counters.visits[0], 0u);
+    return;
+  }
+  EXPECT_EQ(instrumentation.steps(), steps);
+  EXPECT_GT(instrumentation.step_seconds(), 0.0);
+  const auto total = [](const auto& counts) {
+    return std::accumulate(counts.begin(), counts.end(), std::uint64_t{0});
+  };
+  EXPECT_EQ(total(counters.visits), n * steps);
+  EXPECT_EQ(total(counters.queue_lengths), n * steps);
+  std::uint64_t outcomes = total(counters.deaths);
+  for (const auto& from : counters.transitions) {
+    outcomes += total(from);
+  }
+  EXPECT_EQ(outcomes, n * steps);
+  // Every update uses at least one draw and at most three.
+  EXPECT_GE(total(counters.draws), n * steps);
+  EXPECT_LE(total(counters.draws), 3 * n * steps);
+  EXPECT_GT(counters.deaths[0], 0u);
+}
+
+TEST(Instrumentation, HardwareCountersAreOptional) {
+  PerfCounters perf;
+  const auto before = perf.read();
+  volatile double sum = 0.0;
+  for (auto i = 0; i < 100000; ++i) {
+    sum = sum + i;
+  }
+  const auto used = perf.read() - before;
+  if (perf.available()) {
+    EXPECT_GT(used.instructions, 100000u);
+    EXPECT_GT(used.cycles, 0u);
+  } else {
+    EXPECT_EQ(used.instructions, 0u);
+    EXPECT_EQ(used.cycles, 0u);
+  }
+}
@@ -0,0 +1,195 @@
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+
+#include "PlasX/Falciparum/Griffin/biting.hpp"
+#include "PlasX/Falciparum/Griffin/event_log.hpp"
+#include "PlasX/Falciparum/Griffin/interventions.hpp"
+#include "PlasX/Falciparum/Griffin/population.hpp"
+#include "PlasX/Falciparum/Griffin/recorder.hpp"
+#include "PlasX/Falciparum/griffin.hpp"
+#include "PlasX/random.hpp"
+#include "PlasX/simulation.hpp"
+#include "PlasX/udl.hpp"
+#include "gtest/gtest.h"
+
+#include "populations.hpp"
+
+using namespace plasx;
+namespace pfg = falciparum::griffin;
+using test::mixed_population;
+
+TEST(Interventions, MassDrugAdministrationTreatsEveryoneInRange) {
+  auto population = mixed_population(6000);
+  // Every seventh has one infection pending, and every fourteenth two.
+  for (std::size_t i = 0; i < population.size(); i += 7) {
+    population[i].scheduleInfection(3.0);
+    if (i % 14 == 0) {
+      population[i].scheduleInfection(5.0);
+    }
+  }
+  const auto before = population;
+  pfg::Schedule schedule;
+  schedule.add(0.0, pfg::MassDrugAdministration{1.0, 5.0_yrs, 15.0_yrs});
+  schedule.apply(0.0, 1.0_days, population);
+
+  std::size_t still_pooled = 0;
+  for (std::size_t i = 0; i < population.size(); ++i) {
+    const auto age = population.age_[i];
+    const auto was = before.current_[i];
+    if (age >= 5.0_yrs && age < 15.0_yrs) {
+      EXPECT_EQ(population.current_[i],
+                was == pfg::Status::P ? pfg::Status::P : pfg::Status::T);
+      if (was != pfg::Status::T && was != pfg::Status::P) {
+        EXPECT_EQ(population.next_infection_[i],
+                  std::numeric_limits<double>::infinity());
+      }
+    } else {
+      EXPECT_EQ(population.current_[i], was);
+      EXPECT_EQ(population.next_infection_[i], before.next_infection_[i]);
+    }
+    still_pooled += population.overflow_[i] != pfg::InfectionPool::none;
+  }
+  EXPECT_EQ(population.pool().size(), still_pooled);
+  EXPECT_LT(still_pooled, before.pool().size());
+  EXPECT_EQ(schedule.pending(), 0u);
+}
+
+TEST(Interventions, BednetsLastForTheirDuration) {
+  pfg::Parameters params;
+  params.mu_d = 1.0 / 2.0_yrs;
+  // Newborns draw zeta = 1, so only the nets change it.
+  params.sigma = 0.0;
+  auto population = mixed_population(20000);
+  pfg::Schedule schedule(3);
+  schedule.add(10.0_days, pfg::BednetCampaign{0.6, 0.5, 30.0_days});
+  RandomStreams streams(3);
+  const pfg::Scheduled step(pfg::one_step, schedule);
+
+  auto t = plasx::simulation(0.0, 11.0_days, 1.0_days, step, population,
+                             params, 0.1, streams);
+  std::size_t covered = 0;
+  for (const auto zeta : population.zeta_) {
+    covered += zeta == 0.5;
+  }
+  const auto n = population.size();
+  EXPECT_NEAR(covered, 0.6 * n, 5.0 * std::sqrt(0.24 * n));
+  EXPECT_EQ(schedule.pending(), 1u);
+
+  plasx::simulation(t, 60.0_days, 1.0_days, step, population, params, 0.1,
+                    streams);
+  for (const auto zeta : population.zeta_) {
+    ASSERT_EQ(zeta, 1.0);
+  }
+  EXPECT_EQ(schedule.pending(), 0u);
+}
+
+TEST(Interventions, KeepTheRecorderCounts) {
+  pfg::Parameters params;
+  params.mu_d = 1.0 / 2.0_yrs;
+  auto population = mixed_population(20000);
+  pfg::Schedule schedule(5);
+  schedule.add(5.0_days, pfg::MassDrugAdministration{0.8});
+  RandomStreams streams(5);
+  pfg::Recorder recorder({0.0, 5.0_yrs, 15.0_yrs});
+  plasx::simulation(0.0, 10.0_days, 1.0_days,
+                    pfg::Scheduled(pfg::one_step, schedule), population,
+                    params, 0.1, streams, recorder);
+
+  pfg::Recorder recount({0.0, 5.0_yrs, 15.0_yrs});
+  recount.count(population);
+  for (auto s = 0; s < 6; ++s) {
+    const auto status = static_cast<pfg::Status>(s);
+    EXPECT_EQ(recorder.total(status), recount.total(status)) << "status " << s;
+  }
+  // Most of those treated have moved on to P by now.
+  EXPECT_GT(recorder.total(pfg::Status::T) + recorder.total(pfg::Status::P),
+            population.size() / 2);
+}
+
+TEST(Interventions, LogTreatments) {
+  const auto path = std::string(testing::TempDir()) + "treated.plasx";
+  pfg::Parameters params;
+  params.mu_d = 1.0 / 2.0_yrs;
+  auto population = mixed_population(5000);
+  const auto start = population.current_;
+  pfg::Schedule schedule(6);
+  schedule.add(5.0_days, pfg::MassDrugAdministration{0.8});
+  RandomStreams streams(6);
+  {
+    pfg::EventLog log(path);
+    plasx::simulation(0.0, 10.0_days, 1.0_days,
+                      pfg::Scheduled(pfg::one_step, schedule), population,
+                      params, 0.1, streams, log);
+  }
+  const auto table = pfg::read_event_log(path);
+  std::remove(path.c_str());
+
+  // Replaying the log from the start gives everyone's compartment now.
+  auto current = start;
+  std::size_t treated = 0;
+  for (std::size_t k = 0; k < table.time.size(); ++k) {
+    current[table.individual[k]] = table.to[k];
+    treated += table.time[k] == 5.0_days &&
+               table.event[k] == pfg::Event::transition &&
+               table.to[k] == pfg::Status::T;
+  }
+  EXPECT_EQ(current, population.current_);
+  EXPECT_GT(treated, population.size() / 2);
+}
+
+TEST(Interventions, RebuildTheBitingTable) {
+  pfg::Parameters params;
+  auto population = mixed_population(5000);
+  pfg::Schedule schedule(7);
+  schedule.add(5.0_days, pfg::BednetCampaign{0.6, 0.5, 10.0_days});
+  RandomStreams streams(7);
+  pfg::BitingTable table;
+  const pfg::Scheduled step(pfg::one_step, schedule);
+  auto zeta = [&] {
+    return std::accumulate(population.zeta_.begin(), population.zeta_.end(),
+                           0.0);
+  };
+
+  const auto before = zeta();
+  auto t = plasx::simulation(0.0, 6.0_days, 1.0_days, step, population,
+                             params, 0.1, streams, table);
+  EXPECT_LT(zeta(), 0.8 * before);
+  EXPECT_NEAR(table.total(), zeta(), 1e-6 * before);
+  plasx::simulation(t, 20.0_days, 1.0_days, step, population, params, 0.1,
+                    streams, table);
+  EXPECT_NEAR(table.total(), before, 1e-6 * before);
+}
+
+TEST(Interventions, OnlyChangesWhatIsScheduled) {
+  pfg::Parameters params;
+  params.mu_d = 1.0 / 2.0_yrs;
+  auto scheduled = mixed_population(5000);
+  auto expected = scheduled;
+  pfg::Schedule schedule;
+  RandomStreams scheduled_streams(4), streams(4);
+  plasx::simulation(0.0, 20.0_days, 1.0_days,
+                    pfg::Scheduled(pfg::one_step, schedule), scheduled, params,
+                    0.2, scheduled_streams);
+  plasx::simulation(0.0, 20.0_days, 1.0_days, pfg::one_step, expected, params,
+                    0.2, streams);
+  EXPECT_EQ(scheduled.current_, expected.current_);
+  EXPECT_EQ(scheduled.I_B_, expected.I_B_);
+
+  EXPECT_EQ(&schedule.parameters(params), &params);
+  schedule.add(25.0_days, pfg::CaseManagement{0.9});
+  plasx::simulation(20.0_days, 30.0_days, 1.0_days,
+                    pfg::Scheduled(pfg::one_step, schedule), scheduled, params,
+                    0.2, scheduled_streams);
+  EXPECT_EQ(schedule.parameters(params).f_T, 0.9);
+
+  EXPECT_THROW(schedule.add(0.0, pfg::CaseManagement{1.5}),
+               std::invalid_argument);
+  EXPECT_THROW(schedule.add(0.0, pfg::BednetCampaign{0.5, 1.0, 1.0}),
+               std::invalid_argument);
+  EXPECT_THROW(schedule.add(0.0, pfg::MassDrugAdministration{0.5, 2.0, 1.0}),
+               std::invalid_argument);
+}
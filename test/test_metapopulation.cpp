@@ -0,0 +1,100 @@
+#include <cmath>
+#include <utility>
+#include <vector>
+
+#include "PlasX/Falciparum/Griffin/metapopulation.hpp"
+#include "PlasX/Falciparum/Griffin/mosquito.hpp"
+#include "PlasX/Falciparum/Griffin/population.hpp"
+#include "PlasX/Falciparum/griffin.hpp"
+#include "PlasX/random.hpp"
+#include "PlasX/simulation.hpp"
+#include "PlasX/thread_pool.hpp"
+#include "PlasX/udl.hpp"
+#include "gtest/gtest.h"
+
+using namespace plasx;
+namespace pfg = falciparum::griffin;
+
+static pfg::Patch patch(const std::size_t n, const double eir) {
+  pfg::Patch patch;
+  for (std::size_t i = 0; i < n; ++i) {
+    patch.population.emplace_back((i % 50) * 1.0_yrs, pfg::Status::S, 0.0,
+                                  0.0, 0.0);
+  }
+  patch.eir = eir;
+  return patch;
+}
+
+// Three patches of different sizes, one with mosquitoes, and migration both
+// ways between neighbours.
+static pfg::Metapopulation districts() {
+  std::vector<pfg::Patch> patches;
+  patches.push_back(patch(3000, 0.05));
+  patches.push_back(patch(12000, 0.0));
+  patches.back().mosquitoes.emplace(pfg::MosquitoParameters(), 5.0, 0.02);
+  patches.push_back(patch(500, 0.2));
+  std::vector<double> migration = {0.0,  0.01, 0.0,   //
+                                   0.002, 0.0, 0.002,  //
+                                   0.0,  0.05, 0.0};
+  return pfg::Metapopulation(std::move(patches), std::move(migration), 99);
+}
+
+TEST(Metapopulation, AppendCopiesPendingInfections) {
+  pfg::Population from, to;
+  from.emplace_back(10.0, pfg::Status::S, 1.0, 2.0, 3.0);
+  for (auto t : {4.0, 1.0, 3.0, 2.0}) {
+    from[0].scheduleInfection(t);
+  }
+  to.append(from, 0);
+  from.truncate(0);
+  ASSERT_EQ(to.size(), 1u);
+  EXPECT_EQ(to.I_CM_[0], 2.0);
+  for (auto t : {1.0, 2.0, 3.0, 4.0}) {
+    EXPECT_FALSE(to[0].updateInfection(t - 0.5));
+    EXPECT_TRUE(to[0].updateInfection(t));
+  }
+  EXPECT_EQ(to.pool().size(), 0u);
+}
+
+TEST(Metapopulation, IndependentOfThreadCount) {
+  pfg::Parameters params;
+  params.mu_d = 1.0 / 10.0_yrs;
+  auto serial = districts(), threaded = districts();
+  ThreadPool one(1), three(3);
+  plasx::simulation(0.0_days, 40.0_days, 1.0_days, pfg::one_step, serial,
+                    params, one);
+  plasx::simulation(0.0_days, 40.0_days, 1.0_days, pfg::one_step, threaded,
+                    params, three);
+
+  EXPECT_EQ(serial.size(), 15500u);
+  EXPECT_EQ(threaded.size(), 15500u);
+  EXPECT_GT(serial.migrants(), 0u);
+  EXPECT_EQ(serial.migrants(), threaded.migrants());
+  for (std::size_t p = 0; p < 3; ++p) {
+    const auto& a = serial.patches()[p].population;
+    const auto& b = threaded.patches()[p].population;
+    EXPECT_EQ(a.current_, b.current_);
+    EXPECT_EQ(a.age_, b.age_);
+    EXPECT_EQ(a.I_B_, b.I_B_);
+  }
+  EXPECT_EQ(serial.patches()[1].mosquitoes->I(),
+            threaded.patches()[1].mosquitoes->I());
+}
+
+TEST(Metapopulation, MigrationRate) {
+  pfg::Parameters params;
+  std::vector<pfg::Patch> patches;
+  patches.push_back(patch(20000, 0.0));
+  patches.push_back(patch(0, 0.0));
+  pfg::Metapopulation metapopulation(std::move(patches), {0.0, 0.01, 0.0, 0.0},
+                                     5);
+  ThreadPool pool(2);
+  plasx::simulation(0.0_days, 30.0_days, 1.0_days, pfg::one_step,
+                    metapopulation, params, pool);
+
+  // Each person has left with probability 1 - exp(-0.3), about 5184 in all.
+  const auto moved = metapopulation.patches()[1].population.size();
+  EXPECT_EQ(moved, metapopulation.migrants());
+  EXPECT_EQ(metapopulation.size(), 20000u);
+  EXPECT_NEAR(moved, 20000 * (1.0 - std::exp(-0.3)), 250.0);
+}
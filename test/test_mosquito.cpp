@@ -0,0 +1,101 @@
+#include <cmath>
+#include <type_traits>
+
+#include "PlasX/Falciparum/Griffin/immunity_functions.hpp"
+#include "PlasX/Falciparum/Griffin/mosquito.hpp"
+#include "PlasX/Falciparum/Griffin/population.hpp"
+#include "PlasX/Falciparum/griffin.hpp"
+#include "PlasX/random.hpp"
+#include "PlasX/simulation.hpp"
+#include "PlasX/thread_pool.hpp"
+#include "PlasX/types.hpp"
+#include "PlasX/udl.hpp"
+#include "gtest/gtest.h"
+
+#include "populations.hpp"
+
+using namespace plasx;
+namespace pfg = falciparum::griffin;
+using test::mixed_population;
+
+// Humans with infectiousness kappa, everyone infectious being in D.
+static pfg::Infectiousness humans(const pfg::MosquitoParameters& params,
+                                  const double kappa) {
+  pfg::Infectiousness humans;
+  humans.add(kappa / params.c_D, pfg::Status::D);
+  humans.add(1.0 - kappa / params.c_D, pfg::Status::S);
+  return humans;
+}
+
+TEST(Mosquitoes, EquilibriumIsSteady) {
+  pfg::MosquitoParameters params;
+  pfg::Mosquitoes mosquitoes(params, 2.0, 0.05);
+  const auto I = mosquitoes.I();
+  EXPECT_NEAR(mosquitoes.S() + mosquitoes.E() + mosquitoes.I(), 2.0, 1e-12);
+  for (auto day = 0; day < 100; ++day) {
+    mosquitoes.step(1.0_days, humans(params, 0.05));
+    EXPECT_NEAR(mosquitoes.S() + mosquitoes.E() + mosquitoes.I(), 2.0, 1e-12);
+  }
+  EXPECT_NEAR(mosquitoes.I(), I, 0.01 * I);
+  EXPECT_DOUBLE_EQ(mosquitoes.eir(), params.a * mosquitoes.I());
+}
+
+TEST(Mosquitoes, InfectionDiesOutWithoutInfectiousHumans) {
+  pfg::MosquitoParameters params;
+  pfg::Mosquitoes mosquitoes(params, 1.0, 0.1);
+  // Everything incubating has become infectious (or died) by tau_m.
+  for (auto day = 0; day < 11; ++day) {
+    mosquitoes.step(1.0_days, pfg::Infectiousness());
+  }
+  EXPECT_EQ(mosquitoes.E(), 0.0);
+  EXPECT_EQ(mosquitoes.foi(), 0.0);
+  const auto I = mosquitoes.I();
+  mosquitoes.step(5.0_days, pfg::Infectiousness());
+  EXPECT_NEAR(mosquitoes.I(), I * std::exp(-params.mu_m * 5.0), 1e-15);
+  EXPECT_NEAR(mosquitoes.S() + mosquitoes.I(), 1.0, 1e-12);
+}
+
+TEST(Mosquitoes, FusedReductionMatchesSweep) {
+  pfg::Parameters params;
+  pfg::MosquitoParameters mosquito_params;
+  auto population = mixed_population(10000, 1.0, 0.0, 1.0);
+  pfg::Mosquitoes mosquitoes(mosquito_params, 1.0, 0.02);
+  RandomStreams streams(7);
+  pfg::one_step(0.0, 1.0_days, population, params, mosquitoes, streams);
+
+  // Nobody dies (mu_d = 0), so each individual's weight is taken at the age
+  // they had at the start of the step.
+  pfg::ImmunityFunctions functions(params);
+  pfg::Infectiousness swept;
+  for (std::size_t i = 0; i < population.size(); ++i) {
+    swept.add(functions.psi(population.age_[i] - 1.0_days) *
+                  population.zeta_[i],
+              population.current_[i]);
+  }
+  const auto kappa = swept.kappa(mosquito_params);
+  EXPECT_GT(kappa, 0.0);
+  // The step computes psi in StateType, which is float in a single precision
+  // build.
+  const auto tolerance = std::is_same_v<StateType, double> ? 1e-12 : 1e-8;
+  EXPECT_NEAR(mosquitoes.foi(), mosquito_params.a * kappa, tolerance);
+}
+
+TEST(Mosquitoes, CoupledStepIndependentOfThreads) {
+  pfg::Parameters params;
+  params.mu_d = 1.0 / 1.0_yrs;
+  pfg::MosquitoParameters mosquito_params;
+  auto serial = mixed_population(20000, 1.0, 0.0, 1.0);
+  auto threaded = serial;
+  pfg::Mosquitoes serial_mosquitoes(mosquito_params, 2.0, 0.02);
+  auto threaded_mosquitoes = serial_mosquitoes;
+  RandomStreams serial_streams(11), threaded_streams(11);
+  ThreadPool pool(3);
+  plasx::simulation(0.0_days, 30.0_days, 1.0_days, pfg::one_step, serial,
+                    params, serial_mosquitoes, serial_streams);
+  plasx::simulation(0.0_days, 30.0_days, 1.0_days, pfg::one_step, threaded,
+                    params, threaded_mosquitoes, pool, threaded_streams);
+  EXPECT_EQ(serial.current_, threaded.current_);
+  EXPECT_EQ(serial_mosquitoes.I(), threaded_mosquitoes.I());
+  EXPECT_EQ(serial_mosquitoes.foi(), threaded_mosquitoes.foi());
+  EXPECT_GT(serial_mosquitoes.eir(), 0.0);
+}
@@ -0,0 +1,62 @@
+#include <vector>
+
+#include "PlasX/Falciparum/Griffin/population.hpp"
+#include "PlasX/Falciparum/griffin.hpp"
+#include "PlasX/random.hpp"
+#include "PlasX/simulation.hpp"
+#include "PlasX/thread_pool.hpp"
+#include "PlasX/udl.hpp"
+#include "gtest/gtest.h"
+
+using namespace plasx;
+namespace pfg = falciparum::griffin;
+
+static pfg::Population run(std::size_t n_threads) {
+  pfg::Parameters params;
+  params.mu_d = 1.0 / 1.0_yrs;
+  pfg::Population population;
+  for (auto i = 0; i < 10000; ++i) {
+    population.emplace_back(10.0, pfg::Status::S, 0.0, 0.0, 0.0);
+  }
+  ThreadPool pool(n_threads);
+  RandomStreams streams(2023);
+  plasx::simulation(0.0_days, 50.0_days, 1.0_days, pfg::one_step, population,
+                    params, 0.05, pool, streams);
+  return population;
+}
+
+TEST(ThreadPool, RunsEveryTask) {
+  ThreadPool pool(4);
+  std::vector<int> hits(1000, 0);
+  pool.parallel_for(hits.size(), [&](std::size_t i) { hits[i] += 1; });
+  pool.parallel_for(hits.size(), [&](std::size_t i) { hits[i] += 1; });
+  for (auto h : hits) {
+    EXPECT_EQ(h, 2);
+  }
+}
+
+TEST(ParallelStep, IndependentOfThreadCount) {
+  const auto serial = run(1);
+  for (std::size_t n_threads : {2, 3, 8}) {
+    const auto parallel = run(n_threads);
+    ASSERT_EQ(serial.size(), parallel.size());
+    EXPECT_EQ(serial.current_, parallel.current_);
+    EXPECT_EQ(serial.age_, parallel.age_);
+  }
+}
+
+TEST(ParallelStep, InOrderMatchesThreaded) {
+  pfg::Parameters params;
+  params.mu_d = 1.0 / 1.0_yrs;
+  pfg::Population population;
+  for (auto i = 0; i < 10000; ++i) {
+    population.emplace_back(10.0, pfg::Status::S, 0.0, 0.0, 0.0);
+  }
+  RandomStreams streams(2023);
+  plasx::simulation(0.0_days, 50.0_days, 1.0_days, pfg::one_step, population,
+                    params, 0.05, streams);
+
+  const auto threaded = run(2);
+  EXPECT_EQ(population.current_, threaded.current_);
+  EXPECT_EQ(population.age_, threaded.age_);
+}
@@ -0,0 +1,75 @@
+#include <sstream>
+#include <stdexcept>
+
+#include "PlasX/Falciparum/Griffin/parameter_file.hpp"
+#include "PlasX/udl.hpp"
+#include "gtest/gtest.h"
+
+using namespace plasx;
+namespace pfg = falciparum::griffin;
+
+static pfg::ParameterSet read(const std::string& text) {
+  std::istringstream in(text);
+  return pfg::read_parameters(in);
+}
+
+TEST(ParameterFile, ReadsUnits) {
+  const auto parameters = read(
+      "# Shorter lived humans.\n"
+      "mu_d = 0.05 /yrs\n"
+      "age_0 = 8 yrs   # psi\n"
+      "r_T = 0.25 /days\n"
+      "f_T = 0.4\n"
+      "exact_functions = true\n"
+      "\n"
+      "[mosquito]\n"
+      "tau_m = 12 days\n");
+  const pfg::ParameterSet defaults;
+  EXPECT_DOUBLE_EQ(parameters.human.mu_d, 0.05 / 1.0_yrs);
+  EXPECT_DOUBLE_EQ(parameters.human.age_0, 8.0_yrs);
+  EXPECT_EQ(parameters.human.r_T, 0.25);
+  EXPECT_EQ(parameters.human.f_T, 0.4);
+  EXPECT_TRUE(parameters.human.exact_functions);
+  EXPECT_EQ(parameters.human.d_C, defaults.human.d_C);
+  EXPECT_EQ(parameters.mosquito.tau_m, 12.0);
+  EXPECT_EQ(parameters.mosquito.a, defaults.mosquito.a);
+}
+
+TEST(ParameterFile, RoundTrips) {
+  pfg::ParameterSet parameters;
+  parameters.human.mu_d = 1.0 / 21.0_yrs;
+  parameters.human.P_M = 0.3;
+  parameters.mosquito.c_A = 0.1 / 3.0;
+  std::stringstream file;
+  pfg::write_parameters(file, parameters);
+  EXPECT_EQ(pfg::read_parameters(file), parameters);
+}
+
+TEST(ParameterFile, RejectsInvalidFiles) {
+  // Unknown names and sections.
+  EXPECT_THROW(read("mu = 0.1 /days\n"), std::invalid_argument);
+  EXPECT_THROW(read("[vector]\n"), std::invalid_argument);
+  EXPECT_THROW(read("tau_m = 10 days\n"), std::invalid_argument);
+  // Missing, wrong or unexpected units.
+  EXPECT_THROW(read("age_0 = 2920\n"), std::invalid_argument);
+  EXPECT_THROW(read("age_0 = 8 /yrs\n"), std::invalid_argument);
+  EXPECT_THROW(read("r_T = 5 days\n"), std::invalid_argument);
+  EXPECT_THROW(read("rho = 0.8 days\n"), std::invalid_argument);
+  // Out of range.
+  EXPECT_THROW(read("f_T = 1.2\n"), std::invalid_argument);
+  EXPECT_THROW(read("d_A = 0 days\n"), std::invalid_argument);
+  EXPECT_THROW(read("b_min = 0.9\nb_max = 0.5\n"), std::invalid_argument);
+  // Malformed.
+  EXPECT_THROW(read("rho 0.8\n"), std::invalid_argument);
+  EXPECT_THROW(read("rho = high\n"), std::invalid_argument);
+  EXPECT_THROW(read("rho = 0.8\nrho = 0.7\n"), std::invalid_argument);
+  EXPECT_THROW(pfg::load_parameters("/nonexistent/parameters.ini"),
+               std::runtime_error);
+
+  try {
+    read("rho = 0.8\n\nf_T = 2\n");
+    FAIL();
+  } catch (const std::invalid_argument& error) {
+    EXPECT_EQ(std::string(error.what()).rfind("<input>:3:", 0), 0u);
+  }
+}
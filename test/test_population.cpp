@@ -0,0 +1,56 @@
+#include <vector>
+
+#include "PlasX/Falciparum/Griffin/population.hpp"
+#include "PlasX/Falciparum/griffin.hpp"
+#include "PlasX/random.hpp"
+#include "PlasX/simulation.hpp"
+#include "PlasX/udl.hpp"
+#include "gtest/gtest.h"
+
+using namespace plasx;
+namespace pfg = falciparum::griffin;
+
+TEST(Population, MatchesArrayOfStructs) {
+  pfg::Parameters params;
+  params.mu_d = 1.0 / 1.0_yrs;
+  const auto N = 2000;
+
+  std::vector<Individual<pfg::PFalc>> aos;
+  pfg::Population soa;
+  soa.reserve(N);
+  for (auto i = 0; i < N; ++i) {
+    aos.emplace_back(10.0, pfg::Status::S, 0.0, 0.0, 0.0);
+    soa.emplace_back(10.0, pfg::Status::S, 0.0, 0.0, 0.0);
+  }
+
+  generator.seed(42);
+  plasx::simulation(0.0_days, 100.0_days, 1.0_days, pfg::one_step, aos, params,
+                    0.05);
+  generator.seed(42);
+  plasx::simulation(0.0_days, 100.0_days, 1.0_days, pfg::one_step, soa, params,
+                    0.05);
+
+  ASSERT_EQ(aos.size(), soa.size());
+  for (std::size_t i = 0; i < aos.size(); ++i) {
+    EXPECT_EQ(aos[i].status_.current_, soa.current_[i]);
+  }
+}
+
+TEST(Population, InfectionQueueOrdering) {
+  pfg::Population population;
+  population.emplace_back(10.0, pfg::Status::S, 0.0, 0.0, 0.0);
+  auto agent = population[0];
+  agent.scheduleInfection(5.0);
+  agent.scheduleInfection(2.0);
+  agent.scheduleInfection(8.0);
+
+  EXPECT_FALSE(agent.updateInfection(1.0));
+  EXPECT_TRUE(agent.updateInfection(2.0));
+  EXPECT_EQ(population.next_infection_[0], 5.0);
+  EXPECT_TRUE(agent.updateInfection(9.0));
+  EXPECT_FALSE(agent.updateInfection(100.0));
+
+  agent.scheduleInfection(3.0);
+  agent.clearInfectionQueue();
+  EXPECT_FALSE(agent.updateInfection(100.0));
+}
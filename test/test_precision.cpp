@@ -0,0 +1,90 @@
+#include <cmath>
+#include <type_traits>
+#include <vector>
+
+#include "PlasX/Falciparum/Griffin/population.hpp"
+#include "PlasX/Falciparum/Griffin/recorder.hpp"
+#include "PlasX/Falciparum/griffin.hpp"
+#include "PlasX/random.hpp"
+#include "PlasX/simulation.hpp"
+#include "PlasX/types.hpp"
+#include "PlasX/udl.hpp"
+#include "gtest/gtest.h"
+
+using namespace plasx;
+namespace pfg = falciparum::griffin;
+
+// Prevalence (A, U, D and T) averaged over the steps, and infections per
+// person per step.
+struct Outputs {
+  double prevalence = 0.0;
+  double incidence = 0.0;
+};
+
+template <class Population, class... Args>
+static Outputs run(Population& population, const pfg::Parameters& params,
+                   const double eir, Args&... args) {
+  pfg::Recorder recorder;
+  const auto steps = 200;
+  const auto n = static_cast<double>(population.size());
+  Outputs outputs;
+  plasx::observed_simulation(
+      0.0, steps * 1.0_days, 1.0_days, pfg::one_step,
+      [&](double) {
+        const auto infected = n - recorder.total(pfg::Status::S) -
+                              recorder.total(pfg::Status::P);
+        outputs.prevalence += infected / n / steps;
+        outputs.incidence += recorder.last_step().infections_[0] / n / steps;
+      },
+      population, params, eir, args..., recorder);
+  return outputs;
+}
+
+TEST(Precision, ColumnsHoldStateType) {
+  static_assert(std::is_same_v<decltype(pfg::Population::I_CA_)::value_type,
+                               StateType>);
+#ifdef PLASX_SINGLE_PRECISION
+  static_assert(std::is_same_v<StateType, float>);
+#else
+  static_assert(std::is_same_v<StateType, double>);
+#endif
+  pfg::Population population;
+  population.emplace_back(1.0 / 3.0, pfg::Status::S, 0.1, 0.2, 0.3);
+  EXPECT_EQ(population.age_[0], static_cast<StateType>(1.0 / 3.0));
+  EXPECT_EQ(population[0].getIC(),
+            static_cast<StateType>(0.1) + static_cast<StateType>(0.2));
+  // Times are never rounded.
+  population[0].scheduleInfection(1.0 / 3.0);
+  EXPECT_EQ(population.next_infection_[0], 1.0 / 3.0);
+}
+
+// The structure of arrays step, in whatever precision this was built with,
+// against the array of structures step, which is always in double. In a
+// single precision build this is the check that rounding the state to float
+// does not move the outputs by more than the stochastic noise.
+TEST(Precision, OutputsAgreeWithDoubleWithinNoise) {
+  pfg::Parameters params;
+  params.mu_d = 1.0 / 20.0_yrs;
+  const auto n = 40000;
+  const auto eir = 0.05;
+  pfg::Population soa;
+  std::vector<Individual<pfg::PFalc>> aos;
+  soa.reserve(n);
+  aos.reserve(n);
+  for (auto i = 0; i < n; ++i) {
+    const auto age = (i % 60) * 1.0_yrs + (i % 365) * 1.0_days;
+    const auto status = static_cast<pfg::Status>(i % 4);
+    soa.emplace_back(age, status, 2.0, 0.5, 3.0);
+    aos.emplace_back(age, status, 2.0, 0.5, 3.0);
+  }
+
+  RandomStreams streams(17);
+  generator.seed(17);
+  const auto state = run(soa, params, eir, streams);
+  const auto reference = run(aos, params, eir);
+  EXPECT_GT(reference.prevalence, 0.1);
+  EXPECT_GT(reference.incidence, 1e-4);
+  // A few standard errors, allowing for the correlation between steps.
+  EXPECT_NEAR(state.prevalence, reference.prevalence, 0.01);
+  EXPECT_NEAR(state.incidence / reference.incidence, 1.0, 0.03);
+}
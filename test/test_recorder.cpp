@@ -0,0 +1,186 @@
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "PlasX/Falciparum/Griffin/biting.hpp"
+#include "PlasX/Falciparum/Griffin/cohorts.hpp"
+#include "PlasX/Falciparum/Griffin/population.hpp"
+#include "PlasX/Falciparum/Griffin/recorder.hpp"
+#include "PlasX/Falciparum/griffin.hpp"
+#include "PlasX/column_writer.hpp"
+#include "PlasX/random.hpp"
+#include "PlasX/simulation.hpp"
+#include "PlasX/thread_pool.hpp"
+#include "PlasX/udl.hpp"
+#include "gtest/gtest.h"
+
+#include "populations.hpp"
+
+using namespace plasx;
+namespace pfg = falciparum::griffin;
+using test::susceptible_population;
+
+static const std::vector<pfg::Status> statuses = {
+    pfg::Status::S, pfg::Status::A, pfg::Status::U,
+    pfg::Status::D, pfg::Status::T, pfg::Status::P};
+
+// Ages 0 to 39 years in turn.
+static double age(const std::size_t i) { return (i % 40) * 1.0_yrs; }
+
+// The counts kept during the steps must agree with counting from scratch.
+static void expect_matches_rescan(const pfg::Recorder& recorder,
+                                  const pfg::Population& population) {
+  pfg::Recorder rescan({0.0, 5.0_yrs, 15.0_yrs});
+  rescan.count(population);
+  for (std::size_t b = 0; b < recorder.bands(); ++b) {
+    for (auto status : statuses) {
+      EXPECT_EQ(recorder.count(b, status), rescan.count(b, status));
+    }
+  }
+}
+
+TEST(Recorder, CountsMatchRescan) {
+  pfg::Parameters params;
+  params.mu_d = 1.0 / 1.0_yrs;
+  auto population = susceptible_population(5000, age);
+
+  pfg::Recorder recorder({0.0, 5.0_yrs, 15.0_yrs});
+  generator.seed(7);
+  plasx::simulation(0.0_days, 100.0_days, 1.0_days, pfg::one_step, population,
+                    params, 0.05, recorder);
+  expect_matches_rescan(recorder, population);
+  EXPECT_GT(recorder.total(pfg::Status::A), 0u);
+
+  std::uint64_t total = 0;
+  for (auto status : statuses) {
+    total += recorder.total(status);
+  }
+  EXPECT_EQ(total, population.size());
+}
+
+TEST(Recorder, ThreadedCountsMatchRescan) {
+  pfg::Parameters params;
+  params.mu_d = 1.0 / 1.0_yrs;
+  auto population =
+      susceptible_population(3 * pfg::OneStep::block_size + 17, age);
+
+  ThreadPool pool(2);
+  RandomStreams streams(11);
+  pfg::Recorder recorder({0.0, 5.0_yrs, 15.0_yrs});
+  plasx::simulation(0.0_days, 50.0_days, 1.0_days, pfg::one_step, population,
+                    params, 0.05, pool, streams, recorder);
+  expect_matches_rescan(recorder, population);
+}
+
+TEST(Recorder, CountsMatchWithABitingTable) {
+  pfg::Parameters params;
+  params.mu_d = 1.0 / 1.0_yrs;
+  auto population =
+      susceptible_population(2 * pfg::OneStep::block_size + 17, age);
+  auto expected = population;
+  RandomStreams streams(12), expected_streams(12);
+  pfg::BitingTable table, expected_table;
+  pfg::Recorder recorder({0.0, 5.0_yrs, 15.0_yrs});
+  plasx::simulation(0.0_days, 50.0_days, 1.0_days, pfg::one_step, population,
+                    params, 0.05, streams, table, recorder);
+  plasx::simulation(0.0_days, 50.0_days, 1.0_days, pfg::one_step, expected,
+                    params, 0.05, expected_streams, expected_table);
+  EXPECT_EQ(population.current_, expected.current_);
+  expect_matches_rescan(recorder, population);
+  EXPECT_GT(recorder.total(pfg::Status::A), 0u);
+}
+
+TEST(Recorder, CountsTheBinned) {
+  pfg::Parameters params;
+  params.mu_d = 1.0 / 1.0_yrs;
+  pfg::HybridPopulation population;
+  population.agents = susceptible_population(5000, age);
+  population.cohorts.absorb(population.agents);
+  ThreadPool pool(2);
+  RandomStreams streams(13);
+  pfg::Recorder recorder({0.0, 5.0_yrs, 15.0_yrs});
+  std::uint64_t deaths = 0;
+  plasx::observed_simulation(
+      0.0_days, 50.0_days, 1.0_days, pfg::one_step,
+      [&](double) {
+        for (const auto died : recorder.last_step().deaths_) {
+          deaths += died;
+        }
+      },
+      population, params, 0.05, pool, streams, recorder);
+
+  // The agents as they are, and everyone binned in S.
+  pfg::Recorder agents({0.0, 5.0_yrs, 15.0_yrs});
+  agents.count(population.agents);
+  EXPECT_EQ(recorder.total(pfg::Status::S),
+            agents.total(pfg::Status::S) + population.cohorts.count());
+  std::uint64_t total = 0;
+  for (auto status : statuses) {
+    total += recorder.total(status);
+    if (status != pfg::Status::S) {
+      EXPECT_EQ(recorder.total(status), agents.total(status));
+    }
+  }
+  EXPECT_EQ(total, population.size());
+  EXPECT_GT(recorder.total(pfg::Status::A), 0u);
+  // About 5000 * 50 / 365 die.
+  EXPECT_GT(deaths, 400u);
+}
+
+TEST(Recorder, DoesNotChangeTheResult) {
+  pfg::Parameters params;
+  params.mu_d = 1.0 / 1.0_yrs;
+  const auto N = 2000;
+  std::vector<Individual<pfg::PFalc>> plain, recorded;
+  for (auto i = 0; i < N; ++i) {
+    plain.emplace_back(10.0, pfg::Status::S, 0.0, 0.0, 0.0);
+    recorded.emplace_back(10.0, pfg::Status::S, 0.0, 0.0, 0.0);
+  }
+
+  pfg::Recorder recorder;
+  generator.seed(3);
+  plasx::simulation(0.0_days, 60.0_days, 1.0_days, pfg::one_step, plain,
+                    params, 0.05);
+  generator.seed(3);
+  plasx::simulation(0.0_days, 60.0_days, 1.0_days, pfg::one_step, recorded,
+                    params, 0.05, recorder);
+
+  ASSERT_EQ(plain.size(), recorded.size());
+  for (std::size_t i = 0; i < plain.size(); ++i) {
+    EXPECT_EQ(plain[i].status_.current_, recorded[i].status_.current_);
+  }
+  std::uint64_t total = 0;
+  for (auto status : statuses) {
+    total += recorder.total(status);
+  }
+  EXPECT_EQ(total, plain.size());
+}
+
+TEST(Recorder, WritesColumns) {
+  pfg::Parameters params;
+  auto population = susceptible_population(1000, age);
+  const std::string path = "recorder_test.plasx";
+  std::uint64_t infections = 0;
+  {
+    pfg::Recorder recorder({0.0, 5.0_yrs}, path, 4);
+    auto t = 0.0;
+    for (auto step = 0; step < 10; ++step) {
+      t = pfg::one_step(t, 1.0_days, population, params, 0.1, recorder);
+      infections += recorder.last_step().infections_[0] +
+                    recorder.last_step().infections_[1];
+    }
+  }
+
+  const auto table = read_columns(path);
+  std::remove(path.c_str());
+  ASSERT_EQ(table["t"].size(), 10u);
+  EXPECT_EQ(table["t"].back(), 10.0_days);
+  EXPECT_EQ(table.names.size(), 1u + 2u * 9u);
+
+  double written = 0.0;
+  for (std::size_t row = 0; row < 10; ++row) {
+    written += table["infections[0]"][row] + table["infections[1]"][row];
+  }
+  EXPECT_EQ(written, infections);
+  EXPECT_GT(infections, 0u);
+}
@@ -0,0 +1,240 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "PlasX/Falciparum/Griffin/mosquito.hpp"
+#include "PlasX/Falciparum/Griffin/population.hpp"
+#include "PlasX/Falciparum/Griffin/snapshot.hpp"
+#include "PlasX/Falciparum/griffin.hpp"
+#include "PlasX/random.hpp"
+#include "PlasX/simulation.hpp"
+#include "PlasX/thread_pool.hpp"
+#include "PlasX/udl.hpp"
+#include "gtest/gtest.h"
+
+#include "populations.hpp"
+
+using namespace plasx;
+namespace pfg = falciparum::griffin;
+using test::mixed_population;
+
+static void expect_same(const pfg::Population& a, const pfg::Population& b) {
+  ASSERT_EQ(a.size(), b.size());
+  for (std::size_t i = 0; i < a.size(); ++i) {
+    EXPECT_EQ(a.current_[i], b.current_[i]);
+    EXPECT_EQ(a.age_[i], b.age_[i]);
+    EXPECT_EQ(a.next_infection_[i], b.next_infection_[i]);
+  }
+  EXPECT_EQ(a.pool().size(), b.pool().size());
+}
+
+TEST(Snapshot, PopulationRestartsExactly) {
+  pfg::Parameters params;
+  params.mu_d = 1.0 / 1.0_yrs;
+  const std::string path = "snapshot_test.plasx";
+  pfg::Population population;
+  for (auto i = 0; i < 2000; ++i) {
+    population.emplace_back(i * 1.0_days, pfg::Status::S, 0.1, 0.2, 0.3);
+  }
+
+  generator.seed(5);
+  auto t = plasx::simulation(0.0_days, 30.0_days, 1.0_days, pfg::one_step,
+                             population, params, 0.05);
+  // Leave some infections pending beyond the next one.
+  for (std::size_t i = 0; i < population.size(); i += 7) {
+    population[i].scheduleInfection(t + 3.0_days);
+    population[i].scheduleInfection(t + 9.0_days);
+  }
+  pfg::save_snapshot(path, t, population, params);
+  plasx::simulation(t, t + 30.0_days, 1.0_days, pfg::one_step, population,
+                    params, 0.05);
+
+  generator.seed(1234);
+  pfg::Snapshot snapshot(path);
+  std::remove(path.c_str());
+  pfg::Population restored;
+  snapshot.restore(restored);
+  snapshot.restore_generator();
+  EXPECT_EQ(snapshot.time(), t);
+  EXPECT_TRUE(snapshot.parameters() == params);
+  EXPECT_FALSE(snapshot.streams().has_value());
+  EXPECT_FALSE(snapshot.mosquitoes().has_value());
+  plasx::simulation(snapshot.time(), t + 30.0_days, 1.0_days, pfg::one_step,
+                    restored, snapshot.parameters(), 0.05);
+  expect_same(population, restored);
+}
+
+TEST(Snapshot, ArrayOfStructsRestartsExactly) {
+  pfg::Parameters params;
+  params.mu_d = 1.0 / 1.0_yrs;
+  const std::string path = "snapshot_aos_test.plasx";
+  std::vector<Individual<pfg::PFalc>> population;
+  for (auto i = 0; i < 2000; ++i) {
+    population.emplace_back(10.0, pfg::Status::S, 0.0, 0.0, 0.0);
+  }
+
+  generator.seed(9);
+  auto t = plasx::simulation(0.0_days, 30.0_days, 1.0_days, pfg::one_step,
+                             population, params, 0.05);
+  for (std::size_t i = 0; i < population.size(); i += 5) {
+    population[i].status_.scheduleInfection(t + 2.0_days);
+    population[i].status_.scheduleInfection(t + 4.0_days);
+  }
+  pfg::save_snapshot(path, t, population, params);
+
+  pfg::Snapshot snapshot(path);
+  std::remove(path.c_str());
+  std::vector<Individual<pfg::PFalc>> restored;
+  snapshot.restore(restored);
+  plasx::simulation(t, t + 30.0_days, 1.0_days, pfg::one_step, population,
+                    params, 0.05);
+  snapshot.restore_generator();
+  plasx::simulation(t, t + 30.0_days, 1.0_days, pfg::one_step, restored,
+                    params, 0.05);
+
+  ASSERT_EQ(population.size(), restored.size());
+  for (std::size_t i = 0; i < population.size(); ++i) {
+    EXPECT_EQ(population[i].status_.current_, restored[i].status_.current_);
+  }
+}
+
+TEST(Snapshot, StreamsContinueFromEpoch) {
+  pfg::Parameters params;
+  const std::string path = "snapshot_streams_test.plasx";
+  pfg::Population population;
+  for (std::size_t i = 0; i < pfg::OneStep::block_size + 100; ++i) {
+    population.emplace_back(10.0, pfg::Status::S, 0.0, 0.0, 0.0);
+  }
+  ThreadPool pool(2);
+  RandomStreams streams(17);
+  auto t = plasx::simulation(0.0_days, 10.0_days, 1.0_days, pfg::one_step,
+                             population, params, 0.05, pool, streams);
+  pfg::save_snapshot(path, t, population, params, &streams);
+  plasx::simulation(t, t + 10.0_days, 1.0_days, pfg::one_step, population,
+                    params, 0.05, pool, streams);
+
+  pfg::Snapshot snapshot(path);
+  std::remove(path.c_str());
+  pfg::Population restored;
+  snapshot.restore(restored);
+  auto restored_streams = snapshot.streams();
+  ASSERT_TRUE(restored_streams.has_value());
+  EXPECT_EQ(restored_streams->epoch(), 10u);
+  plasx::simulation(t, t + 10.0_days, 1.0_days, pfg::one_step, restored,
+                    params, 0.05, pool, *restored_streams);
+  expect_same(population, restored);
+}
+
+TEST(Snapshot, MosquitoesRestartExactly) {
+  pfg::Parameters params;
+  params.mu_d = 1.0 / 1.0_yrs;
+  const std::string path = "snapshot_mosquitoes_test.plasx";
+  auto population = mixed_population(5000, 1.0, 0.0, 1.0);
+  pfg::MosquitoParameters mosquito_params;
+  mosquito_params.tau_m = 12.0_days;
+  pfg::Mosquitoes mosquitoes(mosquito_params, 2.0, 0.02);
+  RandomStreams streams(23);
+  auto t = plasx::simulation(0.0_days, 20.0_days, 1.0_days, pfg::one_step,
+                             population, params, mosquitoes, streams);
+  pfg::save_snapshot(path, t, population, params, &streams, &mosquitoes);
+  plasx::simulation(t, t + 20.0_days, 1.0_days, pfg::one_step, population,
+                    params, mosquitoes, streams);
+
+  pfg::Snapshot snapshot(path);
+  std::remove(path.c_str());
+  pfg::Population restored;
+  snapshot.restore(restored);
+  auto restored_streams = snapshot.streams();
+  auto restored_mosquitoes = snapshot.mosquitoes();
+  ASSERT_TRUE(restored_streams.has_value());
+  ASSERT_TRUE(restored_mosquitoes.has_value());
+  EXPECT_TRUE(restored_mosquitoes->parameters() == mosquito_params);
+  plasx::simulation(t, t + 20.0_days, 1.0_days, pfg::one_step, restored,
+                    params, *restored_mosquitoes, *restored_streams);
+  expect_same(population, restored);
+  EXPECT_EQ(restored_mosquitoes->S(), mosquitoes.S());
+  EXPECT_EQ(restored_mosquitoes->I(), mosquitoes.I());
+  EXPECT_EQ(restored_mosquitoes->foi(), mosquitoes.foi());
+  EXPECT_EQ(restored_mosquitoes->m(), mosquitoes.m());
+  EXPECT_TRUE(restored_mosquitoes->cohorts() == mosquitoes.cohorts());
+}
+
+TEST(Snapshot, RejectsOtherFiles) {
+  const std::string path = "snapshot_bad_test.plasx";
+  {
+    std::ofstream file(path, std::ios::binary);
+    file << std::string(4096, 'x');
+  }
+  EXPECT_THROW(pfg::Snapshot snapshot(path), std::runtime_error);
+  std::remove(path.c_str());
+  EXPECT_THROW(pfg::Snapshot snapshot(path), std::runtime_error);
+}
+
+TEST(Snapshot, RejectsCorruptFiles) {
+  pfg::Parameters params;
+  const std::string path = "snapshot_corrupt_test.plasx";
+  pfg::Population population;
+  for (auto i = 0; i < 100; ++i) {
+    population.emplace_back(i * 1.0_days, pfg::Status::S, 0.1, 0.2, 0.3);
+    population[i].scheduleInfection(1.0_days);
+    population[i].scheduleInfection(2.0_days);
+  }
+  pfg::save_snapshot(path, 0.0, population, params);
+  std::string bytes;
+  {
+    std::ifstream file(path, std::ios::binary);
+    bytes.assign(std::istreambuf_iterator<char>(file), {});
+  }
+
+  // Where the header keeps the number of individuals and the offset of each
+  // section (see snapshot.cpp).
+  constexpr std::size_t size_at = 16, offsets_at = 56;
+  auto section = [&bytes](const std::size_t s) {
+    std::uint64_t offset;
+    std::memcpy(&offset, bytes.data() + offsets_at + 8 * s, sizeof(offset));
+    return static_cast<std::size_t>(offset);
+  };
+  auto expect_rejected = [&path](const std::string& corrupt) {
+    {
+      std::ofstream file(path, std::ios::binary);
+      file << corrupt;
+    }
+    EXPECT_THROW(pfg::Snapshot snapshot(path), std::runtime_error);
+  };
+
+  auto corrupt = bytes;
+  const std::uint64_t more = population.size() + 1;
+  std::memcpy(corrupt.data() + size_at, &more, sizeof(more));
+  expect_rejected(corrupt);
+
+  corrupt = bytes;
+  corrupt[section(8) + 10] = 6;  // No such Status.
+  expect_rejected(corrupt);
+
+  corrupt = bytes;
+  const std::uint64_t backwards = 0;
+  std::memcpy(corrupt.data() + section(9) + 8 * 50, &backwards,
+              sizeof(backwards));
+  expect_rejected(corrupt);
+
+  corrupt = bytes;
+  const std::uint64_t beyond = 1000;
+  std::memcpy(corrupt.data() + section(9) + 8 * population.size(), &beyond,
+              sizeof(beyond));
+  expect_rejected(corrupt);
+
+  expect_rejected(bytes.substr(0, bytes.size() / 2));
+
+  // The original is still fine.
+  {
+    std::ofstream file(path, std::ios::binary);
+    file << bytes;
+  }
+  EXPECT_NO_THROW(pfg::Snapshot snapshot(path));
+  std::remove(path.c_str());
+}
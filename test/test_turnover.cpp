@@ -0,0 +1,88 @@
+#include <cmath>
+#include <vector>
+
+#include "PlasX/Falciparum/Griffin/event_driven.hpp"
+#include "PlasX/Falciparum/Griffin/population.hpp"
+#include "PlasX/Falciparum/Griffin/turnover.hpp"
+#include "PlasX/Falciparum/griffin.hpp"
+#include "PlasX/random.hpp"
+#include "PlasX/simulation.hpp"
+#include "PlasX/thread_pool.hpp"
+#include "PlasX/udl.hpp"
+#include "gtest/gtest.h"
+
+using namespace plasx;
+namespace pfg = falciparum::griffin;
+
+TEST(Turnover, SizeIsStableAndEveryoneAges) {
+  pfg::Parameters params;
+  params.mu_d = 1.0 / 2.0_yrs;
+  pfg::Population population;
+  for (auto i = 0; i < 5000; ++i) {
+    population.emplace_back(20.0_yrs, pfg::Status::S, 0.0, 0.0, 0.0);
+  }
+  RandomStreams streams(3);
+  plasx::simulation(0.0_days, 100.0_days, 1.0_days, pfg::one_step, population,
+                    params, 0.01, streams);
+
+  ASSERT_EQ(population.size(), 5000u);
+  std::size_t newborns = 0;
+  for (std::size_t i = 0; i < population.size(); ++i) {
+    if (population.age_[i] < 100.0_days) {
+      ++newborns;
+    } else {
+      EXPECT_DOUBLE_EQ(population.age_[i], 20.0_yrs + 100.0_days);
+    }
+  }
+  // About 5000 * (1 - exp(-100 / 730)) = 640 deaths.
+  EXPECT_GT(newborns, 500u);
+  EXPECT_LT(newborns, 800u);
+}
+
+TEST(Turnover, NewbornsInheritMaternalImmunity) {
+  pfg::Parameters params;
+  params.mu_d = 1.0 / 10.0_days;
+  params.P_M = 0.5;
+  std::vector<Individual<pfg::PFalc>> population;
+  for (auto i = 0; i < 2000; ++i) {
+    population.emplace_back(20.0_yrs, pfg::Status::S, 4.0, 0.0, 0.0);
+  }
+  generator.seed(4);
+  pfg::one_step(0.0, 1.0_days, population, params, 0.0);
+
+  // Without transmission the mothers' immunity only decays.
+  const auto expected = 0.5 * 4.0 * std::exp(-1.0_days / params.d_C);
+  std::size_t newborns = 0;
+  for (auto& person : population) {
+    if (person.age_ == 0.0) {
+      ++newborns;
+      EXPECT_NEAR(person.status_.getIC(), expected, 1e-12);
+      EXPECT_EQ(person.status_.current_, pfg::Status::S);
+    }
+  }
+  EXPECT_GT(newborns, 0u);
+}
+
+TEST(Turnover, EventDrivenReplacesTheDead) {
+  pfg::Parameters params;
+  params.mu_d = 1.0 / 1.0_yrs;
+  pfg::Population population;
+  for (auto i = 0; i < 2000; ++i) {
+    population.emplace_back(10.0_yrs, pfg::Status::S, 0.0, 0.0, 0.0);
+  }
+  pfg::EventDriven engine(2);
+  plasx::simulation(0.0_days, 1.0_yrs, 30.0_days, engine, population, params,
+                    0.001);
+  ASSERT_EQ(population.size(), 2000u);
+
+  pfg::catch_up(population, 0, population.size(), params, 1.0_yrs);
+  std::size_t newborns = 0;
+  for (std::size_t i = 0; i < population.size(); ++i) {
+    newborns += population.age_[i] < 1.0_yrs;
+    // Allowing for ages stored as float in a single precision build.
+    EXPECT_LE(population.age_[i], 11.0_yrs + 1e-3);
+  }
+  // About 2000 * (1 - exp(-1)) = 1264 deaths.
+  EXPECT_GT(newborns, 1100u);
+  EXPECT_LT(newborns, 1400u);
+}
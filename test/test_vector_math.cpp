@@ -0,0 +1,76 @@
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "PlasX/random.hpp"
+#include "PlasX/vector_math.hpp"
+#include "gtest/gtest.h"
+
+using namespace plasx;
+
+TEST(VectorMath, ExpMatchesStd) {
+  Xoshiro256 rng(7);
+  // Odd length so the scalar remainder is used as well.
+  std::vector<double> x(1001), y(1001);
+  for (auto& v : x) {
+    v = -700.0 + 1400.0 * rng.uniform();
+  }
+  batch_exp(x.data(), y.data(), x.size());
+  for (std::size_t i = 0; i < x.size(); ++i) {
+    EXPECT_NEAR(y[i] / std::exp(x[i]), 1.0, 1e-14) << x[i];
+  }
+}
+
+TEST(VectorMath, PowMatchesStd) {
+  Xoshiro256 rng(11);
+  std::vector<double> x(1001), y(1001);
+  for (auto& v : x) {
+    v = 100.0 * rng.uniform();
+  }
+  x[0] = 0.0;
+  for (const auto k : {4.93, -5.0}) {
+    batch_pow(x.data(), k, y.data(), x.size());
+    EXPECT_EQ(y[0], k > 0 ? 0.0 : std::numeric_limits<double>::infinity());
+    for (std::size_t i = 1; i < x.size(); ++i) {
+      EXPECT_NEAR(y[i] / std::pow(x[i], k), 1.0, 1e-13) << x[i];
+    }
+  }
+}
+
+TEST(VectorMath, SinglePrecisionMatchesStd) {
+  Xoshiro256 rng(13);
+  std::vector<float> x(1001), y(1001);
+  for (auto& v : x) {
+    v = static_cast<float>(-80.0 + 160.0 * rng.uniform());
+  }
+  batch_exp(x.data(), y.data(), x.size());
+  for (std::size_t i = 0; i < x.size(); ++i) {
+    EXPECT_NEAR(y[i] / std::exp(double{x[i]}), 1.0, 1e-6) << x[i];
+  }
+
+  for (auto& v : x) {
+    v = static_cast<float>(100.0 * rng.uniform());
+  }
+  x[0] = 0.0f;
+  for (const auto k : {4.93f, -5.0f}) {
+    batch_pow(x.data(), k, y.data(), x.size());
+    EXPECT_EQ(y[0], k > 0 ? 0.0f : std::numeric_limits<float>::infinity());
+    for (std::size_t i = 1; i < x.size(); ++i) {
+      EXPECT_NEAR(y[i] / std::pow(double{x[i]}, double{k}), 1.0, 1e-5)
+          << x[i];
+    }
+  }
+}
+
+TEST(VectorMath, BatchUniformsInRange) {
+  Xoshiro256x4 rng(3);
+  std::vector<double> u(10007);
+  rng.fill_uniform(u.data(), u.size());
+  auto mean = 0.0;
+  for (auto v : u) {
+    EXPECT_GE(v, 0.0);
+    EXPECT_LT(v, 1.0);
+    mean += v / u.size();
+  }
+  EXPECT_NEAR(mean, 0.5, 0.01);
+}